@@ -68,6 +68,139 @@ namespace mars {
     };
     /// \endcond
 
+    // marks the buffer in DataElement::readyIndex that was not read yet
+#define READY_BUFFER_DIRTY 0x4
+
+    /**
+     * Publishes the back buffer of the element and takes the former
+     * ready buffer as new back buffer. The producerLock has to be locked.
+     */
+    static void publishBackBuffer(DataElement *element) {
+      int index;
+      // the package has to be complete before it is visible
+      __sync_synchronize();
+      index = __sync_lock_test_and_set(&element->readyIndex,
+                                       element->backIndex | READY_BUFFER_DIRTY);
+      element->backIndex = index & ~READY_BUFFER_DIRTY;
+    }
+
+    /**
+     * Takes the latest published buffer as front buffer. The bufferLock
+     * has to be locked for writing.
+     */
+    static void swapFrontBuffer(DataElement *element) {
+      int index;
+      if(element->readyIndex & READY_BUFFER_DIRTY) {
+        index = __sync_lock_test_and_set(&element->readyIndex,
+                                         element->frontIndex);
+        element->frontIndex = index & ~READY_BUFFER_DIRTY;
+        element->frontBuffer = element->buffers[element->frontIndex];
+      }
+    }
+
+    /**
+     * Updates the front buffer and leaves the bufferLock locked for reading.
+     */
+    static void lockFrontBuffer(DataElement *element) {
+      if(element->readyIndex & READY_BUFFER_DIRTY) {
+        element->bufferLock->lockForWrite();
+        swapFrontBuffer(element);
+        element->bufferLock->unlock();
+      }
+      element->bufferLock->lockForRead();
+    }
+
+    /**
+     * Replaces the snapshot of the given receivers of the element. The
+     * receiverLock has to be locked for writing.
+     */
+    static void updateReceiverSnapshot(DataElement *element,
+                                       const std::list<Receiver> &receivers,
+                                       const std::vector<Receiver> * volatile *snapshot) {
+      const std::vector<Receiver> *oldSnapshot = *snapshot;
+      std::vector<Receiver> *newSnapshot;
+      newSnapshot = new std::vector<Receiver>(receivers.begin(),
+                                              receivers.end());
+      if(oldSnapshot) {
+        element->retiredReceivers.push_back(oldSnapshot);
+      }
+      __sync_synchronize();
+      *snapshot = newSnapshot;
+      // A reader that is not counted yet will see the new snapshot.
+      __sync_synchronize();
+      if(element->receiverReaders == 0) {
+        while(!element->retiredReceivers.empty()) {
+          delete element->retiredReceivers.front();
+          element->retiredReceivers.pop_front();
+        }
+      }
+    }
+
+    /**
+     * Returns the current snapshot, which is not deleted until
+     * releaseReceivers() is called.
+     */
+    static const std::vector<Receiver>* acquireReceivers(DataElement *element,
+                                                         const std::vector<Receiver> * volatile *snapshot) {
+      __sync_fetch_and_add(&element->receiverReaders, 1);
+      return *snapshot;
+    }
+
+    static void releaseReceivers(DataElement *element) {
+      __sync_fetch_and_sub(&element->receiverReaders, 1);
+    }
+
+    static void updateSyncReceiverSnapshot(DataElement *element) {
+      updateReceiverSnapshot(element, element->syncReceivers,
+                             &element->syncReceiverSnapshot);
+    }
+
+    static void updateAsyncReceiverSnapshot(DataElement *element) {
+      updateReceiverSnapshot(element, element->asyncReceivers,
+                             &element->asyncReceiverSnapshot);
+      element->numAsyncReceivers = (*element->asyncReceiverSnapshot).size();
+    }
+
+    class AsyncDispatchJob : public ParallelJob {
+    public:
+      explicit AsyncDispatchJob(DataBroker *broker) : broker(broker) {}
+      void runJob(size_t index) {
+        broker->dispatchElement(index);
+      }
+    private:
+      DataBroker *broker;
+    };
+
+    /**
+     * Gives the producer a package with the layout of its element.
+     */
+    static void prepareProducerPackage(TimedProducer *producer) {
+      DataElement *element = producer->element;
+      element->producerLock->lock();
+      DataPackage *back = element->buffers[element->backIndex];
+      if(!producer->package) {
+        producer->package = new DataPackage(*back);
+      }
+      else if(producer->package->size() != back->size()) {
+        *producer->package = *back;
+      }
+      element->producerLock->unlock();
+    }
+
+    class TimedProducerJob : public ParallelJob {
+    public:
+      explicit TimedProducerJob(std::vector<TimedProducer*> *producers)
+        : producers(producers) {}
+      void runJob(size_t index) {
+        TimedProducer *producer = (*producers)[index];
+        producer->producer->produceData(producer->element->info,
+                                        producer->package,
+                                        producer->callbackParam);
+      }
+    private:
+      std::vector<TimedProducer*> *producers;
+    };
+
 
     // C-function to be called by pthreads to start the thread
     static void* createDataBrokerThread(void *theObject) {
@@ -92,13 +225,21 @@ namespace mars {
     DataBroker::DataBroker(lib_manager::LibManager *theManager) :
       DataBrokerInterface(theManager),
       mars::utils::Thread(),
-      next_id(1), thread_running(false), stop_thread(false),
-      realtimeThreadRunning(false), startingRealtimeThread(false) {
-
-      updatedElementsBackBuffer = new std::set<DataElement*>;
-      updatedElementsFrontBuffer = new std::set<DataElement*>;
+      updatedElements(NULL), dispatchThreads(1), coalesceTime(0),
+      dispatcherSleeping(0), wakeupPending(0), steppingTimers(0),
+      timerThreads(1), next_id(1),
+      thread_running(false),
+      stop_thread(false), realtimeThreadRunning(false),
+      startingRealtimeThread(false), receiverRevision(0),
+      timedReceiverRevision(~0ul) {
+
+      // the id 0 is not used
+      elementsById.push_back(NULL);
+      timersById.push_back(NULL);
+      triggersById.push_back(NULL);
 
       DataElement *e;
+      elementsLock.lockForWrite();
       e = createDataElement("data_broker", "newStream", DATA_PACKAGE_READ_FLAG);
       newStreamId = e->info.dataId;
 
@@ -121,7 +262,6 @@ namespace mars {
                                        DATA_PACKAGE_READ_FLAG);
       pushMessageIds[DB_MESSAGE_TYPE_DEBUG] = debugElement->info.dataId;
 
-      elementsLock.lockForWrite();
       publishDataElement(fatalElement);
       publishDataElement(errorElement);
       publishDataElement(warningElement);
@@ -138,46 +278,57 @@ namespace mars {
     DataBroker::~DataBroker() {
       stopRealtimeThread = true;
       stop_thread = true;
-      if(wakeupMutex.tryLock() == MUTEX_ERROR_NO_ERROR) {
-        wakeupCondition.wakeOne();
-        wakeupMutex.unlock();
-      }
+      wakeupMutex.lock();
+      wakeupCondition.wakeOne();
+      wakeupMutex.unlock();
       while(thread_running || realtimeThreadRunning) {
         msleep(10);
       }
-      std::map<unsigned long, DataElement*>::iterator elementIt;
+      std::vector<DataElement*>::iterator elementIt;
       std::map<std::string, Timer>::iterator timerIt;
       std::map<std::string, Trigger>::iterator triggerIt;
       // TODO: This cleanup code is not really perfect threadingwise
       elementsLock.lockForWrite();
       timersLock.lockForWrite();
       triggersLock.lockForWrite();
-      updatedElementsLock.lock();
-      updatedElementsBackBuffer->clear();
-      updatedElementsFrontBuffer->clear();
-      delete updatedElementsBackBuffer;
-      delete updatedElementsFrontBuffer;
+      updatedElements = NULL;
       for(timerIt = timers.begin(); timerIt != timers.end(); ++timerIt) {
         //destroyLock(&timerIt->second.lock);
+        std::list<TimedProducer>::iterator producerIt;
+        for(producerIt = timerIt->second.producers.begin();
+            producerIt != timerIt->second.producers.end(); ++producerIt) {
+          delete producerIt->package;
+        }
       }
       timers.clear();
+      timersById.clear();
       for(triggerIt = triggers.begin();
           triggerIt != triggers.end(); ++triggerIt) {
         //destroyLock(&triggerIt->second.lock);
       }
       triggers.clear();
+      triggersById.clear();
       for(elementIt = elementsById.begin();
           elementIt != elementsById.end(); ++elementIt) {
-        DataElement *element = elementIt->second;
+        DataElement *element = *elementIt;
+        if(!element) continue;
         //destroyLock(&element->receiverLock);
         //destroyLock(&element->bufferLock);
-        delete element->backBuffer;
-        delete element->frontBuffer;
+        for(int i=0; i<3; ++i) {
+          delete element->buffers[i];
+        }
+        delete element->asyncPackage;
+        delete element->producerLock;
+        delete element->syncReceiverSnapshot;
+        delete element->asyncReceiverSnapshot;
+        while(!element->retiredReceivers.empty()) {
+          delete element->retiredReceivers.front();
+          element->retiredReceivers.pop_front();
+        }
         delete element;
       }
       elementsById.clear();
       elementsByName.clear();
-      updatedElementsLock.unlock();
       triggersLock.unlock();
       timersLock.unlock();
       elementsLock.unlock();
@@ -211,16 +362,37 @@ namespace mars {
       timerIt = timers.find(timerName);
       if(timerIt == timers.end()) {
         timers[timerName] = Timer();
+        timers[timerName].id = timersById.size();
+        timersById.push_back(&timers[timerName]);
         timers[timerName].t = 0;
         timers[timerName].receivers.clear();
         timers[timerName.c_str()].lock = new mars::utils::ReadWriteLock();
         ok = true;
         std::map<std::pair<std::string, std::string>, DataElement*>::iterator elementIt;
 
+        elementsLock.lockForWrite();
         DataElement *e = createDataElement("data_broker", "timers/" + timerName,
                                            DATA_PACKAGE_READ_FLAG);
         timers[timerName].timerElementId = e->info.dataId;
+        publishDataElement(e);
+        elementsLock.unlock();
+
+        // the latency histogram of the timer steps
+        Timer &timer = timers[timerName];
+        timer.latencyCount = timer.latencyMax = 0;
+        timer.latencySum = 0.0;
+        timer.latencyPackage.add("count", 0L);
+        timer.latencyPackage.add("last", 0L);
+        timer.latencyPackage.add("mean", 0.0);
+        timer.latencyPackage.add("max", 0L);
+        for(int i=0; i<TIMER_LATENCY_BINS; ++i) {
+          timer.latencyBins[i] = 0;
+          timer.latencyPackage.add("bin" + numToStr(i), 0L);
+        }
         elementsLock.lockForWrite();
+        e = createDataElement("data_broker", "timers/" + timerName + "/latency",
+                              DATA_PACKAGE_READ_FLAG);
+        timer.latencyElementId = e->info.dataId;
         publishDataElement(e);
         elementsLock.unlock();
 
@@ -256,7 +428,8 @@ namespace mars {
         for(pendingProducerIt = pendingTimedProducers.begin();
             pendingProducerIt != pendingTimedProducers.end(); /* do nothing */) {
           if(pendingProducerIt->timerName == timerName) {
-            elementsLock.lockForRead(); // ToDo: missing unlock
+            // the element might be created
+            elementsLock.lockForWrite();
             elementIt = elementsByName.find(std::make_pair(pendingProducerIt->groupName,
                                                            pendingProducerIt->dataName));
             DataElement *element;
@@ -267,6 +440,7 @@ namespace mars {
                                           pendingProducerIt->dataName,
                                           DATA_PACKAGE_NO_FLAG);
             }
+            elementsLock.unlock();
             TimedProducer timedProducer = {pendingProducerIt->producer, element,
                                            pendingProducerIt->updatePeriod,
                                            timerIt->second.t,
@@ -287,12 +461,7 @@ namespace mars {
 
     bool DataBroker::stepTimer(const std::string &timerName, long step) {
       std::map<std::string, Timer>::iterator timerIt, endIt;
-      std::list<DeferredCallback> deferredCallbacks;
-      std::set<DataItemConnection> activeConnections;
-      std::set<DataElement*> connectionActivatedElements;
-      DataItem currentItem;
 
-      //bool ok = false;
       timersLock.lockForRead();
       timerIt = timers.find(timerName);
       // The use of an iterator should be thread-safe.
@@ -302,71 +471,126 @@ namespace mars {
       if(timerIt == endIt) {
         return false;
       }
-      //ok = true;
-      timerIt->second.lock->lockForWrite();
-      timerIt->second.t += step;
-      // call all producers
-      DeferredCallback deferredCallback;
+      advanceTimer(&timerIt->second, step);
+      return true;
+    }
+
+    bool DataBroker::stepTimer(unsigned long timerId, long step) {
+      Timer *timer = NULL;
+      timersLock.lockForRead();
+      if(timerId < timersById.size()) {
+        timer = timersById[timerId];
+      }
+      timersLock.unlock();
+      if(!timer) {
+        return false;
+      }
+      advanceTimer(timer, step);
+      return true;
+    }
+
+    unsigned long DataBroker::getTimerID(const std::string &timerName) const {
+      std::map<std::string, Timer>::const_iterator timerIt;
+      unsigned long id = 0;
+      timersLock.lockForRead();
+      timerIt = timers.find(timerName);
+      if(timerIt != timers.end()) {
+        id = timerIt->second.id;
+      }
+      timersLock.unlock();
+      return id;
+    }
+
+    void DataBroker::advanceTimer(Timer *timer, long step) {
+      std::list<DeferredCallback> deferredCallbacks;
+      std::set<ConnectionTarget> connectionTargets;
+
+      long long startTime = getTimeMicro();
+      __sync_fetch_and_add(&steppingTimers, 1);
+      timer->lock->lockForWrite();
+      timer->t += step;
+      // collect the producers that are due
+      std::vector<TimedProducer*> &dueProducers = timer->dueProducers;
       std::list<TimedProducer>::iterator producerIt;
-      for(producerIt = timerIt->second.producers.begin();
-          producerIt != timerIt->second.producers.end();
+      dueProducers.clear();
+      for(producerIt = timer->producers.begin();
+          producerIt != timer->producers.end();
           ++producerIt) {
-        if(producerIt->nextTriggerTime <= timerIt->second.t) {
+        if(producerIt->nextTriggerTime <= timer->t) {
           while(producerIt->updatePeriod > 0 &&
-                producerIt->nextTriggerTime <= timerIt->second.t) {
+                producerIt->nextTriggerTime <= timer->t) {
             producerIt->nextTriggerTime += producerIt->updatePeriod;
           }
-          DataElement *element = producerIt->element;
-
-          deferredCallback.receivers.clear();
-
-          element->bufferLock->lockForWrite();
-          producerIt->producer->produceData(element->info,
-                                            element->backBuffer,
-                                            producerIt->callbackParam);
-          std::swap(element->backBuffer, element->frontBuffer);
-          element->receiverLock->lockForRead();
-          if(!element->syncReceivers.empty()) {
-            deferredCallback.package = *element->frontBuffer;
-            deferredCallback.info = element->info;
-            deferredCallback.producer = NULL;
-            deferredCallback.receivers = element->syncReceivers;
-          }
-          std::list<DataItemConnection>::iterator connectionIt;
-          for(connectionIt = element->connections.begin();
-              connectionIt != element->connections.end(); ++connectionIt) {
-            long fromIdx = connectionIt->fromDataItemIndex;
-            long toIdx = connectionIt->toDataItemIndex;
-            currentItem = (*connectionIt->fromElement->frontBuffer)[fromIdx];
-            currentItem.setName((*connectionIt->toElement->backBuffer)[toIdx].getName());
-            (*connectionIt->toElement->frontBuffer)[toIdx] = currentItem;
-            connectionActivatedElements.insert(connectionIt->toElement);
-          }
-          element->receiverLock->unlock();
-          element->bufferLock->unlock();
+          prepareProducerPackage(&*producerIt);
+          dueProducers.push_back(&*producerIt);
+        }
+      }
+
+      // call the producers in parallel, each fills its own package
+      TimedProducerJob job(&dueProducers);
+      if(dueProducers.size() == 1) {
+        job.runJob(0);
+      }
+      else if(dueProducers.size() > 1) {
+        unsigned int numThreads = timerThreads;
+        MutexLocker locker(&timerPoolMutex);
+        numThreads = numThreads > 1 ? numThreads-1 : 0;
+        if(timerPool.getNumThreads() != numThreads) {
+          timerPool.setNumThreads(numThreads);
+        }
+        timerPool.run(&job, dueProducers.size());
+      }
+
+      // publish the packages in the order of the producers
+      DeferredCallback deferredCallback;
+      std::vector<TimedProducer*>::iterator dueIt;
+      for(dueIt = dueProducers.begin(); dueIt != dueProducers.end(); ++dueIt) {
+        TimedProducer *producer = *dueIt;
+        DataElement *element = producer->element;
+        DataPackage *package = producer->package;
+        const std::vector<Receiver> *syncReceivers;
 
-          updatedElementsLock.lock();
-          updatedElementsBackBuffer->insert(element);
-          updatedElementsLock.unlock();
+        deferredCallback.receivers.clear();
 
-          // defer synchronous callbacks until we do not hold any locks anymore
-          if(!deferredCallback.receivers.empty())
-            deferredCallbacks.push_back(deferredCallback);
+        // the produced package becomes the back buffer, the same lock
+        // order as in pushElement
+        elementsLock.lockForRead();
+        element->producerLock->lock();
+        producer->package = element->buffers[element->backIndex];
+        element->buffers[element->backIndex] = package;
+        syncReceivers = acquireReceivers(element,
+                                         &element->syncReceiverSnapshot);
+        if(syncReceivers && !syncReceivers->empty()) {
+          deferredCallback.package = *package;
+          deferredCallback.info = element->info;
+          deferredCallback.producer = NULL;
+          deferredCallback.receivers.assign(syncReceivers->begin(),
+                                            syncReceivers->end());
         }
+        releaseReceivers(element);
+        applyRoutes(element, *package, &connectionTargets);
+        publishBackBuffer(element);
+        element->producerLock->unlock();
+        elementsLock.unlock();
+        markUpdated(element);
+
+        // defer synchronous callbacks until we do not hold any locks anymore
+        if(!deferredCallback.receivers.empty())
+          deferredCallbacks.push_back(deferredCallback);
       }
 
       // push time package
       DataPackage p;
-      p.add("t", timerIt->second.t);
-      pushData(timerIt->second.timerElementId, p);
+      p.add("t", timer->t);
+      pushData(timer->timerElementId, p);
 
       // defer receivers
-      long time = timerIt->second.t;
+      long time = timer->t;
       std::list<TimedReceiver> deferredReceivers;
       std::list<TimedReceiver>::iterator timedReceiverIt;
 
-      for(timedReceiverIt = timerIt->second.receivers.begin();
-          timedReceiverIt != timerIt->second.receivers.end();
+      for(timedReceiverIt = timer->receivers.begin();
+          timedReceiverIt != timer->receivers.end();
           ++timedReceiverIt) {
         if(timedReceiverIt->nextTriggerTime <= time) {
           while(timedReceiverIt->updatePeriod > 0 &&
@@ -377,29 +601,22 @@ namespace mars {
         }
       }
 
-      timerIt->second.lock->unlock();
+      timer->lock->unlock();
 
       // call all deferred receivers
       for(timedReceiverIt = deferredReceivers.begin();
           timedReceiverIt != deferredReceivers.end();
           ++timedReceiverIt) {
         DataElement *element = timedReceiverIt->element;
-        element->bufferLock->lockForRead();
+        lockFrontBuffer(element);
         timedReceiverIt->receiver->receiveData(element->info,
                                                *element->frontBuffer,
                                                timedReceiverIt->callbackParam);
         element->bufferLock->unlock();
       }
 
-      // connections
-      std::set<DataElement*>::iterator toElementIt;
-      fflush(stderr);
-      for(toElementIt = connectionActivatedElements.begin();
-          toElementIt != connectionActivatedElements.end(); ++toElementIt) {
-        DataElement *toElement = *toElementIt;
-        //      std::swap(toElement->frontBuffer, toElement->backBuffer);
-        pushData(toElement->info.dataId, *toElement->frontBuffer);
-      }
+      // push every connected element once for this step
+      pushConnectionTargets(&connectionTargets);
       // call deferred sync callbacks
       std::list<DeferredCallback>::iterator callbackIt;
       std::list<Receiver>::iterator receiverIt;
@@ -415,7 +632,38 @@ namespace mars {
         }
       }
 
-      return true;
+      updateTimerLatency(timer, getTimeMicro() - startTime);
+      // the elements updated in this step are dispatched together
+      if(__sync_sub_and_fetch(&steppingTimers, 1) == 0 && updatedElements) {
+        wakeDispatcher();
+      }
+    }
+
+    void DataBroker::updateTimerLatency(Timer *timer, long latency) {
+      DataPackage package;
+      int bin = 0;
+      while(bin < TIMER_LATENCY_BINS-1 && (latency >> (bin+1)) > 0) {
+        ++bin;
+      }
+      timer->lock->lockForWrite();
+      timer->latencyCount += 1;
+      timer->latencySum += latency;
+      if(latency > timer->latencyMax) timer->latencyMax = latency;
+      timer->latencyBins[bin] += 1;
+      // the order of the items is defined in createTimer
+      timer->latencyPackage.set(0, timer->latencyCount);
+      timer->latencyPackage.set(1, latency);
+      timer->latencyPackage.set(2, timer->latencySum/timer->latencyCount);
+      timer->latencyPackage.set(3, timer->latencyMax);
+      timer->latencyPackage.set(4+bin, timer->latencyBins[bin]);
+      package = timer->latencyPackage;
+      timer->lock->unlock();
+      pushData(timer->latencyElementId, package);
+    }
+
+    void DataBroker::setTimerThreads(unsigned int numThreads) {
+      // the pool is resized by the next stepTimer() call
+      timerThreads = numThreads;
     }
 
     bool DataBroker::registerTimedReceiver(ReceiverInterface *receiver,
@@ -467,6 +715,7 @@ namespace mars {
         tmp.callbackParam = callbackParam;
         pendingTimedRegistrations.locked_push_back(tmp);
       }
+      __sync_fetch_and_add(&receiverRevision, 1);
       return ok;
     }
 
@@ -520,6 +769,7 @@ namespace mars {
         }
       }
       pendingRegistrationLock.unlock();
+      __sync_fetch_and_add(&receiverRevision, 1);
       return ok;
     }
 
@@ -537,7 +787,8 @@ namespace mars {
       endIt = timers.end();
       timersLock.unlock();
       if(timerIt != endIt) {
-        elementsLock.lockForRead();
+        // the element might be created
+        elementsLock.lockForWrite();
         elementIt = elementsByName.find(std::make_pair(groupName, dataName));
         DataElement *element = NULL;
         if(elementIt == elementsByName.end()) {
@@ -590,6 +841,7 @@ namespace mars {
             producerIt != timerIt->second.producers.end(); /* do nothing */) {
           if(producerIt->producer == producer) {
             // todo: match group and data name
+            delete producerIt->package;
             producerIt = timerIt->second.producers.erase(producerIt);
             ok = true;
           } else {
@@ -628,6 +880,8 @@ namespace mars {
       triggerIt = triggers.find(triggerName);
       if(triggerIt == triggers.end()) {
         triggers[triggerName] = Trigger();
+        triggers[triggerName].id = triggersById.size();
+        triggersById.push_back(&triggers[triggerName]);
         triggers[triggerName].receivers.clear();
         triggers[triggerName].lock = new ReadWriteLock;
         ok = true;
@@ -661,30 +915,60 @@ namespace mars {
 
     bool DataBroker::trigger(const std::string &triggerName) {
       std::map<std::string, Trigger>::iterator triggerIt, endIt;
-      std::list<TriggeredReceiver>::iterator receiverIt;
       bool ok = false;
       triggersLock.lockForRead();
       triggerIt = triggers.find(triggerName);
       endIt = triggers.end();
       triggersLock.unlock();
       if(triggerIt != endIt) {
-        triggerIt->second.lock->lockForRead();
-        for(receiverIt = triggerIt->second.receivers.begin();
-            receiverIt != triggerIt->second.receivers.end();
-            ++receiverIt) {
-          DataElement *element = receiverIt->element;
-          element->bufferLock->lockForRead();
-          receiverIt->receiver->receiveData(element->info,
-                                            *element->frontBuffer,
-                                            receiverIt->callbackParam);
-          element->bufferLock->unlock();
-        }
-        triggerIt->second.lock->unlock();
+        fireTrigger(&triggerIt->second);
         ok = true;
       }
       return ok;
     }
 
+    bool DataBroker::trigger(unsigned long triggerId) {
+      Trigger *trigger = NULL;
+      triggersLock.lockForRead();
+      if(triggerId < triggersById.size()) {
+        trigger = triggersById[triggerId];
+      }
+      triggersLock.unlock();
+      if(!trigger) {
+        return false;
+      }
+      fireTrigger(trigger);
+      return true;
+    }
+
+    unsigned long DataBroker::getTriggerID(const std::string &triggerName) const {
+      std::map<std::string, Trigger>::const_iterator triggerIt;
+      unsigned long id = 0;
+      triggersLock.lockForRead();
+      triggerIt = triggers.find(triggerName);
+      if(triggerIt != triggers.end()) {
+        id = triggerIt->second.id;
+      }
+      triggersLock.unlock();
+      return id;
+    }
+
+    void DataBroker::fireTrigger(Trigger *trigger) {
+      std::list<TriggeredReceiver>::iterator receiverIt;
+      trigger->lock->lockForRead();
+      for(receiverIt = trigger->receivers.begin();
+          receiverIt != trigger->receivers.end();
+          ++receiverIt) {
+        DataElement *element = receiverIt->element;
+        lockFrontBuffer(element);
+        receiverIt->receiver->receiveData(element->info,
+                                          *element->frontBuffer,
+                                          receiverIt->callbackParam);
+        element->bufferLock->unlock();
+      }
+      trigger->lock->unlock();
+    }
+
     bool DataBroker::registerTriggeredReceiver(ReceiverInterface *receiver,
                                                const std::string &groupName,
                                                const std::string &dataName,
@@ -708,6 +992,7 @@ namespace mars {
         }
         elementsLock.unlock();
       }
+      __sync_fetch_and_add(&receiverRevision, 1);
       return ok;
     }
 
@@ -758,6 +1043,7 @@ namespace mars {
       }
       pendingRegistrationLock.unlock();
 
+      __sync_fetch_and_add(&receiverRevision, 1);
       return ok;
     }
 
@@ -773,7 +1059,10 @@ namespace mars {
           elementIt != elements.end(); ++elementIt){
         DataElement *element = *elementIt;
         Receiver r = { receiver, callbackParam };
+        element->receiverLock->lockForWrite();
         element->syncReceivers.locked_push_back(r);
+        updateSyncReceiverSnapshot(element);
+        element->receiverLock->unlock();
       }
       if(wildcards || elements.empty()) {
         PendingRegistration tmp = { receiver, groupName.c_str(),
@@ -781,6 +1070,7 @@ namespace mars {
         pendingSyncRegistrations.locked_push_back(tmp);
       }
       elementsLock.unlock();
+      __sync_fetch_and_add(&receiverRevision, 1);
       return (wildcards || !elements.empty());
     }
 
@@ -806,6 +1096,7 @@ namespace mars {
             ++receiverIt;
           }
         }
+        updateSyncReceiverSnapshot(element);
         element->receiverLock->unlock();
       }
       // remove from pending list
@@ -822,6 +1113,7 @@ namespace mars {
       }
       pendingRegistrationLock.unlock();
       elementsLock.unlock();
+      __sync_fetch_and_add(&receiverRevision, 1);
       return cnt;
     }
 
@@ -837,7 +1129,10 @@ namespace mars {
           elementIt != elements.end(); ++elementIt){
         DataElement *element = *elementIt;
         Receiver r = { receiver, callbackParam };
+        element->receiverLock->lockForWrite();
         element->asyncReceivers.locked_push_back(r);
+        updateAsyncReceiverSnapshot(element);
+        element->receiverLock->unlock();
       }
       if(wildcards || elements.empty()) {
         PendingRegistration tmp = { receiver, groupName.c_str(),
@@ -845,6 +1140,7 @@ namespace mars {
         pendingAsyncRegistrations.locked_push_back(tmp);
       }
       elementsLock.unlock();
+      __sync_fetch_and_add(&receiverRevision, 1);
       return (wildcards || !elements.empty());
     }
 
@@ -870,6 +1166,7 @@ namespace mars {
             ++receiverIt;
           }
         }
+        updateAsyncReceiverSnapshot(element);
         element->receiverLock->unlock();
       }
       // remove from pending list
@@ -886,6 +1183,7 @@ namespace mars {
       }
       pendingAsyncRegistrations.unlock();
       elementsLock.unlock();
+      __sync_fetch_and_add(&receiverRevision, 1);
       return cnt;
     }
 
@@ -908,7 +1206,17 @@ namespace mars {
 
       pushData(element->info.dataId, dataPackage, producer);
       // hack to solve empty backBuffer problem while using producerCallbacks
-      *element->backBuffer = dataPackage;
+      // the producers fill the buffers in turn so all need the layout
+      // with both locks no other thread can exchange the buffers
+      element->producerLock->lock();
+      element->bufferLock->lockForWrite();
+      for(int i=0; i<3; ++i) {
+        if(element->buffers[i]->size() != dataPackage.size()) {
+          *element->buffers[i] = dataPackage;
+        }
+      }
+      element->bufferLock->unlock();
+      element->producerLock->unlock();
 
       return element->info.dataId;
     }
@@ -916,69 +1224,110 @@ namespace mars {
     unsigned long DataBroker::pushData(unsigned long id,
                                        const DataPackage &dataPackage,
                                        const ReceiverInterface *producer) {
-      std::list<Receiver>::iterator syncReceiverIt;
-      std::map<unsigned long, DataElement*>::iterator elementIt;
-      std::set<DataElement*> connectionActivatedElements;
-      std::list<Receiver> syncReceivers;
-      DataInfo info;
-      DataElement *element = NULL;
-      elementsLock.lockForRead();
-      elementIt = elementsById.find(id);
-      if(elementIt == elementsById.end()) {
+      std::set<ConnectionTarget> targets;
+      if(!pushElement(id, dataPackage, producer, &targets)) {
         // ERROR: id not found!
-        elementsLock.unlock();
         return 0;
-      } else {
-        element = elementIt->second;
-        *element->backBuffer = dataPackage;
-        element->bufferLock->lockForWrite();
-        std::swap(element->backBuffer, element->frontBuffer);
-        element->lastProducer = producer;
-        element->bufferLock->unlock();
-
-        updatedElementsLock.lock();
-        updatedElementsBackBuffer->insert(element);
-        updatedElementsLock.unlock();
+      }
+      pushConnectionTargets(&targets);
+      return id;
+    }
 
-        element->receiverLock->lockForRead();
-        // defer synchronous callbacks until we do not hold any locks anymore
-        syncReceivers = element->syncReceivers;
-        info = element->info;
-        element->receiverLock->unlock();
-        for(std::list<DataItemConnection>::iterator connectionIt = element->connections.begin(); connectionIt != element->connections.end(); ++connectionIt) {
-          long fromIdx = connectionIt->fromDataItemIndex;
-          long toIdx = connectionIt->toDataItemIndex;
-          DataItem currentItem;
-          currentItem = (*connectionIt->fromElement->frontBuffer)[fromIdx];
-          currentItem.setName((*connectionIt->toElement->frontBuffer)[toIdx].getName());
-          (*connectionIt->toElement->frontBuffer)[toIdx] = currentItem;
-          connectionActivatedElements.insert(connectionIt->toElement);
-        }
+    /**
+     * Publishes the package and calls the sync receivers. The elements
+     * connected to this one are updated and added to the targets but not
+     * pushed.
+     */
+    DataElement* DataBroker::pushElement(unsigned long id,
+                                         const DataPackage &dataPackage,
+                                         const ReceiverInterface *producer,
+                                         std::set<ConnectionTarget> *targets) {
+      std::vector<Receiver>::const_iterator syncReceiverIt;
+      const std::vector<Receiver> *syncReceivers;
+      DataElement *element = NULL;
+      elementsLock.lockForRead();
+      if(id < elementsById.size()) {
+        element = elementsById[id];
+      }
+      if(!element) {
+        elementsLock.unlock();
+        return NULL;
       }
+      // several threads may push the same element, e.g. the messages
+      element->producerLock->lock();
+      *element->buffers[element->backIndex] = dataPackage;
+      element->lastProducer = producer;
+      publishBackBuffer(element);
+      element->producerLock->unlock();
+      markUpdated(element);
+
+      // the snapshot is never changed, so we can use it without a lock
+      syncReceivers = acquireReceivers(element, &element->syncReceiverSnapshot);
+      applyRoutes(element, dataPackage, targets);
       elementsLock.unlock();
 
       // do the synchronous callbacks
-      for(syncReceiverIt = syncReceivers.begin();
-          syncReceiverIt != syncReceivers.end();
-          ++syncReceiverIt) {
-        if(syncReceiverIt->receiver != producer)
-          syncReceiverIt->receiver->receiveData(info, dataPackage,
-                                                syncReceiverIt->callbackParam);
+      if(syncReceivers) {
+        for(syncReceiverIt = syncReceivers->begin();
+            syncReceiverIt != syncReceivers->end();
+            ++syncReceiverIt) {
+          if(syncReceiverIt->receiver != producer)
+            syncReceiverIt->receiver->receiveData(element->info, dataPackage,
+                                                  syncReceiverIt->callbackParam);
+        }
       }
+      releaseReceivers(element);
+      return element;
+    }
 
-      for(std::set<DataElement*>::iterator toElementIt = connectionActivatedElements.begin(); toElementIt != connectionActivatedElements.end(); ++toElementIt) {
-        DataElement *toElement = *toElementIt;
-        pushData(toElement->info.dataId, *toElement->frontBuffer);
+    /**
+     * Copies the connected items of the package into the front buffers of
+     * the target elements. The caller has to hold the elementsLock.
+     */
+    void DataBroker::applyRoutes(const DataElement *element,
+                                 const DataPackage &package,
+                                 std::set<ConnectionTarget> *targets) {
+      std::vector<ConnectionRoute>::const_iterator routeIt;
+      std::vector<std::pair<long, long> >::const_iterator itemIt;
+      long size = package.size();
+
+      for(routeIt = element->routes.begin();
+          routeIt != element->routes.end(); ++routeIt) {
+        DataElement *toElement = routeIt->toElement;
+        toElement->bufferLock->lockForWrite();
+        swapFrontBuffer(toElement);
+        DataPackage &toPackage = *toElement->frontBuffer;
+        long toSize = toPackage.size();
+        for(itemIt = routeIt->items.begin();
+            itemIt != routeIt->items.end(); ++itemIt) {
+          if(itemIt->first < size && itemIt->second < toSize) {
+            toPackage[itemIt->second].assignValue(package[itemIt->first]);
+          }
+        }
+        toElement->bufferLock->unlock();
+        targets->insert(ConnectionTarget(toElement->connectionRank,
+                                         toElement));
       }
+    }
 
-      // The main thread only releases the wakeupMutex when it goes to sleep.
-      // So if we can lock it, we wake up the main thread so it can process the
-      // data we just pushed. Otherwise it is still running and will process it.
-      if(wakeupMutex.tryLock() == MUTEX_ERROR_NO_ERROR) {
-        wakeupCondition.wakeOne();
-        wakeupMutex.unlock();
+    /**
+     * Pushes the updated targets in the order of their rank. Since the
+     * connections have no cycles, every element is pushed once after all
+     * its sources are pushed.
+     */
+    void DataBroker::pushConnectionTargets(std::set<ConnectionTarget> *targets) {
+      DataPackage package;
+      DataElement *toElement;
+
+      while(!targets->empty()) {
+        toElement = targets->begin()->second;
+        targets->erase(targets->begin());
+        // copy the package since a receiver might read the element
+        lockFrontBuffer(toElement);
+        package = *toElement->frontBuffer;
+        toElement->bufferLock->unlock();
+        pushElement(toElement->info.dataId, package, NULL, targets);
       }
-      return id;
     }
 
     void DataBroker::pushMessage(MessageType messageType,
@@ -1035,86 +1384,142 @@ namespace mars {
     }
 
     void DataBroker::runRealtime() {
+      unsigned long timerId = getTimerID("_REALTIME_");
       long t = getTime();
       long dt;
       while(!stopRealtimeThread) {
         dt = getTimeDiff(t);
-        stepTimer("_REALTIME_", dt);
+        stepTimer(timerId, dt);
         t += dt;
         msleep(10);
       }
     }
 
+    /**
+     * Adds the element to the list of updated elements if it has async
+     * receivers and is not already part of the list. The dispatch thread
+     * is woken up at the end of a running timer step or else by the first
+     * push after it went to sleep.
+     *
+     * An async receiver that is registered concurrently gets the data with
+     * the next push.
+     */
+    void DataBroker::markUpdated(DataElement *element) {
+      DataElement *head;
+      if(!element->numAsyncReceivers) return;
+      if(!__sync_bool_compare_and_swap(&element->updated, 0, 1)) return;
+      do {
+        head = updatedElements;
+        element->nextUpdated = head;
+      } while(!__sync_bool_compare_and_swap(&updatedElements, head, element));
+      if(steppingTimers) return;
+      wakeDispatcher();
+    }
+
+    /**
+     * Signals the dispatch thread once per sleep. The caller has to add
+     * the updated elements before.
+     */
+    void DataBroker::wakeDispatcher() {
+      // The compare and swap of the list is a full barrier. Thus, either we
+      // see the dispatch thread sleeping or it sees the element in the list.
+      if(dispatcherSleeping &&
+         __sync_bool_compare_and_swap(&wakeupPending, 0, 1)) {
+        wakeupMutex.lock();
+        wakeupCondition.wakeOne();
+        wakeupMutex.unlock();
+      }
+    }
+
+    void DataBroker::setAsyncDispatch(unsigned int numThreads,
+                                      long coalesceTime) {
+      // the pool is resized by the dispatch thread itself
+      dispatchThreads = numThreads;
+      this->coalesceTime = coalesceTime;
+    }
+
+    void DataBroker::dispatchElement(size_t index) {
+      DataElement *element = dispatchElements[index];
+      const std::vector<Receiver> *receivers;
+      std::vector<Receiver>::const_iterator receiverIt;
+      const ReceiverInterface *producer;
+
+      receivers = acquireReceivers(element, &element->asyncReceiverSnapshot);
+      if(!receivers || receivers->empty()) {
+        releaseReceivers(element);
+        return;
+      }
+
+      // The asyncPackage is only used by this job, so we can call the
+      // receivers without holding a lock. Its items are reused in the next
+      // dispatch, thus there is no allocation for a stable layout.
+      lockFrontBuffer(element);
+      *element->asyncPackage = *element->frontBuffer;
+      producer = element->lastProducer;
+      element->bufferLock->unlock();
+
+      for(receiverIt = receivers->begin(); receiverIt != receivers->end();
+          ++receiverIt) {
+        if(receiverIt->receiver != producer)
+          receiverIt->receiver->receiveData(element->info,
+                                            *element->asyncPackage,
+                                            receiverIt->callbackParam);
+      }
+      releaseReceivers(element);
+    }
+
     void DataBroker::run() {
-      std::set<DataElement*>::iterator updatedElementsIt;
-      std::list<Receiver>::iterator receiverIt;
-      std::list<DeferredCallback> deferredCallbacks;
-      std::list<DeferredCallback>::iterator callbackIt;
+      DataElement *element, *nextElement;
+      AsyncDispatchJob job(this);
+      unsigned int numThreads;
 
-      wakeupMutex.lock();
       while(!stop_thread) {
-        elementsLock.lockForRead();
-        updatedElementsLock.lock();
-        std::swap(updatedElementsBackBuffer, updatedElementsFrontBuffer);
-        updatedElementsLock.unlock();
-
-        for(updatedElementsIt = updatedElementsFrontBuffer->begin();
-            updatedElementsIt != updatedElementsFrontBuffer->end();
-            ++updatedElementsIt) {
-          DataElement *element = *updatedElementsIt;
-
-          element->bufferLock->lockForRead();
-          element->receiverLock->lockForRead();
-          // defer callbacks until we do not hold any lock anymore
-          if(!element->asyncReceivers.empty()) {
-            DeferredCallback deferred;
-            deferred.receivers = element->asyncReceivers;
-            deferred.info = element->info;
-            deferred.package = *element->frontBuffer;
-            deferred.producer = element->lastProducer;
-            deferredCallbacks.push_back(deferred);
-          }
-          element->receiverLock->unlock();
-          element->bufferLock->unlock();
+        numThreads = dispatchThreads;
+        numThreads = numThreads > 1 ? numThreads-1 : 0;
+        if(dispatchPool.getNumThreads() != numThreads) {
+          dispatchPool.setNumThreads(numThreads);
         }
-        updatedElementsFrontBuffer->clear();
-        elementsLock.unlock();
 
-        // make the callbacks
-        //pushError("DataBroker::deferredCallbacks %d", deferredCallbacks.size());
-        for(callbackIt = deferredCallbacks.begin();
-            callbackIt != deferredCallbacks.end(); ++callbackIt) {
-          for(receiverIt = callbackIt->receivers.begin();
-              receiverIt != callbackIt->receivers.end();
-              ++receiverIt) {
-            if(receiverIt->receiver != callbackIt->producer)
-              receiverIt->receiver->receiveData(callbackIt->info,
-                                                callbackIt->package,
-                                                receiverIt->callbackParam);
-          }
+        dispatchElements.clear();
+        element = __sync_lock_test_and_set(&updatedElements,
+                                           (DataElement*)NULL);
+        for(; element; element = nextElement) {
+          nextElement = element->nextUpdated;
+          // from now on a push adds the element to the list again
+          __sync_lock_release(&element->updated);
+          dispatchElements.push_back(element);
         }
-        deferredCallbacks.clear();
+        // the elements are only deleted with the DataBroker itself
+        dispatchPool.run(&job, dispatchElements.size());
 
         // If there is no data to process go to sleep. pushData() will wake us up.
-        updatedElementsLock.lock();
-        bool bufferIsEmpty = updatedElementsBackBuffer->empty();
-        updatedElementsLock.unlock();
-        if(bufferIsEmpty) {
+        wakeupMutex.lock();
+        dispatcherSleeping = 1;
+        while(!stop_thread) {
+          // a push that finds the flag set is seen by the check below
+          wakeupPending = 0;
+          __sync_synchronize();
+          if(updatedElements) break;
           wakeupCondition.wait(&wakeupMutex);
         }
-        msleep(10);
+        dispatcherSleeping = 0;
+        wakeupMutex.unlock();
+        // collect the data of further pushes
+        if(coalesceTime > 0) {
+          msleep(coalesceTime);
+        }
       }
-      wakeupMutex.unlock();
     }
 
 
     const std::vector<DataInfo> DataBroker::getDataList(PackageFlag flags) const {
       std::vector<DataInfo> dataList;
-      std::map<unsigned long, DataElement*>::const_iterator it;
+      std::vector<DataElement*>::const_iterator it;
       elementsLock.lockForRead();
       for(it = elementsById.begin(); it != elementsById.end(); ++it) {
-        if(flags == DATA_PACKAGE_NO_FLAG || flags & it->second->info.flags) {
-          dataList.push_back(it->second->info);
+        if(!*it) continue;
+        if(flags == DATA_PACKAGE_NO_FLAG || flags & (*it)->info.flags) {
+          dataList.push_back((*it)->info);
         }
       }
       elementsLock.unlock();
@@ -1124,19 +1529,97 @@ namespace mars {
 
     const DataPackage DataBroker::getDataPackage(unsigned long id) const {
       DataPackage dataPackage;
-      std::map<unsigned long, DataElement*>::const_iterator elementIt;
       elementsLock.lockForRead();
-      elementIt = elementsById.find(id);
-      if(elementIt != elementsById.end()) {
-        DataElement *element = elementIt->second;
-        element->bufferLock->lockForRead();
-        dataPackage = *elementIt->second->frontBuffer;
+      if(id < elementsById.size() && elementsById[id]) {
+        DataElement *element = elementsById[id];
+        lockFrontBuffer(element);
+        dataPackage = *element->frontBuffer;
         element->bufferLock->unlock();
       }
       elementsLock.unlock();
       return dataPackage;
     }
 
+    bool DataBroker::hasReceivers(unsigned long id) const {
+      DataElement *element = NULL;
+      const std::vector<Receiver> *receivers;
+      bool found = false;
+
+      elementsLock.lockForRead();
+      if(id < elementsById.size() && elementsById[id]) {
+        element = elementsById[id];
+        receivers = acquireReceivers(element, &element->syncReceiverSnapshot);
+        found = (receivers && !receivers->empty());
+        releaseReceivers(element);
+        receivers = acquireReceivers(element, &element->asyncReceiverSnapshot);
+        found = found || (receivers && !receivers->empty());
+        releaseReceivers(element);
+        found = found || !element->routes.empty();
+      }
+      elementsLock.unlock();
+      if(!element || found) return found;
+
+      MutexLocker locker(&timedReceiverLock);
+      updateTimedReceiverFlags();
+      return element->hasTimedReceivers;
+    }
+
+    /**
+     * Sets the hasTimedReceivers flag of all elements with one pass over
+     * the timers and triggers if the receivers changed since the last
+     * pass. Has to be called with a locked timedReceiverLock.
+     */
+    void DataBroker::updateTimedReceiverFlags() const {
+      std::vector<DataElement*>::const_iterator elementIt;
+      std::map<std::string, Timer>::const_iterator timerIt;
+      std::map<std::string, Trigger>::const_iterator triggerIt;
+      std::list<TimedReceiver>::const_iterator timedIt;
+      std::list<TriggeredReceiver>::const_iterator triggeredIt;
+      // a change during the pass is caught by the next call
+      unsigned long revision = receiverRevision;
+
+      if(revision == timedReceiverRevision) return;
+      elementsLock.lockForRead();
+      for(elementIt = elementsById.begin(); elementIt != elementsById.end();
+          ++elementIt) {
+        if(*elementIt) (*elementIt)->hasTimedReceivers = false;
+      }
+      elementsLock.unlock();
+
+      // the elements are only deleted with the DataBroker itself
+      timersLock.lockForRead();
+      for(timerIt = timers.begin(); timerIt != timers.end(); ++timerIt) {
+        timerIt->second.lock->lockForRead();
+        timerIt->second.receivers.lock();
+        for(timedIt = timerIt->second.receivers.begin();
+            timedIt != timerIt->second.receivers.end(); ++timedIt) {
+          timedIt->element->hasTimedReceivers = true;
+        }
+        timerIt->second.receivers.unlock();
+        timerIt->second.lock->unlock();
+      }
+      timersLock.unlock();
+
+      triggersLock.lockForRead();
+      for(triggerIt = triggers.begin(); triggerIt != triggers.end();
+          ++triggerIt) {
+        triggerIt->second.lock->lockForRead();
+        triggerIt->second.receivers.lock();
+        for(triggeredIt = triggerIt->second.receivers.begin();
+            triggeredIt != triggerIt->second.receivers.end(); ++triggeredIt) {
+          triggeredIt->element->hasTimedReceivers = true;
+        }
+        triggerIt->second.receivers.unlock();
+        triggerIt->second.lock->unlock();
+      }
+      triggersLock.unlock();
+      timedReceiverRevision = revision;
+    }
+
+    unsigned long DataBroker::getReceiverRevision() const {
+      return receiverRevision;
+    }
+
     unsigned long DataBroker::getDataID(const std::string &groupName,
                                         const std::string &dataName) const {
       std::map<std::pair<std::string, std::string>, DataElement*>::const_iterator elementIt;
@@ -1169,6 +1652,10 @@ namespace mars {
     }
 
 
+    /**
+     * The elementsLock has to be locked for writing since elementsById
+     * might be reallocated.
+     */
     DataElement *DataBroker::createDataElement(const std::string &groupName,
                                                const std::string &dataName,
                                                PackageFlag flags) {
@@ -1177,12 +1664,32 @@ namespace mars {
       element->info.groupName = groupName.c_str();
       element->info.dataName = dataName.c_str();
       element->info.flags = flags;
-      element->backBuffer = new DataPackage;
-      element->frontBuffer = new DataPackage;
+      for(int i=0; i<3; ++i) {
+        element->buffers[i] = new DataPackage;
+      }
+      element->backIndex = 0;
+      element->readyIndex = 1;
+      element->frontIndex = 2;
+      element->frontBuffer = element->buffers[2];
+      element->syncReceiverSnapshot = NULL;
+      element->asyncReceiverSnapshot = NULL;
+      element->numAsyncReceivers = 0;
+      element->receiverReaders = 0;
+      element->asyncPackage = new DataPackage;
+      element->lastProducer = NULL;
+      element->updated = 0;
+      element->nextUpdated = NULL;
+      element->hasTimedReceivers = false;
+      element->connectionRank = 0;
+      element->producerLock = new Mutex;
       element->bufferLock = new ReadWriteLock;
       element->receiverLock = new ReadWriteLock;
       elementsByName[std::make_pair(groupName.c_str(),
                                     dataName.c_str())] = element;
+      // the ids are given in order so the vector stays dense
+      if(element->info.dataId >= elementsById.size()) {
+        elementsById.resize(element->info.dataId+1, NULL);
+      }
       elementsById[element->info.dataId] = element;
       updatePendingRegistrations(element);
       return element;
@@ -1222,6 +1729,7 @@ namespace mars {
            matchPattern(registrationIt->dataName, newDataName)) {
           Receiver r = {registrationIt->receiver, registrationIt->callbackParam};
           newElement->asyncReceivers.push_back(r);
+          updateAsyncReceiverSnapshot(newElement);
           // if the registration has wildcards keep it in the pending list...
           if(hasWildcards(registrationIt->groupName) ||
              hasWildcards(registrationIt->dataName)) {
@@ -1242,6 +1750,7 @@ namespace mars {
            matchPattern(registrationIt->dataName, newDataName)) {
           Receiver r = {registrationIt->receiver, registrationIt->callbackParam};
           newElement->syncReceivers.push_back(r);
+          updateSyncReceiverSnapshot(newElement);
           // if the registration has wildcards keep it in the pending list...
           if(hasWildcards(registrationIt->groupName) ||
              hasWildcards(registrationIt->dataName)) {
@@ -1310,6 +1819,7 @@ namespace mars {
           ++triggeredRegistrationIt;
         }
       }
+      __sync_fetch_and_add(&receiverRevision, 1);
     }
 
     void DataBroker::getElementsByName(const std::string &groupName,
@@ -1344,39 +1854,60 @@ namespace mars {
       std::map<std::pair<std::string, std::string>, DataElement*>::iterator elementIt;
       DataItemConnection connection;
       // TODO: should we special case wildcards?
-      DataElement *element;
 
+      // pushError needs the elementsLock, so it is called after unlocking
+      elementsLock.lockForWrite();
       // from element handling
-      {
-        elementIt = elementsByName.find(std::make_pair(fromGroupName,
-                                                       fromDataName));
-        if(elementIt == elementsByName.end()) {
-          pushError("could not find from Element: %s, %s\n",
-                    fromGroupName.c_str(),
-                    fromDataName.c_str());
-          return;
-        }
-        element = elementIt->second;
-        connection.fromElement = element;
-        connection.fromDataItemIndex = element->frontBuffer->getIndexByName(fromItemName);
+      elementIt = elementsByName.find(std::make_pair(fromGroupName,
+                                                     fromDataName));
+      if(elementIt == elementsByName.end()) {
+        elementsLock.unlock();
+        pushError("could not find from Element: %s, %s\n",
+                  fromGroupName.c_str(),
+                  fromDataName.c_str());
+        return;
       }
+      connection.fromElement = elementIt->second;
+      lockFrontBuffer(connection.fromElement);
+      connection.fromDataItemIndex = connection.fromElement->frontBuffer->getIndexByName(fromItemName);
+      connection.fromElement->bufferLock->unlock();
 
       // to element handling
-      {
-        elementIt = elementsByName.find(std::make_pair(toGroupName,
-                                                       toDataName));
-        if(elementIt == elementsByName.end()) {
-          pushError("could not find to Element: %s, %s\n",
-                    toGroupName.c_str(),
-                    toDataName.c_str());
-          return;
-        }
-        element = elementIt->second;
-        connection.toElement = element;
-        connection.toDataItemIndex = element->frontBuffer->getIndexByName(toItemName);
+      elementIt = elementsByName.find(std::make_pair(toGroupName,
+                                                     toDataName));
+      if(elementIt == elementsByName.end()) {
+        elementsLock.unlock();
+        pushError("could not find to Element: %s, %s\n",
+                  toGroupName.c_str(),
+                  toDataName.c_str());
+        return;
+      }
+      connection.toElement = elementIt->second;
+      lockFrontBuffer(connection.toElement);
+      connection.toDataItemIndex = connection.toElement->frontBuffer->getIndexByName(toItemName);
+      connection.toElement->bufferLock->unlock();
+
+      if(connection.fromDataItemIndex < 0 || connection.toDataItemIndex < 0) {
+        elementsLock.unlock();
+        pushError("could not find the items to connect: %s, %s, %s to %s, %s, %s\n",
+                  fromGroupName.c_str(), fromDataName.c_str(),
+                  fromItemName.c_str(), toGroupName.c_str(),
+                  toDataName.c_str(), toItemName.c_str());
+        return;
+      }
+      // a cycle would push the elements forever
+      if(isConnected(connection.toElement, connection.fromElement)) {
+        elementsLock.unlock();
+        pushError("connecting %s, %s to %s, %s would create a cycle\n",
+                  fromGroupName.c_str(), fromDataName.c_str(),
+                  toGroupName.c_str(), toDataName.c_str());
+        return;
       }
 
       connection.fromElement->connections.push_back(connection);
+      updateRoutes(connection.fromElement);
+      updateConnectionRanks();
+      elementsLock.unlock();
     }
 
     void DataBroker::disconnectDataItems(const std::string &fromGroupName,
@@ -1388,69 +1919,155 @@ namespace mars {
       std::map<std::pair<std::string, std::string>, DataElement*>::iterator elementIt;
       std::list<DataItemConnection>::iterator jt;
       // TODO: should we special case wildcards?
-      DataElement *element;
+      DataElement *element, *toElement;
+      bool found;
 
+      elementsLock.lockForWrite();
       // from element handling
-      {
-        elementIt = elementsByName.find(std::make_pair(fromGroupName,
-                                                       fromDataName));
-        if(elementIt == elementsByName.end()) {
-          pushError("could not find from Element: %s, %s\n",
-                    fromGroupName.c_str(),
-                    fromDataName.c_str());
-          return;
+      elementIt = elementsByName.find(std::make_pair(fromGroupName,
+                                                     fromDataName));
+      if(elementIt == elementsByName.end()) {
+        elementsLock.unlock();
+        pushError("could not find from Element: %s, %s\n",
+                  fromGroupName.c_str(),
+                  fromDataName.c_str());
+        return;
+      }
+      element = elementIt->second;
+      for(jt=element->connections.begin();
+          jt!=element->connections.end(); ++jt) {
+        toElement = jt->toElement;
+        if(toElement->info.groupName != toGroupName ||
+           toElement->info.dataName != toDataName) {
+          continue;
         }
-        element = elementIt->second;
-        for(jt=element->connections.begin();
-            jt!=element->connections.end(); ++jt) {
-          jt->toElement->bufferLock->lockForWrite();
-          if(jt->toDataItemIndex >= (int)jt->toElement->frontBuffer->size()) {
-            pushError("DataBroker::disconnectDataItems : connection index does not match!");
-          }
-          else {
-            if(jt->toElement->info.groupName == toGroupName &&
-               jt->toElement->info.dataName == toDataName &&
-               (*jt->toElement->frontBuffer)[jt->toDataItemIndex].getName() == toItemName) {
-              jt->toElement->bufferLock->unlock();
-              element->connections.erase(jt);
-              break;
-            }
-          }
-          jt->toElement->bufferLock->unlock();
+        lockFrontBuffer(toElement);
+        found = (jt->toDataItemIndex < (long)toElement->frontBuffer->size() &&
+                 (*toElement->frontBuffer)[jt->toDataItemIndex].getName() == toItemName);
+        toElement->bufferLock->unlock();
+        if(found) {
+          element->connections.erase(jt);
+          updateRoutes(element);
+          updateConnectionRanks();
+          break;
         }
       }
+      elementsLock.unlock();
     }
 
     void DataBroker::disconnectDataItems(const std::string &toGroupName,
                                          const std::string &toDataName,
                                          const std::string &toItemName) {
-      std::map<unsigned long, DataElement*>::iterator it;
+      std::vector<DataElement*>::iterator it;
       std::list<DataItemConnection>::iterator jt;
+      DataElement *toElement;
+      bool found, changed = false;
 
       elementsLock.lockForWrite();
       for(it=elementsById.begin(); it!=elementsById.end(); ++it) {
-        for(jt=it->second->connections.begin();
-            jt!=it->second->connections.end(); ++jt) {
-          jt->toElement->bufferLock->lockForWrite();
-          if(jt->toDataItemIndex >= (int)jt->toElement->frontBuffer->size()) {
-            pushError("DataBroker::disconnectDataItems : connection index does not match!");
+        if(!*it) continue;
+        for(jt=(*it)->connections.begin();
+            jt!=(*it)->connections.end(); ++jt) {
+          toElement = jt->toElement;
+          if(toElement->info.groupName != toGroupName ||
+             toElement->info.dataName != toDataName) {
+            continue;
           }
-          else {
-            if(jt->toElement->info.groupName == toGroupName &&
-               jt->toElement->info.dataName == toDataName &&
-               (*jt->toElement->frontBuffer)[jt->toDataItemIndex].getName() == toItemName) {
-              jt->toElement->bufferLock->unlock();
-              it->second->connections.erase(jt);
-              //jt = it->second->connections.begin();
-              break;
-            }
+          lockFrontBuffer(toElement);
+          found = (jt->toDataItemIndex < (long)toElement->frontBuffer->size() &&
+                   (*toElement->frontBuffer)[jt->toDataItemIndex].getName() == toItemName);
+          toElement->bufferLock->unlock();
+          if(found) {
+            (*it)->connections.erase(jt);
+            updateRoutes(*it);
+            changed = true;
+            break;
           }
-          jt->toElement->bufferLock->unlock();
         }
       }
+      if(changed) {
+        updateConnectionRanks();
+      }
       elementsLock.unlock();
     }
 
+    /**
+     * Compiles the connections of the element into one route per target
+     * element. The caller has to hold the elementsLock for writing.
+     */
+    void DataBroker::updateRoutes(DataElement *element) {
+      std::list<DataItemConnection>::const_iterator it;
+      size_t i;
+
+      element->routes.clear();
+      for(it=element->connections.begin(); it!=element->connections.end();
+          ++it) {
+        for(i=0; i<element->routes.size(); ++i) {
+          if(element->routes[i].toElement == it->toElement) break;
+        }
+        if(i == element->routes.size()) {
+          element->routes.push_back(ConnectionRoute());
+          element->routes.back().toElement = it->toElement;
+        }
+        element->routes[i].items.push_back(std::make_pair(it->fromDataItemIndex,
+                                                          it->toDataItemIndex));
+      }
+      __sync_fetch_and_add(&receiverRevision, 1);
+    }
+
+    /**
+     * Sets the rank of every element to the length of the longest
+     * connection path leading to it. The caller has to hold the
+     * elementsLock for writing.
+     */
+    void DataBroker::updateConnectionRanks() {
+      std::vector<DataElement*>::iterator it;
+      std::vector<ConnectionRoute>::iterator routeIt;
+      bool changed = true;
+
+      for(it=elementsById.begin(); it!=elementsById.end(); ++it) {
+        if(*it) (*it)->connectionRank = 0;
+      }
+      // terminates since connectDataItems does not create cycles
+      while(changed) {
+        changed = false;
+        for(it=elementsById.begin(); it!=elementsById.end(); ++it) {
+          if(!*it) continue;
+          for(routeIt=(*it)->routes.begin(); routeIt!=(*it)->routes.end();
+              ++routeIt) {
+            if(routeIt->toElement->connectionRank <= (*it)->connectionRank) {
+              routeIt->toElement->connectionRank = (*it)->connectionRank + 1;
+              changed = true;
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * Returns true if toElement can be reached from fromElement by
+     * following the connections or if both are the same element.
+     */
+    bool DataBroker::isConnected(const DataElement *fromElement,
+                                 const DataElement *toElement) const {
+      std::vector<const DataElement*> stack(1, fromElement);
+      std::set<const DataElement*> visited;
+      std::list<DataItemConnection>::const_iterator it;
+      const DataElement *element;
+
+      while(!stack.empty()) {
+        element = stack.back();
+        stack.pop_back();
+        if(element == toElement) return true;
+        if(!visited.insert(element).second) continue;
+        for(it=element->connections.begin(); it!=element->connections.end();
+            ++it) {
+          stack.push_back(it->toElement);
+        }
+      }
+      return false;
+    }
+
   } // end of namespace data_broker
 } // end of namespace mars
 
@@ -35,6 +35,7 @@
 #include <mars/utils/Mutex.h>
 #include <mars/utils/ReadWriteLock.h>
 #include <mars/utils/WaitCondition.h>
+#include <mars/utils/ThreadPool.h>
 
 #include <string>
 #include <vector>
@@ -98,20 +99,39 @@ namespace mars {
       int callbackParam;
     };
 
+    /**
+     * The producer fills its own package, which is exchanged with the back
+     * buffer of the element when it is published. Thus the producers of a
+     * timer step can run in parallel without holding the producerLock of
+     * their elements, even if several of them produce the same element.
+     */
     struct TimedProducer {
       ProducerInterface *producer;
       DataElement *element;
       int updatePeriod;
       long nextTriggerTime;
       int callbackParam;
+      DataPackage *package; ///< created on the first step, guarded by the timer lock
     };
 
+    // number of the power of two bins of the timer latency histogram
+#define TIMER_LATENCY_BINS 16
+
     struct Timer {
+      unsigned long id; ///< index in DataBroker::timersById
       long t;
       LockableContainer<std::list<TimedProducer> > producers;
       LockableContainer<std::list<TimedReceiver> > receivers;
       mars::utils::ReadWriteLock *lock;
       unsigned long timerElementId;
+      std::vector<TimedProducer*> dueProducers;
+      // step latencies in microseconds, bin i counts the steps that took
+      // less than 2^(i+1) us, the last bin all longer steps
+      unsigned long latencyElementId;
+      long latencyCount, latencyMax;
+      double latencySum;
+      long latencyBins[TIMER_LATENCY_BINS];
+      DataPackage latencyPackage;
     };
 
     struct TriggeredReceiver {
@@ -121,6 +141,7 @@ namespace mars {
     };
 
     struct Trigger {
+      unsigned long id; ///< index in DataBroker::triggersById
       LockableContainer<std::list<TriggeredReceiver> > receivers;
       mars::utils::ReadWriteLock *lock;
     };
@@ -130,17 +151,70 @@ namespace mars {
       int callbackParam;
     };
 
+    /**
+     * The connections of an element compiled per target element. Every
+     * target is updated once with all its connected items.
+     */
+    struct ConnectionRoute {
+      DataElement *toElement;
+      /// pairs of the source and target item indices
+      std::vector<std::pair<long, long> > items;
+    };
+
+    /**
+     * An element whose connected items were updated. The targets are
+     * pushed in the order of their connectionRank, so that an element is
+     * pushed after all its updated sources.
+     */
+    typedef std::pair<int, DataElement*> ConnectionTarget;
+
+    /**
+     * The packages of an element are kept in a triple buffer. A producer
+     * owns buffers[backIndex] while it holds the producerLock and publishes
+     * it by exchanging the index with readyIndex. The readers swap the
+     * ready buffer into the frontBuffer under the bufferLock. Thus pushing
+     * only waits for other producers of the same element, never for a
+     * reader.
+     *
+     * The receivers are published as immutable snapshots that are
+     * replaced on every (un)registration. A push marks the snapshot it
+     * iterates in receiverReaders. Replaced snapshots are deleted by the
+     * next replacement that finds no reader.
+     *
+     * The asyncPackage is only used by the dispatch thread to hand the
+     * data to the async receivers.
+     */
     struct DataElement {
       DataInfo info;
-      //    bool updated;
-      DataPackage *backBuffer;
-      DataPackage *frontBuffer;
+      DataPackage *buffers[3];
+      int backIndex; ///< guarded by producerLock
+      volatile int readyIndex; ///< carries a flag if not read yet
+      int frontIndex; ///< guarded by bufferLock
+      DataPackage *frontBuffer; ///< guarded by bufferLock
       LockableContainer<std::list<Receiver> > syncReceivers;
       LockableContainer<std::list<Receiver> > asyncReceivers;
+      const std::vector<Receiver> * volatile syncReceiverSnapshot;
+      const std::vector<Receiver> * volatile asyncReceiverSnapshot;
+      /// size of the asyncReceiverSnapshot, a push without async
+      /// receivers skips the dispatch thread
+      volatile int numAsyncReceivers;
+      std::list<const std::vector<Receiver>*> retiredReceivers;
+      volatile int receiverReaders;
+      DataPackage *asyncPackage;
+      mars::utils::Mutex *producerLock;
       mars::utils::ReadWriteLock *bufferLock;
       mars::utils::ReadWriteLock *receiverLock;
-      const ReceiverInterface *lastProducer;
+      const ReceiverInterface *lastProducer; ///< written under producerLock
       std::list<DataItemConnection> connections;
+      /// compiled from connections, guarded by DataBroker::elementsLock
+      std::vector<ConnectionRoute> routes;
+      /// length of the longest connection path leading to this element
+      int connectionRank;
+      volatile int updated;
+      DataElement *nextUpdated;
+      /// set if a timer or trigger has a receiver for the element, guarded
+      /// by DataBroker::timedReceiverLock, see DataBroker::hasReceivers()
+      bool hasTimedReceivers;
     };
     /// \endcond
 
@@ -160,6 +234,8 @@ namespace mars {
        *         false if no timer with the given name exists.
        */
       bool stepTimer(const std::string &timerName, long step=1);
+      bool stepTimer(unsigned long timerId, long step=1);
+      unsigned long getTimerID(const std::string &timerName) const;
       bool registerTimedReceiver(ReceiverInterface *receiver,
                                  const std::string &groupName,
                                  const std::string &dataName,
@@ -183,6 +259,8 @@ namespace mars {
 
       bool createTrigger(const std::string &triggerName);
       bool trigger(const std::string &triggerName);
+      bool trigger(unsigned long triggerId);
+      unsigned long getTriggerID(const std::string &triggerName) const;
       bool registerTriggeredReceiver(ReceiverInterface *receiver,
                                      const std::string &groupName,
                                      const std::string &dataName,
@@ -224,6 +302,8 @@ namespace mars {
       const DataInfo getDataInfo(const std::string &groupName,
                                  const std::string &dataName) const;
       const DataPackage getDataPackage(unsigned long id) const;
+      bool hasReceivers(unsigned long id) const;
+      unsigned long getReceiverRevision() const;
 
       const std::vector<DataInfo> getDataList(PackageFlag flag) const;
 
@@ -244,8 +324,12 @@ namespace mars {
                                const std::string &toDataName,
                                const std::string &toItemName);
 
+      void setAsyncDispatch(unsigned int numThreads, long coalesceTime);
+      void setTimerThreads(unsigned int numThreads);
 
       void run(void);
+      // used by the jobs of the dispatch pool
+      void dispatchElement(size_t index);
       void runRealtime(void);
       inline void setThreadStopped(bool val) {thread_running = !val;}
       inline void setRTThreadStopped(bool val) {
@@ -275,6 +359,24 @@ namespace mars {
                                      PackageFlag flags);
       void publishDataElement(const DataElement *element);
       void updatePendingRegistrations(DataElement *newElement);
+      DataElement* pushElement(unsigned long id,
+                               const DataPackage &dataPackage,
+                               const ReceiverInterface *producer,
+                               std::set<ConnectionTarget> *targets);
+      void applyRoutes(const DataElement *element,
+                       const DataPackage &package,
+                       std::set<ConnectionTarget> *targets);
+      void pushConnectionTargets(std::set<ConnectionTarget> *targets);
+      void updateRoutes(DataElement *element);
+      void updateConnectionRanks();
+      bool isConnected(const DataElement *fromElement,
+                       const DataElement *toElement) const;
+      void markUpdated(DataElement *element);
+      void wakeDispatcher();
+      void updateTimedReceiverFlags() const;
+      void advanceTimer(Timer *timer, long step);
+      void fireTrigger(Trigger *trigger);
+      void updateTimerLatency(Timer *timer, long latency);
       unsigned long createId();
       //void destroyLock(pthread_rwlock_t *rwlock);
       //void destroyLock(pthread_mutex_t *mutex);
@@ -291,8 +393,18 @@ namespace mars {
                              const std::string &dataName,
                              std::vector<DataElement*> *elements) const;
 
-      std::set<DataElement*> *updatedElementsBackBuffer;
-      std::set<DataElement*> *updatedElementsFrontBuffer;
+      /// lock-free stack of updated elements linked by nextUpdated
+      DataElement * volatile updatedElements;
+      std::vector<DataElement*> dispatchElements;
+      mars::utils::ThreadPool dispatchPool;
+      volatile unsigned int dispatchThreads;
+      volatile long coalesceTime;
+      volatile int dispatcherSleeping;
+      volatile int wakeupPending; ///< guards against a signal per push
+      volatile int steppingTimers; ///< the wakeup is deferred to the end of a step
+      mars::utils::ThreadPool timerPool;
+      mars::utils::Mutex timerPoolMutex;
+      volatile unsigned int timerThreads;
 
       unsigned long next_id;
       pthread_t theThread;
@@ -308,20 +420,27 @@ namespace mars {
       LockableContainer<std::list<PendingTimedProducer> > pendingTimedProducers;
       LockableContainer<std::list<PendingTimedRegistration> > pendingTimedRegistrations;
       std::list<PendingTriggeredRegistration> pendingTriggeredRegistrations;
-      std::map<unsigned long, DataElement*> elementsById;
+      /// indexed by the dataId, ids that are not used are NULL
+      std::vector<DataElement*> elementsById;
       std::map<std::string, Trigger> triggers;
+      std::vector<Trigger*> triggersById;
       std::map<std::pair<std::string, std::string>, DataElement*> elementsByName;
       mutable mars::utils::ReadWriteLock elementsLock;
-      mars::utils::ReadWriteLock timersLock;
-      mars::utils::ReadWriteLock triggersLock;
-      mars::utils::Mutex updatedElementsLock;
+      mutable mars::utils::ReadWriteLock timersLock;
+      mutable mars::utils::ReadWriteLock triggersLock;
       mars::utils::Mutex pendingRegistrationLock;
 
       mars::utils::WaitCondition wakeupCondition;
       mars::utils::Mutex wakeupMutex;
       std::map<std::string, Timer> timers;
+      std::vector<Timer*> timersById;
       unsigned long newStreamId;
       unsigned long pushMessageIds[__DB_MESSAGE_TYPE_COUNT];
+      /// incremented when receivers or connections change
+      volatile unsigned long receiverRevision;
+      mutable mars::utils::Mutex timedReceiverLock;
+      /// receiverRevision of the DataElement::hasTimedReceivers flags
+      mutable unsigned long timedReceiverRevision;
     }; // end of class definition DataBroker
 
   } // end of namespace data_broker
@@ -151,6 +151,33 @@ namespace mars {
        */
       virtual bool stepTimer(const std::string &timerName, long step=1) = 0;
 
+      /**
+       * \brief advances the timer with the given id by step
+       * \param timerId The id of the timer as returned by \ref getTimerID.
+       * \param step The amount by which the timer should be stepped.
+       * \return \c true if the timer was stepped.
+       *         \c false if no timer with the id \a timerId exists.
+       *
+       * This is the same as \ref stepTimer(const std::string&, long) without
+       * looking up the name of the timer. Use it for timers that are stepped
+       * regularly. The default implementation has no ids and returns
+       * \c false.
+       */
+      virtual bool stepTimer(unsigned long /*timerId*/, long /*step*/=1) {
+        return false;
+      }
+
+      /**
+       * \brief get the id of the timer timerName
+       * \return The id of the timer or 0 if no timer with the name
+       *         \a timerName exists or the implementation has no ids. The
+       *         id is valid as long as the DataBroker exists.
+       * \see createTimer, stepTimer(unsigned long, long)
+       */
+      virtual unsigned long getTimerID(const std::string &/*timerName*/) const {
+        return 0;
+      }
+
       /**
        * \brief registers a receiver for a group/data with a timer
        * \param receiver The ReceiverInterface that should be called back.
@@ -256,6 +283,32 @@ namespace mars {
        */
       virtual bool trigger(const std::string &triggerName) = 0;
 
+      /**
+       * \brief triggers the trigger with the given id
+       * \param triggerId The id of the trigger as returned by
+       *                  \ref getTriggerID.
+       * \return \c true if the trigger was triggered.
+       *         \c false if no trigger with the id \a triggerId exists.
+       *
+       * This is the same as \ref trigger(const std::string&) without looking
+       * up the name of the trigger. The default implementation has no ids
+       * and returns \c false.
+       */
+      virtual bool trigger(unsigned long /*triggerId*/) {
+        return false;
+      }
+
+      /**
+       * \brief get the id of the trigger triggerName
+       * \return The id of the trigger or 0 if no trigger with the name
+       *         \a triggerName exists or the implementation has no ids. The
+       *         id is valid as long as the DataBroker exists.
+       * \see createTrigger, trigger(unsigned long)
+       */
+      virtual unsigned long getTriggerID(const std::string &/*triggerName*/) const {
+        return 0;
+      }
+
       /**
        * \brief registers a receiver for a group/data with a trigger
        * \param receiver The ReceiverInterface that should be called back.
@@ -524,6 +577,27 @@ namespace mars {
        * \return A copy of the DataPackage with the given \a dataId.
        */
       virtual const DataPackage getDataPackage(unsigned long dataId) const = 0;
+
+      /**
+       * \brief Returns \c true if a receiver is registered for the
+       *        DataPackage or if its items are connected to other packages.
+       *
+       * Producers use it to skip values nobody reads. Packages that are only
+       * read with getDataPackage() are not taken into account.
+       * \see getReceiverRevision
+       */
+      virtual bool hasReceivers(unsigned long /*dataId*/) const {
+        return true;
+      }
+
+      /**
+       * \brief Returns a number that changes whenever receivers or item
+       *        connections are added or removed. hasReceivers() only has to
+       *        be asked again if it changed.
+       */
+      virtual unsigned long getReceiverRevision() const {
+        return 0;
+      }
     
       /**
        * \brief get a list of all DataInfo items currently in the DataBroker
@@ -548,6 +622,27 @@ namespace mars {
                                        const std::string &toDataName,
                                        const std::string &toItemName) = 0;
 
+      /**
+       * \brief configures the thread that calls the asynchronous receivers
+       * \param numThreads The number of threads that call the receivers
+       *                   including the dispatch thread itself.
+       * \param coalesceTime The time in ms the dispatch thread waits after
+       *                     it was woken up to collect further data. With
+       *                     0 the receivers are called immediately.
+       * \see registerAsyncReceiver
+       */
+      virtual void setAsyncDispatch(unsigned int /*numThreads*/,
+                                    long /*coalesceTime*/) {}
+
+      /**
+       * \brief sets the number of threads that call the timed producers
+       *        of a timer step in parallel
+       * \param numThreads The number of threads including the thread that
+       *                   steps the timer.
+       * \see stepTimer, registerTimedProducer
+       */
+      virtual void setTimerThreads(unsigned int /*numThreads*/) {}
+
       virtual void pushMessage(MessageType messageType, 
                                const std::string &format, va_list args) = 0;
       virtual void pushMessage(MessageType messageType,
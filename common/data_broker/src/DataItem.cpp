@@ -19,13 +19,49 @@
  */
 
 #include "DataItem.h"
+#include <mars/utils/ReadWriteLock.h>
 #include <cstdio>
+#include <set>
 
 namespace mars {
 
   namespace data_broker {
 
-    DataItem::DataItem() {
+    static const std::string emptyName;
+
+    /**
+     * Returns the shared copy of \a name. The strings are never released,
+     * so the pointers stay valid and can be copied between threads. The
+     * set only holds the item names of the package layouts, thus its size
+     * is bounded by the names the producers use and not by the number of
+     * packages or elements. Known names are found under a read lock.
+     *
+     * The set lives until the static objects are destroyed at process
+     * exit. It is not owned by a DataBroker: items are named by producers
+     * before a broker sees them, and packages are copied between brokers
+     * and kept by plugins after a broker is deleted. Freeing the names
+     * with a broker would leave these items with dangling names.
+     */
+    static const std::string* internName(const std::string &name) {
+      static utils::ReadWriteLock lock;
+      static std::set<std::string> names;
+      std::set<std::string>::const_iterator it;
+      const std::string *result;
+
+      lock.lockForRead();
+      it = names.find(name);
+      result = (it != names.end()) ? &(*it) : NULL;
+      lock.unlock();
+      if(result) return result;
+
+      lock.lockForWrite();
+      // deep copy to avoid sharing the buffer with the caller
+      result = &(*names.insert(name.c_str()).first);
+      lock.unlock();
+      return result;
+    }
+
+    DataItem::DataItem() : type(UNDEFINED_TYPE), name(NULL) {
     }
     DataItem::~DataItem() {
     }
@@ -46,16 +82,22 @@ namespace mars {
         this->d = other.d;
       }
       this->type = other.type;
-      this->name = other.name.c_str();
+      this->name = other.name;
       return *this;
     }
 
+    void DataItem::assignValue(const DataItem &other) {
+      const std::string *oldName = name;
+      *this = other;
+      name = oldName;
+    }
+
     ////////////////////////////////////
     // Getter Methods
     ////////////////////////////////////
 
-    std::string DataItem::getName() const {
-      return name;
+    const std::string &DataItem::getName() const {
+      return name ? *name : emptyName;
     }
 
     bool DataItem::get(int *val) const {
@@ -128,7 +170,7 @@ namespace mars {
     ////////////////////////////////////
 
     void DataItem::setName(const std::string &newName) {
-      name = newName.c_str();
+      name = newName.empty() ? NULL : internName(newName);
     }
 
     bool DataItem::set(int val) {
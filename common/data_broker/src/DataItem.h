@@ -78,9 +78,26 @@ namespace mars {
       };
       std::string s;
 
-      std::string getName() const;
+      /**
+       * \brief returns the name of the item.
+       *
+       * The names are interned: all items with the same name share one
+       * string, so copying an item does not copy its name. The interned
+       * names are shared by all DataBrokers of the process and are kept
+       * until the process exits, so a name stays valid in every copy of
+       * an item. Item names should therefore be part of the layout of a
+       * package and not be generated per package, e.g. from a counter or
+       * a time stamp.
+       */
+      const std::string &getName() const;
       void setName(const std::string &newName);
 
+      /**
+       * \brief copies the type and value of \a other but keeps the name
+       *        of this item.
+       */
+      void assignValue(const DataItem &other);
+
       /**
        * \brief tries to retrieve the value from this DataItem
        * \param val A pointer to a variable where the value can be written to.
@@ -130,7 +147,7 @@ namespace mars {
       bool set(bool val);
 
     private:
-      std::string name;
+      const std::string *name;
 
     }; // end of class DataItem
 
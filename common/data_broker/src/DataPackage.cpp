@@ -69,6 +69,7 @@ namespace mars {
     }
 
     long DataPackage::getIndexByName(const std::string &itemName) const {
+      // the names are compared in place, getName() does not copy them
       std::vector<DataItem>::const_iterator it;
       long i = 0;
       for(it = package.begin(); it != package.end(); ++it, ++i) {
@@ -0,0 +1,425 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DataRecorder.h"
+#include "DataBrokerInterface.h"
+#include "DataPackage.h"
+#include "DataInfo.h"
+
+#include <mars/utils/MutexLocker.h>
+#include <mars/utils/misc.h>
+
+#include <cstring>
+
+#ifndef WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+#endif
+
+namespace mars {
+  namespace data_broker {
+
+    using namespace mars::utils;
+
+    size_t getRecordValueSize(DataType type) {
+      switch(type) {
+      case INT_TYPE:
+      case UINT_TYPE:
+      case FLOAT_TYPE:
+        return 4;
+      case LONG_TYPE:
+      case ULONG_TYPE:
+      case DOUBLE_TYPE:
+        return 8;
+      case BOOL_TYPE:
+        return 1;
+      default:
+        return 0;
+      }
+    }
+
+    static void appendBytes(std::vector<char> *column, const void *data,
+                            size_t size) {
+      const char *bytes = (const char*)data;
+      column->insert(column->end(), bytes, bytes+size);
+    }
+
+    static void appendValue(std::vector<char> *column, const DataItem &item) {
+      switch(item.type) {
+      case INT_TYPE:
+        appendBytes(column, &item.i, 4);
+        break;
+      case UINT_TYPE:
+        appendBytes(column, &item.ui, 4);
+        break;
+      case FLOAT_TYPE:
+        appendBytes(column, &item.f, 4);
+        break;
+      case DOUBLE_TYPE:
+        appendBytes(column, &item.d, 8);
+        break;
+      case LONG_TYPE: {
+        long long value = item.l;
+        appendBytes(column, &value, 8);
+        break;
+      }
+      case ULONG_TYPE: {
+        unsigned long long value = item.ul;
+        appendBytes(column, &value, 8);
+        break;
+      }
+      case BOOL_TYPE: {
+        char value = item.b;
+        appendBytes(column, &value, 1);
+        break;
+      }
+      case STRING_TYPE: {
+        unsigned int length = item.s.size();
+        appendBytes(column, &length, 4);
+        appendBytes(column, item.s.data(), length);
+        break;
+      }
+      default:
+        break;
+      }
+    }
+
+    DataRecorder::DataRecorder(DataBrokerInterface *dataBroker)
+      : dataBroker(dataBroker), recording(false), stopWriter(false),
+        startTime(0), nextStreamIndex(0), fd(-1), map(NULL), mapOffset(0),
+        mapPos(0), fileSize(0) {
+    }
+
+    DataRecorder::~DataRecorder() {
+      std::list<RecordStream*>::iterator it;
+      close();
+      for(it=allStreams.begin(); it!=allStreams.end(); ++it) {
+        delete *it;
+      }
+      while(!freeBlocks.empty()) {
+        delete freeBlocks.front();
+        freeBlocks.pop_front();
+      }
+    }
+
+    bool DataRecorder::open(const std::string &filename) {
+      std::vector<std::pair<std::string, std::string> >::iterator it;
+      close();
+#ifdef WIN32
+      dataBroker->pushError("DataRecorder: memory mapped logs are not supported");
+      return false;
+#else
+      fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if(fd < 0) {
+        dataBroker->pushError("DataRecorder: could not create \"%s\"",
+                              filename.c_str());
+        return false;
+      }
+      map = NULL;
+      mapOffset = mapPos = fileSize = 0;
+      writeBytes(DATA_RECORD_MAGIC, 8);
+
+      // the schemas are written again for the new file
+      streamsLock.lockForWrite();
+      for(std::list<RecordStream*>::iterator streamIt = allStreams.begin();
+          streamIt != allStreams.end(); ++streamIt) {
+        (*streamIt)->headerWritten = false;
+      }
+      streamsLock.unlock();
+
+      startTime = getTimeMicro();
+      stopWriter = false;
+      recording = true;
+      start();
+      for(it=patterns.begin(); it!=patterns.end(); ++it) {
+        dataBroker->registerSyncReceiver(this, it->first, it->second);
+      }
+      return true;
+#endif
+    }
+
+    void DataRecorder::addPattern(const std::string &groupName,
+                                  const std::string &dataName) {
+      patterns.push_back(std::make_pair(groupName, dataName));
+      if(recording) {
+        dataBroker->registerSyncReceiver(this, groupName, dataName);
+      }
+    }
+
+    void DataRecorder::close() {
+      std::vector<std::pair<std::string, std::string> >::iterator it;
+      std::list<RecordStream*>::iterator streamIt;
+      if(!recording) return;
+
+      for(it=patterns.begin(); it!=patterns.end(); ++it) {
+        dataBroker->unregisterSyncReceiver(this, it->first, it->second);
+      }
+
+      // a push might still be in receiveData, it checks the flag under
+      // the lock of the stream
+      streamsLock.lockForRead();
+      for(streamIt=allStreams.begin(); streamIt!=allStreams.end(); ++streamIt) {
+        RecordStream *stream = *streamIt;
+        stream->mutex.lock();
+        recording = false;
+        if(stream->block) {
+          queueBlock(stream->block);
+          stream->block = NULL;
+        }
+        stream->mutex.unlock();
+      }
+      streamsLock.unlock();
+
+      blockMutex.lock();
+      recording = false;
+      stopWriter = true;
+      blockCondition.wakeAll();
+      blockMutex.unlock();
+      wait();
+
+#ifndef WIN32
+      if(map) {
+        munmap(map, DATA_RECORD_CHUNK_SIZE);
+        map = NULL;
+      }
+      // cut the unused rest of the last chunk
+      if(ftruncate(fd, fileSize) != 0) {
+        dataBroker->pushError("DataRecorder: could not truncate the log");
+      }
+      ::close(fd);
+      fd = -1;
+#endif
+    }
+
+    bool DataRecorder::isRecording() const {
+      return recording;
+    }
+
+    void DataRecorder::receiveData(const DataInfo &info,
+                                   const DataPackage &package,
+                                   int callbackParam) {
+      RecordStream *stream;
+      RecordBlock *block;
+      long long time = getTimeMicro() - startTime;
+
+      if(!recording) return;
+      stream = getStream(info, package);
+
+      MutexLocker locker(&stream->mutex);
+      if(!recording) return;
+      // skip packages whose layout changed
+      if(package.size() != stream->itemTypes.size()) return;
+      for(size_t i=0; i<package.size(); ++i) {
+        if(package[i].type != stream->itemTypes[i]) return;
+      }
+
+      block = stream->block;
+      if(!block) {
+        block = stream->block = getBlock(stream);
+      }
+      block->times.push_back(time);
+      for(size_t i=0; i<package.size(); ++i) {
+        appendValue(&block->columns[i], package[i]);
+      }
+      if(++block->rows == DATA_RECORD_BLOCK_ROWS) {
+        stream->block = NULL;
+        queueBlock(block);
+      }
+    }
+
+    RecordStream* DataRecorder::getStream(const DataInfo &info,
+                                          const DataPackage &package) {
+      std::map<unsigned long, RecordStream*>::iterator it;
+      RecordStream *stream = NULL;
+
+      streamsLock.lockForRead();
+      it = streams.find(info.dataId);
+      if(it != streams.end()) stream = it->second;
+      streamsLock.unlock();
+      if(stream) return stream;
+
+      streamsLock.lockForWrite();
+      it = streams.find(info.dataId);
+      if(it != streams.end()) {
+        stream = it->second;
+      } else {
+        // the schema is taken from the first package of the stream
+        stream = new RecordStream;
+        stream->index = nextStreamIndex++;
+        stream->groupName = info.groupName;
+        stream->dataName = info.dataName;
+        for(size_t i=0; i<package.size(); ++i) {
+          stream->itemNames.push_back(package[i].getName());
+          stream->itemTypes.push_back(package[i].type);
+        }
+        stream->headerWritten = false;
+        stream->block = NULL;
+        streams[info.dataId] = stream;
+        allStreams.push_back(stream);
+      }
+      streamsLock.unlock();
+      return stream;
+    }
+
+    RecordBlock* DataRecorder::getBlock(RecordStream *stream) {
+      RecordBlock *block = NULL;
+      size_t size;
+      blockMutex.lock();
+      if(!freeBlocks.empty()) {
+        block = freeBlocks.front();
+        freeBlocks.pop_front();
+      }
+      blockMutex.unlock();
+      if(!block) block = new RecordBlock;
+
+      block->stream = stream;
+      block->rows = 0;
+      block->times.clear();
+      block->times.reserve(DATA_RECORD_BLOCK_ROWS);
+      block->columns.resize(stream->itemTypes.size());
+      for(size_t i=0; i<block->columns.size(); ++i) {
+        size = getRecordValueSize(stream->itemTypes[i]);
+        block->columns[i].clear();
+        block->columns[i].reserve(DATA_RECORD_BLOCK_ROWS * (size ? size : 16));
+      }
+      return block;
+    }
+
+    void DataRecorder::queueBlock(RecordBlock *block) {
+      MutexLocker locker(&blockMutex);
+      fullBlocks.push_back(block);
+      blockCondition.wakeOne();
+    }
+
+    void DataRecorder::run() {
+      RecordBlock *block;
+      blockMutex.lock();
+      while(true) {
+        while(fullBlocks.empty() && !stopWriter) {
+          blockCondition.wait(&blockMutex);
+        }
+        // the recording is closed and all blocks are written
+        if(fullBlocks.empty()) break;
+        block = fullBlocks.front();
+        fullBlocks.pop_front();
+        blockMutex.unlock();
+        if(block->rows > 0) writeBlock(block);
+        blockMutex.lock();
+        freeBlocks.push_back(block);
+      }
+      blockMutex.unlock();
+    }
+
+    void DataRecorder::writeStream(const RecordStream *stream) {
+      unsigned int size = 4 + 4 + stream->groupName.size() +
+        4 + stream->dataName.size() + 4;
+      for(size_t i=0; i<stream->itemNames.size(); ++i) {
+        size += 4 + stream->itemNames[i].size() + 4;
+      }
+      writeUInt(DATA_RECORD_STREAM);
+      writeUInt(size);
+      writeUInt(stream->index);
+      writeString(stream->groupName);
+      writeString(stream->dataName);
+      writeUInt(stream->itemNames.size());
+      for(size_t i=0; i<stream->itemNames.size(); ++i) {
+        writeString(stream->itemNames[i]);
+        writeUInt(stream->itemTypes[i]);
+      }
+    }
+
+    void DataRecorder::writeBlock(const RecordBlock *block) {
+      RecordStream *stream = block->stream;
+      unsigned int size = 4 + 4 + block->rows*8;
+      // the stream is only written by this thread
+      if(!stream->headerWritten) {
+        writeStream(stream);
+        stream->headerWritten = true;
+      }
+      for(size_t i=0; i<block->columns.size(); ++i) {
+        size += block->columns[i].size();
+      }
+      writeUInt(DATA_RECORD_BLOCK);
+      writeUInt(size);
+      writeUInt(stream->index);
+      writeUInt(block->rows);
+      writeBytes(&block->times[0], block->rows*8);
+      for(size_t i=0; i<block->columns.size(); ++i) {
+        if(!block->columns[i].empty()) {
+          writeBytes(&block->columns[i][0], block->columns[i].size());
+        }
+      }
+    }
+
+    void DataRecorder::writeUInt(unsigned int value) {
+      writeBytes(&value, 4);
+    }
+
+    void DataRecorder::writeString(const std::string &value) {
+      writeUInt(value.size());
+      writeBytes(value.data(), value.size());
+    }
+
+    void DataRecorder::writeBytes(const void *data, size_t size) {
+      const char *bytes = (const char*)data;
+      size_t n;
+      while(size > 0) {
+        if(!map || mapPos == DATA_RECORD_CHUNK_SIZE) {
+          if(!mapChunk()) return;
+        }
+        n = DATA_RECORD_CHUNK_SIZE - mapPos;
+        if(n > size) n = size;
+        memcpy(map+mapPos, bytes, n);
+        mapPos += n;
+        fileSize += n;
+        bytes += n;
+        size -= n;
+      }
+    }
+
+    bool DataRecorder::mapChunk() {
+#ifdef WIN32
+      return false;
+#else
+      void *region;
+      if(map) {
+        munmap(map, DATA_RECORD_CHUNK_SIZE);
+        map = NULL;
+        mapOffset += DATA_RECORD_CHUNK_SIZE;
+      }
+      mapPos = 0;
+      if(ftruncate(fd, mapOffset + DATA_RECORD_CHUNK_SIZE) != 0) {
+        dataBroker->pushError("DataRecorder: could not grow the log");
+        return false;
+      }
+      region = mmap(NULL, DATA_RECORD_CHUNK_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, mapOffset);
+      if(region == MAP_FAILED) {
+        dataBroker->pushError("DataRecorder: could not map the log");
+        return false;
+      }
+      map = (char*)region;
+      return true;
+#endif
+    }
+
+  } // end of namespace data_broker
+} // end of namespace mars
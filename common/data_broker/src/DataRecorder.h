@@ -0,0 +1,180 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file DataRecorder.h
+ * \brief "DataRecorder" writes DataBroker streams into a binary log.
+ *
+ * The log starts with the magic "MARSDBR1" followed by records. Every
+ * record starts with its type and the size of the rest of the record as
+ * uint32. All values are stored in host byte order, a string is stored as
+ * uint32 length followed by the characters.
+ *
+ * - RECORD_STREAM: uint32 stream, string groupName, string dataName,
+ *   uint32 number of items and for every item its string name and its
+ *   uint32 DataType. It is written once before the first block of the
+ *   stream.
+ * - RECORD_BLOCK: uint32 stream, uint32 rows, rows int64 times in
+ *   microseconds since the start of the recording and then for every item
+ *   the column of its rows values. The values are stored with their
+ *   natural size, strings as in the header.
+ *
+ * The packages are copied into the column blocks in the thread of the
+ * producer. Full blocks are written by a background thread into the
+ * memory mapped file which is grown chunk by chunk.
+ */
+
+#ifndef DATA_RECORDER_H
+#define DATA_RECORDER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "DataRecorder.h"
+#endif
+
+#include "ReceiverInterface.h"
+#include "DataItem.h"
+
+#include <mars/utils/Thread.h>
+#include <mars/utils/Mutex.h>
+#include <mars/utils/ReadWriteLock.h>
+#include <mars/utils/WaitCondition.h>
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+
+#define DATA_RECORD_MAGIC "MARSDBR1"
+#define DATA_RECORD_STREAM 1
+#define DATA_RECORD_BLOCK 2
+// number of rows collected per block of a stream
+#define DATA_RECORD_BLOCK_ROWS 256
+// size of the file regions that are mapped at once
+#define DATA_RECORD_CHUNK_SIZE (16*1024*1024)
+
+namespace mars {
+
+  namespace data_broker {
+
+    class DataBrokerInterface;
+
+    /**
+     * \brief Returns the size of a value of the given type in a log or 0
+     *        for strings and unknown types.
+     */
+    size_t getRecordValueSize(DataType type);
+
+    /// \cond HIDDEN_SYMBOLS
+    struct RecordStream;
+
+    struct RecordBlock {
+      RecordStream *stream;
+      unsigned int rows;
+      std::vector<long long> times;
+      std::vector<std::vector<char> > columns;
+    };
+
+    struct RecordStream {
+      unsigned int index;
+      std::string groupName, dataName;
+      std::vector<std::string> itemNames;
+      std::vector<DataType> itemTypes;
+      bool headerWritten;
+      RecordBlock *block;
+      utils::Mutex mutex;
+    };
+    /// \endcond
+
+    class DataRecorder : public ReceiverInterface,
+                         public utils::Thread {
+    public:
+      DataRecorder(DataBrokerInterface *dataBroker);
+      ~DataRecorder();
+
+      /**
+       * \brief Creates the log file and starts the writer thread.
+       * \return \c false if the file could not be created.
+       */
+      bool open(const std::string &filename);
+
+      /**
+       * \brief Records the streams matching the patterns. The names may
+       *        contain wildcards. Streams that are created later are
+       *        recorded as well.
+       */
+      void addPattern(const std::string &groupName,
+                      const std::string &dataName);
+
+      /**
+       * \brief Stops the recording, writes the pending blocks and closes
+       *        the file.
+       */
+      void close();
+
+      bool isRecording() const;
+
+      void receiveData(const DataInfo &info, const DataPackage &package,
+                       int callbackParam);
+
+    protected:
+      void run();
+
+    private:
+      // disallow copying
+      DataRecorder(const DataRecorder &);
+      DataRecorder &operator=(const DataRecorder &);
+
+      RecordStream* getStream(const DataInfo &info,
+                              const DataPackage &package);
+      RecordBlock* getBlock(RecordStream *stream);
+      void queueBlock(RecordBlock *block);
+      void writeStream(const RecordStream *stream);
+      void writeBlock(const RecordBlock *block);
+      void writeBytes(const void *data, size_t size);
+      void writeUInt(unsigned int value);
+      void writeString(const std::string &value);
+      bool mapChunk();
+
+      DataBrokerInterface *dataBroker;
+      std::vector<std::pair<std::string, std::string> > patterns;
+      std::map<unsigned long, RecordStream*> streams;
+      std::list<RecordStream*> allStreams;
+      mutable utils::ReadWriteLock streamsLock;
+
+      // blocks to write and blocks to reuse
+      std::list<RecordBlock*> fullBlocks, freeBlocks;
+      utils::Mutex blockMutex;
+      utils::WaitCondition blockCondition;
+
+      volatile bool recording;
+      bool stopWriter; ///< guarded by blockMutex
+      long long startTime;
+      unsigned int nextStreamIndex;
+
+      // the mapped file, only used by the writer thread
+      int fd;
+      char *map;
+      size_t mapOffset, mapPos, fileSize;
+    };
+
+  } // end of namespace data_broker
+} // end of namespace mars
+
+#endif  // DATA_RECORDER_H
@@ -0,0 +1,341 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DataReplayer.h"
+#include "DataRecorder.h"
+#include "DataBrokerInterface.h"
+
+#include <mars/utils/misc.h>
+
+#include <cstring>
+#include <queue>
+#include <functional>
+
+#ifndef WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+namespace mars {
+  namespace data_broker {
+
+    using namespace mars::utils;
+
+    static void sleepMicro(long long microseconds) {
+#ifdef WIN32
+      msleep((unsigned int)((microseconds+999)/1000));
+#else
+      ::usleep((useconds_t)microseconds);
+#endif
+    }
+
+    // the values in the log are not aligned
+    static unsigned int readUInt(const char *data) {
+      unsigned int value;
+      memcpy(&value, data, 4);
+      return value;
+    }
+
+    static std::string readString(const char **data) {
+      unsigned int length = readUInt(*data);
+      std::string value(*data+4, length);
+      *data += 4 + length;
+      return value;
+    }
+
+    static long long getRowTime(const ReplayStream *stream) {
+      long long time;
+      memcpy(&time, stream->times + stream->row*8, 8);
+      return time;
+    }
+
+    DataReplayer::DataReplayer(DataBrokerInterface *dataBroker)
+      : dataBroker(dataBroker), speed(1.0), stopReplay(false), map(NULL),
+        mapSize(0), fd(-1) {
+    }
+
+    DataReplayer::~DataReplayer() {
+      close();
+    }
+
+    bool DataReplayer::open(const std::string &filename) {
+      close();
+#ifdef WIN32
+      dataBroker->pushError("DataReplayer: memory mapped logs are not supported");
+      return false;
+#else
+      struct stat fileStat;
+      void *region;
+      fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd < 0) {
+        dataBroker->pushError("DataReplayer: could not open \"%s\"",
+                              filename.c_str());
+        return false;
+      }
+      if(fstat(fd, &fileStat) != 0 || fileStat.st_size < 8) {
+        dataBroker->pushError("DataReplayer: \"%s\" is not a log",
+                              filename.c_str());
+        close();
+        return false;
+      }
+      mapSize = fileStat.st_size;
+      region = mmap(NULL, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(region == MAP_FAILED) {
+        dataBroker->pushError("DataReplayer: could not map \"%s\"",
+                              filename.c_str());
+        close();
+        return false;
+      }
+      map = (const char*)region;
+      if(memcmp(map, DATA_RECORD_MAGIC, 8) != 0) {
+        dataBroker->pushError("DataReplayer: \"%s\" is not a log",
+                              filename.c_str());
+        close();
+        return false;
+      }
+      return readStreams();
+#endif
+    }
+
+    void DataReplayer::close() {
+      stop();
+      for(size_t i=0; i<streams.size(); ++i) {
+        delete streams[i];
+      }
+      streams.clear();
+#ifndef WIN32
+      if(map) {
+        munmap((void*)map, mapSize);
+        map = NULL;
+      }
+      if(fd >= 0) {
+        ::close(fd);
+        fd = -1;
+      }
+#endif
+      mapSize = 0;
+    }
+
+    bool DataReplayer::readStreams() {
+      size_t pos = 8;
+      unsigned int type, size, index, numItems;
+      const char *record;
+
+      while(pos + 8 <= mapSize) {
+        type = readUInt(map+pos);
+        size = readUInt(map+pos+4);
+        pos += 8;
+        if(pos + size > mapSize) {
+          // the recording was not closed
+          dataBroker->pushWarning("DataReplayer: the log is truncated");
+          break;
+        }
+        record = map+pos;
+        index = readUInt(record);
+        if(type == DATA_RECORD_STREAM) {
+          ReplayStream *stream = new ReplayStream;
+          record += 4;
+          stream->groupName = readString(&record);
+          stream->dataName = readString(&record);
+          numItems = readUInt(record);
+          record += 4;
+          for(unsigned int i=0; i<numItems; ++i) {
+            std::string name = readString(&record);
+            DataType itemType = (DataType)readUInt(record);
+            record += 4;
+            stream->itemTypes.push_back(itemType);
+            switch(itemType) {
+            case INT_TYPE: stream->package.add(name, (int)0); break;
+            case UINT_TYPE: stream->package.add(name, (unsigned int)0); break;
+            case LONG_TYPE: stream->package.add(name, (long)0); break;
+            case ULONG_TYPE: stream->package.add(name, (unsigned long)0); break;
+            case FLOAT_TYPE: stream->package.add(name, 0.0f); break;
+            case DOUBLE_TYPE: stream->package.add(name, 0.0); break;
+            case BOOL_TYPE: stream->package.add(name, false); break;
+            case STRING_TYPE: stream->package.add(name, std::string()); break;
+            default: break;
+            }
+          }
+          stream->dataId = 0;
+          stream->block = 0;
+          stream->row = 0;
+          stream->times = NULL;
+          if(index >= streams.size()) streams.resize(index+1, NULL);
+          delete streams[index];
+          streams[index] = stream;
+        } else if(type == DATA_RECORD_BLOCK) {
+          if(index < streams.size() && streams[index]) {
+            ReplayBlock block = { record+8, readUInt(record+4) };
+            streams[index]->blocks.push_back(block);
+          }
+        }
+        pos += size;
+      }
+      return true;
+    }
+
+    void DataReplayer::setSpeed(double speed) {
+      this->speed = speed;
+    }
+
+    void DataReplayer::play() {
+      stop();
+      stopReplay = false;
+      start();
+    }
+
+    void DataReplayer::stop() {
+      if(isRunning()) {
+        stopReplay = true;
+        wait();
+      }
+    }
+
+    bool DataReplayer::isPlaying() const {
+      return isRunning();
+    }
+
+    size_t DataReplayer::getNumStreams() const {
+      return streams.size();
+    }
+
+    void DataReplayer::seekBlock(ReplayStream *stream, size_t block) {
+      const char *column;
+      size_t size;
+      stream->block = block;
+      stream->row = 0;
+      if(block >= stream->blocks.size()) return;
+
+      const ReplayBlock &replayBlock = stream->blocks[block];
+      stream->times = replayBlock.data;
+      column = replayBlock.data + replayBlock.rows*8;
+      stream->columns.resize(stream->itemTypes.size());
+      for(size_t i=0; i<stream->itemTypes.size(); ++i) {
+        stream->columns[i] = column;
+        size = getRecordValueSize(stream->itemTypes[i]);
+        if(size) {
+          column += size*replayBlock.rows;
+        } else {
+          // skip the strings of the column
+          for(unsigned int row=0; row<replayBlock.rows; ++row) {
+            column += 4 + readUInt(column);
+          }
+        }
+      }
+    }
+
+    void DataReplayer::readRow(ReplayStream *stream) {
+      DataPackage &package = stream->package;
+      for(size_t i=0; i<stream->itemTypes.size(); ++i) {
+        const char *&column = stream->columns[i];
+        DataItem &item = package[i];
+        switch(stream->itemTypes[i]) {
+        case INT_TYPE:
+          memcpy(&item.i, column, 4);
+          break;
+        case UINT_TYPE:
+          memcpy(&item.ui, column, 4);
+          break;
+        case FLOAT_TYPE:
+          memcpy(&item.f, column, 4);
+          break;
+        case DOUBLE_TYPE:
+          memcpy(&item.d, column, 8);
+          break;
+        case LONG_TYPE: {
+          long long value;
+          memcpy(&value, column, 8);
+          item.l = value;
+          break;
+        }
+        case ULONG_TYPE: {
+          unsigned long long value;
+          memcpy(&value, column, 8);
+          item.ul = value;
+          break;
+        }
+        case BOOL_TYPE:
+          item.b = (*column != 0);
+          break;
+        case STRING_TYPE:
+          item.s.assign(column+4, readUInt(column));
+          column += 4 + item.s.size();
+          break;
+        default:
+          break;
+        }
+        column += getRecordValueSize(stream->itemTypes[i]);
+      }
+      if(++stream->row == stream->blocks[stream->block].rows) {
+        seekBlock(stream, stream->block+1);
+      }
+    }
+
+    void DataReplayer::run() {
+      typedef std::pair<long long, size_t> QueueEntry;
+      std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                          std::greater<QueueEntry> > queue;
+      ReplayStream *stream;
+      long long time, delay, startTime;
+      double factor = speed;
+
+      for(size_t i=0; i<streams.size(); ++i) {
+        if(!streams[i]) continue;
+        seekBlock(streams[i], 0);
+        if(!streams[i]->blocks.empty()) {
+          queue.push(QueueEntry(getRowTime(streams[i]), i));
+        }
+      }
+
+      // merge the streams by the time of their next row
+      startTime = getTimeMicro();
+      while(!queue.empty() && !stopReplay) {
+        time = queue.top().first;
+        stream = streams[queue.top().second];
+        if(factor > 0) {
+          delay = startTime + (long long)(time/factor) - getTimeMicro();
+          // wake up at least every 100 ms to react to stop()
+          while(delay > 0 && !stopReplay) {
+            sleepMicro(delay > 100000 ? 100000 : delay);
+            delay = startTime + (long long)(time/factor) - getTimeMicro();
+          }
+        }
+        readRow(stream);
+        if(stream->dataId) {
+          dataBroker->pushData(stream->dataId, stream->package);
+        } else {
+          stream->dataId = dataBroker->pushData(stream->groupName,
+                                                stream->dataName,
+                                                stream->package, NULL,
+                                                DATA_PACKAGE_READ_FLAG);
+        }
+        QueueEntry entry = queue.top();
+        queue.pop();
+        if(stream->block < stream->blocks.size()) {
+          entry.first = getRowTime(stream);
+          queue.push(entry);
+        }
+      }
+    }
+
+  } // end of namespace data_broker
+} // end of namespace mars
@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file DataReplayer.h
+ * \brief "DataReplayer" pushes the streams of a log written by the
+ *        DataRecorder back into a DataBroker.
+ *
+ * The log is mapped read-only. The packages of all streams are merged by
+ * their time stamps and pushed under their original names.
+ */
+
+#ifndef DATA_REPLAYER_H
+#define DATA_REPLAYER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "DataReplayer.h"
+#endif
+
+#include "DataPackage.h"
+#include "DataItem.h"
+
+#include <mars/utils/Thread.h>
+
+#include <string>
+#include <vector>
+
+namespace mars {
+
+  namespace data_broker {
+
+    class DataBrokerInterface;
+
+    /// \cond HIDDEN_SYMBOLS
+    struct ReplayBlock {
+      const char *data; ///< times followed by the columns
+      unsigned int rows;
+    };
+
+    struct ReplayStream {
+      std::string groupName, dataName;
+      std::vector<DataType> itemTypes;
+      std::vector<ReplayBlock> blocks;
+      DataPackage package;
+      unsigned long dataId;
+      // read position
+      size_t block;
+      unsigned int row;
+      const char *times; ///< unaligned int64 values
+      std::vector<const char*> columns;
+    };
+    /// \endcond
+
+    class DataReplayer : public utils::Thread {
+    public:
+      DataReplayer(DataBrokerInterface *dataBroker);
+      ~DataReplayer();
+
+      /**
+       * \brief Maps the log and reads its streams.
+       * \return \c false if the file is not a valid log.
+       */
+      bool open(const std::string &filename);
+      void close();
+
+      /**
+       * \brief Sets the replay rate relative to the recording. With 1 the
+       *        packages are pushed at their original rate, with 0 or less
+       *        as fast as possible. The speed is used from the next
+       *        play() on.
+       */
+      void setSpeed(double speed);
+
+      /**
+       * \brief Starts pushing the packages from the beginning of the log.
+       */
+      void play();
+      void stop();
+      bool isPlaying() const;
+
+      size_t getNumStreams() const;
+
+    protected:
+      void run();
+
+    private:
+      // disallow copying
+      DataReplayer(const DataReplayer &);
+      DataReplayer &operator=(const DataReplayer &);
+
+      bool readStreams();
+      void seekBlock(ReplayStream *stream, size_t block);
+      void readRow(ReplayStream *stream);
+
+      DataBrokerInterface *dataBroker;
+      std::vector<ReplayStream*> streams;
+      volatile double speed;
+      volatile bool stopReplay;
+      const char *map;
+      size_t mapSize;
+      int fd;
+    };
+
+  } // end of namespace data_broker
+} // end of namespace mars
+
+#endif  // DATA_REPLAYER_H
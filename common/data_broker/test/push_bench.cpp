@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file push_bench.cpp
+ * \brief Measures the pushes per second of DataBroker::pushData for 1, 4
+ *        and 16 producer threads.
+ *
+ * Every thread pushes its own streams, every stream has a synchronous
+ * receiver that counts the packages. The test fails if a package is lost.
+ * The number of pushes per thread can be given as first argument.
+ */
+
+#include "DataBroker.h"
+#include "DataPackage.h"
+#include "ReceiverInterface.h"
+
+#include <mars/utils/Thread.h>
+#include <mars/utils/misc.h>
+#include <lib_manager/LibManager.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace mars::data_broker;
+using namespace mars::utils;
+
+static const int streamsPerThread = 8;
+
+class CountingReceiver : public ReceiverInterface {
+public:
+  CountingReceiver() : count(0) {}
+  void receiveData(const DataInfo &info, const DataPackage &package,
+                   int callbackParam) {
+    __sync_fetch_and_add(&count, 1);
+  }
+  long count;
+};
+
+class PushThread : public Thread {
+public:
+  PushThread(DataBroker *dataBroker, int index, long numPushes)
+    : dataBroker(dataBroker), numPushes(numPushes) {
+    char name[32];
+    // the package of a node: position, rotation and velocities
+    for(int i=0; i<13; ++i) {
+      sprintf(name, "value%d", i);
+      package.add(name, 0.0);
+    }
+    for(int i=0; i<streamsPerThread; ++i) {
+      sprintf(name, "thread%d/stream%d", index, i);
+      names.push_back(name);
+      ids.push_back(dataBroker->pushData("bench", name, package, NULL,
+                                         DATA_PACKAGE_READ_FLAG));
+    }
+  }
+
+  void registerReceiver(ReceiverInterface *receiver) {
+    for(size_t i=0; i<names.size(); ++i) {
+      dataBroker->registerSyncReceiver(receiver, "bench", names[i]);
+    }
+  }
+
+protected:
+  void run() {
+    for(long i=0; i<numPushes; ++i) {
+      package[0].d = (double)i;
+      dataBroker->pushData(ids[i % ids.size()], package);
+    }
+  }
+
+private:
+  DataBroker *dataBroker;
+  long numPushes;
+  DataPackage package;
+  std::vector<std::string> names;
+  std::vector<unsigned long> ids;
+};
+
+static bool runBench(int numThreads, long numPushes) {
+  lib_manager::LibManager libManager;
+  DataBroker *dataBroker = new DataBroker(&libManager);
+  CountingReceiver receiver;
+  std::vector<PushThread*> threads;
+  long long startTime, time;
+  long expected = numThreads * numPushes;
+  bool ok;
+
+  for(int i=0; i<numThreads; ++i) {
+    threads.push_back(new PushThread(dataBroker, i, numPushes));
+    threads.back()->registerReceiver(&receiver);
+  }
+  startTime = getTimeMicro();
+  for(int i=0; i<numThreads; ++i) {
+    threads[i]->start();
+  }
+  for(int i=0; i<numThreads; ++i) {
+    threads[i]->wait();
+    delete threads[i];
+  }
+  time = getTimeMicro() - startTime;
+  ok = (receiver.count == expected);
+  printf("%2d producer threads: %ld pushes in %lld us, %.0f pushes/s%s\n",
+         numThreads, expected, time,
+         time > 0 ? expected*1000000.0/time : 0.0,
+         ok ? "" : " (packages lost)");
+  delete dataBroker;
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  long numPushes = 100000;
+  bool ok = true;
+
+  if(argc > 1) {
+    numPushes = atol(argv[1]);
+  }
+  ok &= runBench(1, numPushes);
+  ok &= runBench(4, numPushes);
+  ok &= runBench(16, numPushes);
+  return ok ? 0 : 1;
+}
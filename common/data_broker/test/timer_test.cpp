@@ -0,0 +1,148 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file timer_test.cpp
+ * \brief Checks the parallel timed producers of DataBroker::stepTimer.
+ *
+ * The producers of a timer are called on a pool of four threads. The
+ * test checks that every producer is called once per period, that the
+ * synchronous receivers get the packages in the order of the producers
+ * and that the latency of the steps is published under
+ * "data_broker/timers/<timer>/latency".
+ */
+
+#include "DataBroker.h"
+#include "DataPackage.h"
+#include "ProducerInterface.h"
+#include "ReceiverInterface.h"
+
+#include <lib_manager/LibManager.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace mars::data_broker;
+
+static const int numProducers = 64;
+static const long numSteps = 100;
+
+class CountingProducer : public ProducerInterface {
+public:
+  CountingProducer() : count(0) {}
+  void produceData(const DataInfo &info, DataPackage *package,
+                   int callbackParam) {
+    ++count;
+    if(package->size() == 0) {
+      package->add("id", callbackParam);
+      package->add("count", count);
+    }
+    else {
+      package->set(0, callbackParam);
+      package->set(1, count);
+    }
+  }
+  long count;
+};
+
+class OrderReceiver : public ReceiverInterface {
+public:
+  void receiveData(const DataInfo &info, const DataPackage &package,
+                   int callbackParam) {
+    int id;
+    long count;
+    package.get(0, &id);
+    package.get(1, &count);
+    ids.push_back(id);
+    counts.push_back(count);
+  }
+  std::vector<int> ids;
+  std::vector<long> counts;
+};
+
+int main(int argc, char *argv[]) {
+  lib_manager::LibManager libManager;
+  DataBroker *dataBroker = new DataBroker(&libManager);
+  std::vector<CountingProducer> producers(numProducers);
+  OrderReceiver receiver;
+  DataPackage package;
+  std::vector<int> expectedIds;
+  std::vector<long> expectedCounts;
+  unsigned long latencyId;
+  long latencyCount = 0;
+  bool ok = true;
+  char name[32];
+
+  dataBroker->setTimerThreads(4);
+  dataBroker->createTimer("test_timer");
+  for(int i=0; i<numProducers; ++i) {
+    sprintf(name, "producer%d", i);
+    // every second producer is due every other step, the first call is
+    // in the first step
+    dataBroker->registerTimedProducer(&producers[i], "test", name,
+                                      "test_timer", 1 + i%2, i);
+    dataBroker->registerSyncReceiver(&receiver, "test", name);
+  }
+
+  for(long step=1; step<=numSteps; ++step) {
+    dataBroker->stepTimer("test_timer");
+    for(int i=0; i<numProducers; ++i) {
+      if(i%2 == 0 || step%2 == 0 || step == 1) {
+        expectedIds.push_back(i);
+        expectedCounts.push_back(i%2 ? 1 + step/2 : step);
+      }
+    }
+  }
+
+  for(int i=0; i<numProducers; ++i) {
+    if(producers[i].count != (i%2 ? 1 + numSteps/2 : numSteps)) {
+      printf("producer %d was called %ld times\n", i, producers[i].count);
+      ok = false;
+    }
+  }
+  if(receiver.ids != expectedIds || receiver.counts != expectedCounts) {
+    printf("the receiver got %lu packages out of order, expected %lu\n",
+           (unsigned long)receiver.ids.size(),
+           (unsigned long)expectedIds.size());
+    ok = false;
+  }
+
+  latencyId = dataBroker->getDataID("data_broker",
+                                    "timers/test_timer/latency");
+  if(latencyId) {
+    package = dataBroker->getDataPackage(latencyId);
+    package.get("count", &latencyCount);
+  }
+  if(latencyCount != numSteps) {
+    printf("the latency histogram has %ld steps\n", latencyCount);
+    ok = false;
+  }
+
+  for(int i=0; i<numProducers; ++i) {
+    sprintf(name, "producer%d", i);
+    dataBroker->unregisterSyncReceiver(&receiver, "test", name);
+    dataBroker->unregisterTimedProducer(&producers[i], "test", name,
+                                        "test_timer");
+  }
+  delete dataBroker;
+  printf("%s\n", ok ? "ok" : "failed");
+  return ok ? 0 : 1;
+}
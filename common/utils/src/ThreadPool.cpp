@@ -0,0 +1,149 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ThreadPool.h"
+#include "Thread.h"
+#include "MutexLocker.h"
+
+namespace mars {
+  namespace utils {
+
+    class ThreadPoolWorker : public Thread {
+    public:
+      explicit ThreadPoolWorker(ThreadPool *pool) : pool(pool) {}
+
+    protected:
+      void run() {
+        pool->workerLoop();
+      }
+
+    private:
+      ThreadPool *pool;
+    };
+
+    ThreadPool::ThreadPool(std::size_t numThreads)
+      : currentJob(0), jobCount(0), nextIndex(0), pendingCount(0),
+        stopping(false) {
+      setNumThreads(numThreads);
+    }
+
+    ThreadPool::~ThreadPool() {
+      stopWorkers();
+    }
+
+    void ThreadPool::setNumThreads(std::size_t numThreads) {
+      if(numThreads == workers.size()) return;
+      stopWorkers();
+      stopping = false;
+      for(std::size_t i=0; i<numThreads; ++i) {
+        workers.push_back(new ThreadPoolWorker(this));
+        workers.back()->start();
+      }
+    }
+
+    std::size_t ThreadPool::getNumThreads() const {
+      return workers.size();
+    }
+
+    void ThreadPool::stopWorkers() {
+      poolMutex.lock();
+      stopping = true;
+      jobCondition.wakeAll();
+      poolMutex.unlock();
+      for(std::size_t i=0; i<workers.size(); ++i) {
+        workers[i]->wait();
+        delete workers[i];
+      }
+      workers.clear();
+    }
+
+    void ThreadPool::run(ParallelJob *job, std::size_t count) {
+      std::size_t index;
+
+      if(count == 0) return;
+      // nothing to distribute
+      if(workers.empty() || count == 1) {
+        for(index=0; index<count; ++index) {
+          job->runJob(index);
+        }
+        return;
+      }
+
+      MutexLocker runLocker(&runMutex);
+      poolMutex.lock();
+      currentJob = job;
+      jobCount = count;
+      nextIndex = 0;
+      pendingCount = count;
+      jobCondition.wakeAll();
+      poolMutex.unlock();
+
+      // the calling thread helps until all parts are taken
+      while(fetchIndex(&index)) {
+        job->runJob(index);
+        finishIndex();
+      }
+
+      poolMutex.lock();
+      while(pendingCount > 0) {
+        doneCondition.wait(&poolMutex);
+      }
+      currentJob = 0;
+      poolMutex.unlock();
+    }
+
+    bool ThreadPool::fetchIndex(std::size_t *index) {
+      MutexLocker locker(&poolMutex);
+      if(!currentJob || nextIndex >= jobCount) return false;
+      *index = nextIndex++;
+      return true;
+    }
+
+    void ThreadPool::finishIndex() {
+      MutexLocker locker(&poolMutex);
+      if(--pendingCount == 0) {
+        doneCondition.wakeAll();
+      }
+    }
+
+    void ThreadPool::workerLoop() {
+      ParallelJob *job;
+      std::size_t index;
+
+      poolMutex.lock();
+      while(!stopping) {
+        if(!currentJob || nextIndex >= jobCount) {
+          jobCondition.wait(&poolMutex);
+          continue;
+        }
+        job = currentJob;
+        index = nextIndex++;
+        poolMutex.unlock();
+        job->runJob(index);
+        poolMutex.lock();
+        if(--pendingCount == 0) {
+          doneCondition.wakeAll();
+        }
+      }
+      poolMutex.unlock();
+    }
+
+  } // end of namespace utils
+} // end of namespace mars
@@ -0,0 +1,103 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_UTILS_THREADPOOL_H
+#define MARS_UTILS_THREADPOOL_H
+
+#include "Mutex.h"
+#include "WaitCondition.h"
+
+#include <cstddef> // for std::size_t
+#include <vector>
+
+namespace mars {
+  namespace utils {
+
+    /**
+     * \brief Interface for work that can be split into independent parts
+     *        and executed by a ThreadPool.
+     */
+    class ParallelJob {
+    public:
+      virtual ~ParallelJob() {}
+      /**
+       * \brief Executes the part \a index of the job.
+       * Different indices may be executed concurrently on different threads.
+       */
+      virtual void runJob(std::size_t index) = 0;
+    };
+
+    class ThreadPoolWorker;
+
+    /**
+     * \brief A fixed set of worker threads to execute ParallelJobs.
+     *
+     * The calling thread takes part in the execution, so a pool with
+     * \c n worker threads runs a job with up to \c n+1 threads. A pool
+     * without worker threads executes all jobs serially in the calling
+     * thread.
+     */
+    class ThreadPool {
+    public:
+      explicit ThreadPool(std::size_t numThreads=0);
+      ~ThreadPool();
+
+      /**
+       * \brief Sets the number of worker threads.
+       * Must not be called while a job is executed.
+       */
+      void setNumThreads(std::size_t numThreads);
+      std::size_t getNumThreads() const;
+
+      /**
+       * \brief Executes job->runJob(i) for all i in [0, count) and returns
+       *        when all parts are finished.
+       * Calls from different threads are serialized. A job must not call
+       * run() of the pool that executes it.
+       */
+      void run(ParallelJob *job, std::size_t count);
+
+    private:
+      // disallow copying
+      ThreadPool(const ThreadPool &);
+      ThreadPool &operator=(const ThreadPool &);
+
+      bool fetchIndex(std::size_t *index);
+      void finishIndex();
+      void workerLoop();
+      void stopWorkers();
+
+      std::vector<ThreadPoolWorker*> workers;
+      Mutex runMutex;
+      mutable Mutex poolMutex;
+      WaitCondition jobCondition;
+      WaitCondition doneCondition;
+      ParallelJob *currentJob;
+      std::size_t jobCount, nextIndex, pendingCount;
+      bool stopping;
+
+      friend class ThreadPoolWorker;
+
+    }; // end of class ThreadPool
+
+  } // end of namespace utils
+} // end of namespace mars
+
+#endif /* MARS_UTILS_THREADPOOL_H */
@@ -89,6 +89,21 @@ namespace mars {
       return getTime() - start;
     }
 
+    /**
+     * @return current time in microseconds
+     */
+    inline long long getTimeMicro() {
+#ifdef WIN32
+      struct timeb timer;
+      ftime(&timer);
+      return (long long)(timer.time*1000000LL + timer.millitm*1000LL);
+#else
+      struct timeval timer;
+      gettimeofday(&timer, NULL);
+      return ((long long)(timer.tv_sec))*1000000LL + (long long)timer.tv_usec;
+#endif
+    }
+
     /**
      * sleeps for at least the specified time.
      * @param milliseconds time to sleep in milliseconds
@@ -36,6 +36,8 @@ namespace mars {
 
     ControllerData::ControllerData() {
       rate = 20;
+      protocol = "ascii";
+      pipeline_depth = 0;
     }
 
     bool ControllerData::fromConfigMap(ConfigMap *config,
@@ -51,6 +53,8 @@ namespace mars {
       GET_VALUE("index", id, ULong);
       GET_VALUE("rate", rate, Double);
       dylib_path = config->get("dylib_path", dylib_path);
+      protocol = config->get("protocol", protocol);
+      pipeline_depth = config->get("pipeline_depth", pipeline_depth);
 
       if((it = config->find("sensorid")) != config->end()) {
         ConfigVector _ids = (*config)["sensorid"];
@@ -99,6 +103,8 @@ namespace mars {
       SET_VALUE("index", id);
       SET_VALUE("rate", rate);
       SET_VALUE("dylib_path", dylib_path);
+      SET_VALUE("protocol", protocol);
+      SET_VALUE("pipeline_depth", pipeline_depth);
 
       for(it=sensors.begin(); it!=sensors.end(); ++it) {
         (*config)["sensorid"] << *it;
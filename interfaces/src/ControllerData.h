@@ -49,6 +49,10 @@ namespace mars {
       std::vector<unsigned long> sensors;
       std::vector<unsigned long> sNodes;
       std::string dylib_path;
+      /// "ascii" or "binary", used if no dylib is loaded
+      std::string protocol;
+      /// number of steps the motor commands of a binary controller may lag
+      int pipeline_depth;
     }; // end of class ControllerData
 
   } // end of namespace interfaces
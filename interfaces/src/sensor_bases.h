@@ -30,9 +30,13 @@
 #include <configmaps/ConfigData.h>
 #include <mars/utils/Quaternion.h>
 #include <mars/utils/Vector.h>
+#include <mars/utils/Mutex.h>
+#include <mars/utils/MutexLocker.h>
 
 #include <vector>
 #include <limits>
+#include <cstdlib>
+#include <cstring>
 
 
 namespace mars {
@@ -50,6 +54,69 @@ namespace mars {
       unsigned long updateRate;
     }; // end of class BaseConfig
 
+    /**
+     * The values a sensor published once. A block is shared by the sensor
+     * and the views on it and is deleted by the last one releasing it.
+     */
+    struct SensorDataBlock {
+      SensorDataBlock() : version(0), references(1) {}
+      std::vector<double> values;
+      unsigned long version;
+      volatile int references;
+    };
+
+    /**
+     * A read only view on the values a sensor published. The view keeps
+     * its values alive, so it can be read from any thread and stays valid
+     * after the sensor published new values. The version is incremented
+     * whenever the sensor publishes, so a consumer can skip values it
+     * already read.
+     */
+    class SensorDataView {
+    public:
+      SensorDataView() : data(0), size(0), version(0), block(0) {}
+
+      /// takes over one reference of the block
+      explicit SensorDataView(SensorDataBlock *block) : block(block) {
+        data = block->values.empty() ? 0 : &block->values[0];
+        size = block->values.size();
+        version = block->version;
+      }
+
+      SensorDataView(const SensorDataView &other)
+        : data(other.data), size(other.size), version(other.version),
+          block(other.block) {
+        if(block) __sync_fetch_and_add(&block->references, 1);
+      }
+
+      ~SensorDataView() {
+        releaseBlock(block);
+      }
+
+      SensorDataView& operator=(const SensorDataView &other) {
+        if(other.block) __sync_fetch_and_add(&other.block->references, 1);
+        releaseBlock(block);
+        data = other.data;
+        size = other.size;
+        version = other.version;
+        block = other.block;
+        return *this;
+      }
+
+      static void releaseBlock(SensorDataBlock *block) {
+        if(block && __sync_sub_and_fetch(&block->references, 1) == 0) {
+          delete block;
+        }
+      }
+
+      const double *data;
+      int size;
+      unsigned long version;
+
+    private:
+      SensorDataBlock *block;
+    };
+
     class BaseSensor {
     public:
       BaseSensor()
@@ -57,13 +124,18 @@ namespace mars {
         id = 0;
         name = "UNKNOWN";
         updateRate = 10;
+        initView();
+      }
+      virtual ~BaseSensor(){
+        SensorDataView::releaseBlock(viewFront);
+        delete viewBack;
       }
-      virtual ~BaseSensor(){}
 
       BaseSensor(unsigned long id, std::string name):
         id(id),
         name(name)
       {
+        initView();
       }
 
       unsigned long getID() const{
@@ -74,10 +146,43 @@ namespace mars {
         return name;
       }
 
+      /**
+       * \brief Copies the values of the sensor into a buffer allocated
+       * with malloc that has to be freed by the caller.
+       */
       virtual int getSensorData(double **data) const{
         return 0;
       };
 
+      /**
+       * \brief Returns a view on the last published values of the sensor.
+       *
+       * Sensors that publish their values with publishSensorData() return
+       * the view without copying. For the others the values are read by
+       * getSensorData() and the version changes only if they differ from the
+       * last published ones.
+       */
+      virtual SensorDataView getSensorView() const{
+        double *data = 0;
+        int size;
+        if(!viewPublished) {
+          size = getSensorData(&data);
+          utils::MutexLocker locker(&viewMutex);
+          const std::vector<double> &front = viewFront->values;
+          if(!viewPublished &&
+             (size != (int)front.size() ||
+              (size > 0 && memcmp(data, &front[0], size*sizeof(double))))) {
+            SensorDataBlock *block = new SensorDataBlock;
+            block->values.assign(data, data+size);
+            block->version = ++viewVersion;
+            SensorDataView::releaseBlock(viewFront);
+            viewFront = block;
+          }
+        }
+        if(data) free(data);
+        return getPublishedView();
+      }
+
       virtual int getAsciiData(char *data) const{
         return 0;
       }
@@ -110,6 +215,57 @@ namespace mars {
       unsigned long updateRate;
 
     protected:
+      /**
+       * \brief Returns the buffer the next values of the sensor are
+       * written to. It is published by publishSensorData().
+       *
+       * The buffer is not locked. Only the thread that updates the sensor
+       * may write to it and publish it.
+       */
+      std::vector<double>& getSensorDataBuffer() const{
+        return viewBack->values;
+      }
+
+      /**
+       * \brief Publishes the buffer returned by getSensorDataBuffer(). The
+       * previous values are reused as the next buffer unless a view still
+       * holds them.
+       */
+      void publishSensorData() const{
+        utils::MutexLocker locker(&viewMutex);
+        SensorDataBlock *old = viewFront;
+        viewBack->version = ++viewVersion;
+        viewFront = viewBack;
+        viewPublished = true;
+        // views are only taken under viewMutex, so none can appear here
+        if(old->references == 1) {
+          viewBack = old;
+        }
+        else {
+          SensorDataView::releaseBlock(old);
+          viewBack = new SensorDataBlock;
+        }
+      }
+
+      SensorDataView getPublishedView() const{
+        utils::MutexLocker locker(&viewMutex);
+        __sync_fetch_and_add(&viewFront->references, 1);
+        return SensorDataView(viewFront);
+      }
+
+    private:
+      void initView() {
+        viewFront = new SensorDataBlock;
+        viewBack = new SensorDataBlock;
+        viewVersion = 0;
+        viewPublished = false;
+      }
+
+      mutable utils::Mutex viewMutex;
+      mutable SensorDataBlock *viewFront; ///< the sensor holds one reference
+      mutable SensorDataBlock *viewBack; ///< owned by the updating thread
+      mutable unsigned long viewVersion;
+      mutable bool viewPublished;
 
     }; // end of class BaseSensor
 
@@ -260,7 +416,7 @@ namespace mars {
       virtual ~BasePolarIntersectionSensor(){}
 
       virtual int getSensorData(double **data) const{
-        (*data) = (new double[this->data.size()]);
+        (*data) = (double*)malloc(sizeof(double)*this->data.size());
         memcpy((*data),&this->data[0],sizeof(double)*this->data.size());
         return this->data.size();
       };
@@ -78,6 +78,31 @@ namespace mars {
       virtual void setHighStop2(sReal lowStop) = 0;
     };
 
+    /**
+     * \brief Velocity and effort limit of one motor axis.
+     * \see PhysicsInterface::setJointMotorCommands
+     */
+    struct JointMotorCommand {
+      JointInterface *joint;
+      unsigned char axis; /**< 1 or 2 */
+      sReal velocity;
+      sReal effortLimit;
+    };
+
+    /**
+     * \brief State of a joint in the coordinates of the physics.
+     * \see PhysicsInterface::getJointStates
+     */
+    struct JointState {
+      sReal position1, position2;
+      sReal velocity1, velocity2;
+      sReal motorTorque;
+      utils::Vector anchor, axis1, axis2;
+      /** the following values are only read with the feedback */
+      utils::Vector f1, f2, t1, t2;
+      utils::Vector axis1Torque, axis2Torque, jointLoad;
+    };
+
   } // end of namespace interfaces
 } // end of namespace mars
 
@@ -43,6 +43,10 @@ namespace mars {
     class SimJoint;
   }
 
+  namespace utils {
+    class ThreadPool;
+  }
+
   namespace interfaces {
 
     /**
@@ -130,6 +134,21 @@ namespace mars {
        */
       virtual void updateJoints(sReal calc_ms) = 0;
 
+      /**
+       * \brief Updates the joints island by island on the given thread pool.
+       *
+       * A joint belongs to the island of its nodes. Joints that are not
+       * attached to an island are updated serially afterwards. The default
+       * implementation updates all joints serially.
+       * \see NodeManagerInterface::updateDynamicNodes
+       */
+      virtual void updateJoints(sReal calc_ms,
+                                const std::vector<std::vector<unsigned long> > &islands,
+                                utils::ThreadPool *pool,
+                                std::vector<double> *islandTimes=NULL) {
+        updateJoints(calc_ms);
+      }
+
       /**
        * \brief Removes all joints from the simulation to clear the world.
        */
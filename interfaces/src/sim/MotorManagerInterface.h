@@ -43,6 +43,10 @@ namespace mars {
   namespace sim {
     class SimMotor;
   }
+
+  namespace utils {
+    class ThreadPool;
+  }
   
   namespace interfaces {
 
@@ -277,6 +281,35 @@ namespace mars {
        * \param calc_ms The timing value in miliseconds. 
        */
       virtual void updateMotors(sReal calc_ms) = 0;
+
+      /**
+       * \brief Updates the motors island by island on the given thread pool.
+       *
+       * A motor belongs to the island of its joint. Motors that are not
+       * attached to an island and motors that are coupled by mimic
+       * relations are updated serially afterwards. The default
+       * implementation updates all motors serially.
+       * \see NodeManagerInterface::updateDynamicNodes
+       */
+      virtual void updateMotors(sReal calc_ms,
+                                const std::vector<std::vector<unsigned long> > &islands,
+                                utils::ThreadPool *pool,
+                                std::vector<double> *islandTimes=NULL) {
+        updateMotors(calc_ms);
+      }
+
+      /**
+       * \brief Enables the batched update of the position controlled motors
+       *        in updateMotors(sReal).
+       *
+       * The pid controllers of these motors are computed together and their
+       * commands are passed to the physics while the world is locked once.
+       * Motors with mimic relations, a play joint and other motor types
+       * are updated one by one. The island update always batches the
+       * position controlled motors of an island.
+       * The default implementation always updates the motors one by one.
+       */
+      virtual void setBatchedUpdate(bool batched) {}
   
       /**
        * \returns the actual position of the motor with the given Id.
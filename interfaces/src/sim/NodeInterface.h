@@ -83,6 +83,29 @@ namespace mars {
       virtual sReal getCollisionDepth(void) const = 0;
     };
 
+    /**
+     * \brief State of the body of a node.
+     * \see PhysicsInterface::getNodeStates
+     */
+    struct NodeBodyState {
+      utils::Vector pos;
+      utils::Quaternion rot;
+      utils::Vector linearVelocity, angularVelocity;
+      utils::Vector force, torque;
+      bool groundContact;
+      sReal groundContactForce;
+    };
+
+    /**
+     * \brief New velocities of a node, e.g. to apply the damping.
+     * \see PhysicsInterface::setNodeVelocities
+     */
+    struct NodeVelocityCommand {
+      NodeInterface *node;
+      bool setLinear, setAngular;
+      utils::Vector linearVelocity, angularVelocity;
+    };
+
   } // end of namespace interfaces
 } // end of namespace mars
 
@@ -48,6 +48,10 @@ namespace mars {
     class SimNode;
   };
 
+  namespace utils {
+    class ThreadPool;
+  }
+
   namespace interfaces {
 
     /**
@@ -556,6 +560,37 @@ namespace mars {
        */
       virtual void updateDynamicNodes(sReal calc_ms, bool physics_thread=true) = 0;
 
+      /**
+       * \brief Updates the dynamic nodes island by island on the given
+       *        thread pool.
+       *
+       * \param islands Node ids of independent islands as returned by
+       *        PhysicsInterface::getIslands. Dynamic nodes that are not part of
+       *        an island are updated serially afterwards.
+       * \param islandTimes If not NULL, the time in ms spent on each island
+       *        is added to the corresponding entry. The vector has to have
+       *        the size of \c islands.
+       *
+       * The default implementation updates all nodes serially.
+       */
+      virtual void updateDynamicNodes(sReal calc_ms,
+                                      const std::vector<std::vector<unsigned long> > &islands,
+                                      utils::ThreadPool *pool,
+                                      std::vector<double> *islandTimes=NULL) {
+        updateDynamicNodes(calc_ms);
+      }
+
+      /**
+       * \brief Publishes the states of the dynamic nodes after a step.
+       *
+       * The position, rotation, velocity, acceleration and contact force
+       * getters of the dynamic nodes return the published states without
+       * locking until a node is moved or changed by the manager.
+       * The default implementation publishes nothing and the getters keep
+       * reading the physics.
+       */
+      virtual void publishNodeStates() {}
+
       /**
        * \brief This function destroys all nodes within the simulation.
        *
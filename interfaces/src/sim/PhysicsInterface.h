@@ -41,6 +41,11 @@ namespace mars {
   namespace interfaces {
 
     class NodeInterface;
+    class JointInterface;
+    struct JointMotorCommand;
+    struct JointState;
+    struct NodeBodyState;
+    struct NodeVelocityCommand;
 
     enum PhysicsError {
       PHYSICS_NO_ERROR = 0,
@@ -49,6 +54,17 @@ namespace mars {
       PHYSICS_UNKNOWN,
     };
 
+    /**
+     * Broadphase layouts for the collision spaces of the physics.
+     */
+    enum SpaceType {
+      SPACE_NONE = 0, /**< no separate space for static geometry */
+      SPACE_SIMPLE,
+      SPACE_HASH,
+      SPACE_QUADTREE,
+      SPACE_SAP,
+    };
+
     class PhysicsInterface {
 
     public:
@@ -58,6 +74,20 @@ namespace mars {
       bool fast_step;
       bool draw_contact_points;
       sReal world_cfm, world_erp;
+      bool parallel_islands; /**< Step independent islands concurrently */
+      int num_island_threads; /**< Number of threads used for the islands */
+      int num_ray_threads; /**< Number of threads casting the sensor rays */
+      /**
+       * Layout of the space holding the geoms without a body. These are
+       * only collided against the dynamic space. With \c SPACE_NONE all
+       * geoms share the dynamic space. Changes take effect with the next
+       * initTheWorld().
+       */
+      SpaceType static_space_type;
+      SpaceType dynamic_space_type; /**< Layout of the space for moving geoms */
+      utils::Vector space_center, space_extents; /**< Region of a quadtree */
+      int space_depth; /**< Depth of a quadtree */
+      int hash_min_level, hash_max_level; /**< Cell sizes of a hash space as powers of two */
 
       virtual ~PhysicsInterface() {}
       virtual void initTheWorld(void) = 0;
@@ -67,6 +97,96 @@ namespace mars {
       virtual const utils::Vector getCenterOfMass(const std::vector<NodeInterface*> &nodes) const = 0;
       virtual int checkCollisions(void) = 0;
       virtual sReal getVectorCollision(const utils::Vector &pos, const utils::Vector &ray) const = 0;
+
+      /**
+       * \brief Returns the collision distances of several rays at once.
+       *
+       * Equal to calling getVectorCollision() for every pair of \a pos and
+       * \a rays. If the sizes differ only the first pairs are cast.
+       */
+      virtual void getVectorCollisions(const std::vector<utils::Vector> &pos,
+                                       const std::vector<utils::Vector> &rays,
+                                       std::vector<sReal> *depths) const {
+        size_t count = pos.size() < rays.size() ? pos.size() : rays.size();
+        depths->resize(count);
+        for(size_t i=0; i<count; ++i) {
+          (*depths)[i] = getVectorCollision(pos[i], rays[i]);
+        }
+      }
+
+      /**
+       * \brief Returns the node ids of the independent islands found in
+       *        the last step.
+       *
+       * Nodes of one island are connected via joints or contacts. Nodes of
+       * different islands do not influence each other during a step and can
+       * be updated concurrently. The list is only filled if
+       * \c parallel_islands is set.
+       */
+      virtual void getIslands(std::vector<std::vector<unsigned long> > *islands) const {
+        islands->clear();
+      }
+
+      /**
+       * \brief Casts the rays the nodes queued for their sensors while they
+       *        were updated after the last step.
+       */
+      virtual void castSensorRays(void) {}
+
+      /**
+       * \brief Sets the velocity and effort limit of several motor axes
+       *        while the world is locked only once.
+       *
+       * \return \c false if the physics does not support it. The caller
+       *         then has to set the commands joint by joint.
+       */
+      virtual bool setJointMotorCommands(const std::vector<JointMotorCommand> &commands) {
+        CPP_UNUSED(commands);
+        return false;
+      }
+
+      /**
+       * \brief Reads the state of several joints while the world is locked
+       *        only once.
+       *
+       * \param feedback If the entry of a joint is \c false its forces,
+       *        torques and joint load are not computed.
+       * \return \c false if the physics does not support it. The caller
+       *         then has to read the joints one by one.
+       */
+      virtual bool getJointStates(const std::vector<JointInterface*> &joints,
+                                  const std::vector<bool> &feedback,
+                                  std::vector<JointState> *states) const {
+        CPP_UNUSED(joints);
+        CPP_UNUSED(feedback);
+        CPP_UNUSED(states);
+        return false;
+      }
+
+      /**
+       * \brief Reads the state of several nodes while the world is locked
+       *        only once.
+       *
+       * \return \c false if the physics does not support it. The caller
+       *         then has to read the nodes one by one.
+       */
+      virtual bool getNodeStates(const std::vector<NodeInterface*> &nodes,
+                                 std::vector<NodeBodyState> *states) const {
+        CPP_UNUSED(nodes);
+        CPP_UNUSED(states);
+        return false;
+      }
+
+      /**
+       * \brief Sets the velocities of several nodes while the world is
+       *        locked only once.
+       *
+       * \return \c false if the physics does not support it.
+       */
+      virtual bool setNodeVelocities(const std::vector<NodeVelocityCommand> &commands) {
+        CPP_UNUSED(commands);
+        return false;
+      }
     };
 
   } // end of namespace interfaces
@@ -163,6 +163,25 @@ namespace mars {
        */
       virtual int getSensorData(unsigned long id, sReal **data) const = 0;
 
+      /**
+       * \brief Returns a read only view on the values of a sensor, see
+       * BaseSensor::getSensorView(). The view is empty if the sensor does
+       * not exist.
+       *
+       * The default implementation copies the values of getSensorData()
+       * into a new view whose version changes with every call.
+       */
+      virtual SensorDataView getSensorView(unsigned long id) const {
+        static unsigned long lastVersion = 0;
+        SensorDataBlock *block = new SensorDataBlock;
+        sReal *data = 0;
+        int size = getSensorData(id, &data);
+        if(size > 0) block->values.assign(data, data+size);
+        if(data) free(data);
+        block->version = __sync_add_and_fetch(&lastVersion, 1);
+        return SensorDataView(block);
+      }
+
       /**
        *\brief Returns the number of sensors that are currently present in the simulation.
        *
@@ -38,6 +38,7 @@ namespace mars {
         indices = 0;
         indexcount = 0;
         vertexcount = 0;
+        shared = false;
       }
 
       snmesh(){
@@ -52,6 +53,12 @@ namespace mars {
       int *indices;
       int indexcount;
       int vertexcount;
+      /**
+       * The arrays are immutable and owned by the creator of the mesh,
+       * e.g. the BatchSimulator. Nodes and physics neither copy nor free
+       * them.
+       */
+      bool shared;
 
     }; // end of struct snmesh
 
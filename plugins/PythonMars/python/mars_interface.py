@@ -2,6 +2,8 @@ from time import clock
 
 iDict = {}
 startTime = clock()
+observation = None
+action = None
 
 def timing(s):
     global startTime
@@ -63,6 +65,35 @@ def requestConfig(group, name):
     global iDict
     iDict["request"].append({"type": "Config", "group": group, "name": name})
 
+def setObservationLayout(entries):
+    """entries is a list of (type, name) tuples with the types "Node",
+    "Motor" or "Sensor". The observation array passed to
+    setObservationBuffer is filled before every update call."""
+    global iDict
+    iDict["observationLayout"] = [{"type": t, "name": n} for t, n in entries]
+
+def setActionLayout(motors):
+    """The values written into the action array are set as motor values
+    after every update call."""
+    global iDict
+    iDict["actionLayout"] = list(motors)
+
+def setObservationBuffer(array):
+    """Called by PythonMars with a numpy array that shares the memory of
+    the simulation. It is invalid after the layout is changed."""
+    global observation
+    observation = array
+
+def setActionBuffer(array):
+    global action
+    action = array
+
+def getObservation():
+    return observation
+
+def getAction():
+    return action
+
 def logMessage(s):
     global iDict
     iDict["log"]["debug"].append(s)
@@ -54,7 +54,8 @@ namespace mars {
       using namespace mars::interfaces;
 
       PythonMars::PythonMars(lib_manager::LibManager *theManager)
-        : MarsPluginTemplateGUI(theManager, "PythonMars")      {
+        : MarsPluginTemplateGUI(theManager, "PythonMars"),
+          observation(NULL), action(NULL), observationSize(0) {
 #ifdef __unix__
         // needed to be able to import numpy
         dlopen(PYTHON_LIB, RTLD_LAZY | RTLD_GLOBAL);
@@ -63,6 +64,8 @@ namespace mars {
 
       PythonMars::~PythonMars() {
         if(materialManager) libManager->releaseLibrary("osg_material_manager");
+        delete[] observation;
+        delete[] action;
       }
 
       void PythonMars::init() {
@@ -290,6 +293,18 @@ namespace mars {
             map.erase(it);
           }
 
+          if(map.hasKey("observationLayout")) {
+            setObservationLayout(map["observationLayout"]);
+            ConfigMap::iterator it = map.find("observationLayout");
+            map.erase(it);
+          }
+
+          if(map.hasKey("actionLayout")) {
+            setActionLayout(map["actionLayout"]);
+            ConfigMap::iterator it = map.find("actionLayout");
+            map.erase(it);
+          }
+
           guiMapMutex.lock();
           guiMaps.push_back(map);
           guiMapMutex.unlock();
@@ -494,6 +509,150 @@ namespace mars {
         guiMapMutex.unlock();
       }
 
+      /**
+       * The layout is a list of {type, name} maps. A node adds its
+       * position and rotation (x, y, z, w), a motor its position and
+       * torque and a sensor the values it has when the layout is set.
+       * The buffer is passed to setObservationBuffer of the python plugin
+       * and filled before every update call.
+       */
+      void PythonMars::setObservationLayout(ConfigItem &layout) {
+        std::vector<ObservationEntry> entries;
+        std::string key;
+        int size = 0;
+        ConfigVector::iterator it;
+
+        // the plugin might send the same layout in every step
+        for(it=layout.begin(); it!=layout.end(); ++it) {
+          if(!it->hasKey("type") || !it->hasKey("name")) continue;
+          key += (std::string)(*it)["type"] + ":" +
+            (std::string)(*it)["name"] + ";";
+        }
+        if(observation && key == observationKey) return;
+        observationKey = key;
+
+        for(it=layout.begin(); it!=layout.end(); ++it) {
+          if(!it->hasKey("type") || !it->hasKey("name")) continue;
+          std::string type = (*it)["type"];
+          std::string name = (*it)["name"];
+          ObservationEntry entry;
+          entry.version = 0;
+          if(type == "Node") {
+            entry.type = OBSERVE_NODE;
+            entry.id = control->nodes->getID(name);
+            entry.size = 7;
+          }
+          else if(type == "Motor") {
+            entry.type = OBSERVE_MOTOR;
+            entry.id = control->motors->getID(name);
+            entry.size = 2;
+          }
+          else if(type == "Sensor") {
+            entry.type = OBSERVE_SENSOR;
+            entry.id = control->sensors->getSensorID(name);
+            entry.size = entry.id ? control->sensors->getSensorView(entry.id).size : 0;
+          }
+          else {
+            LOG_ERROR("PythonMars: unknown observation type \"%s\"",
+                      type.c_str());
+            continue;
+          }
+          if(!entry.id) {
+            // keep the layout of the python side, the values stay zero
+            LOG_ERROR("PythonMars: observation \"%s\" not found",
+                      name.c_str());
+          }
+          entry.offset = size;
+          size += entry.size;
+          entries.push_back(entry);
+        }
+
+        delete[] observation;
+        observationLayout.swap(entries);
+        observationSize = size;
+        observation = new double[size > 0 ? size : 1];
+        memset(observation, 0, sizeof(double)*(size > 0 ? size : 1));
+        fillObservation();
+        plugin->function("setObservationBuffer").pass(ONEDCARRAY).call(0, observation, observationSize);
+      }
+
+      /**
+       * The layout is a list of motor names. The values the python plugin
+       * writes into the buffer passed to setActionBuffer are set as motor
+       * values after every update call.
+       */
+      void PythonMars::setActionLayout(ConfigItem &layout) {
+        std::vector<unsigned long> motors;
+        std::string key;
+        ConfigVector::iterator it;
+
+        for(it=layout.begin(); it!=layout.end(); ++it) {
+          key += (std::string)*it + ";";
+        }
+        if(action && key == actionKey) return;
+        actionKey = key;
+
+        for(it=layout.begin(); it!=layout.end(); ++it) {
+          std::string name = *it;
+          unsigned long id = control->motors->getID(name);
+          if(!id) {
+            LOG_ERROR("PythonMars: action motor \"%s\" not found",
+                      name.c_str());
+          }
+          motors.push_back(id);
+        }
+
+        delete[] action;
+        actionMotors.swap(motors);
+        action = new double[actionMotors.empty() ? 1 : actionMotors.size()];
+        for(size_t i=0; i<actionMotors.size(); ++i) {
+          action[i] = actionMotors[i] ? control->motors->getActualPosition(actionMotors[i]) : 0.0;
+        }
+        plugin->function("setActionBuffer").pass(ONEDCARRAY).call(0, action, (int)actionMotors.size());
+      }
+
+      void PythonMars::fillObservation() {
+        std::vector<ObservationEntry>::iterator it;
+        for(it=observationLayout.begin(); it!=observationLayout.end(); ++it) {
+          if(!it->id) continue;
+          double *values = observation + it->offset;
+          switch(it->type) {
+          case OBSERVE_NODE: {
+            Vector pos = control->nodes->getPosition(it->id);
+            Quaternion rot = control->nodes->getRotation(it->id);
+            values[0] = pos.x();
+            values[1] = pos.y();
+            values[2] = pos.z();
+            values[3] = rot.x();
+            values[4] = rot.y();
+            values[5] = rot.z();
+            values[6] = rot.w();
+            break;
+          }
+          case OBSERVE_MOTOR:
+            values[0] = control->motors->getActualPosition(it->id);
+            values[1] = control->motors->getTorque(it->id);
+            break;
+          case OBSERVE_SENSOR: {
+            SensorDataView view = control->sensors->getSensorView(it->id);
+            if(view.version == it->version) break;
+            it->version = view.version;
+            memcpy(values, view.data,
+                   sizeof(double)*(view.size < it->size ? view.size : it->size));
+            break;
+          }
+          }
+        }
+      }
+
+      void PythonMars::applyAction() {
+        for(size_t i=0; i<actionMotors.size(); ++i) {
+          if(actionMotors[i]) {
+            control->motors->setMotorValue(actionMotors[i], action[i]);
+          }
+        }
+      }
+
       void PythonMars::reset() {
         motorMap.clear();
         //plugin->reload();
@@ -550,12 +709,10 @@ namespace mars {
 
             if(type == "Sensor") {
               unsigned long id = control->sensors->getSensorID(name);
-              sReal *data;
-              int num = control->sensors->getSensorData(id, &data);
-              for(int i=0; i<num; ++i) {
-                sendMap["Sensors"][name][i] = data[i];
+              SensorDataView view = control->sensors->getSensorView(id);
+              for(int i=0; i<view.size; ++i) {
+                sendMap["Sensors"][name][i] = view.data[i];
               }
-              if(num) free(data);
             }
 
             if(type == "Config") {
@@ -614,10 +771,12 @@ namespace mars {
               }
             }
             mutexCamera.unlock();
+            if(observation) fillObservation();
             mutex.lock();
             toConfigMap(plugin->function("update").pass(MAP).call(0, &sendMap).returnObject(), iMap);
             nextStep = true;
             mutex.unlock();
+            if(action && control->sim->isSimRunning()) applyAction();
             mutexPoints.lock();
             { // udpate point clouds
               std::map<std::string, PointStruct>::iterator it = points.begin();
@@ -702,6 +861,9 @@ namespace mars {
                 free(it.second.pydata);
               }
               depthCameras.clear();
+              // pass the buffers again to the reloaded module
+              observationKey.clear();
+              actionKey.clear();
             }
             else {
               plugin = PythonInterpreter::instance().import("mars_plugin");
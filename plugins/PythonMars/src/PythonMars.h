@@ -77,6 +77,23 @@ namespace mars {
         int size;
       };
 
+      enum ObservationType {
+        OBSERVE_NODE,
+        OBSERVE_MOTOR,
+        OBSERVE_SENSOR
+      };
+
+      /**
+       * A part of the observation buffer. The id is resolved when the
+       * layout is set, so filling the buffer needs no name lookups.
+       */
+      struct ObservationEntry {
+        ObservationType type;
+        unsigned long id;
+        int offset, size;
+        unsigned long version; ///< of the sensor values in the buffer
+      };
+
       // inherit from MarsPluginTemplateGUI for extending the gui
       class PythonMars: public mars::interfaces::MarsPluginTemplateGUI,
         public mars::data_broker::ReceiverInterface,
@@ -116,6 +133,11 @@ namespace mars {
         // PythonMars methods
 
       private:
+        void setObservationLayout(configmaps::ConfigItem &layout);
+        void setActionLayout(configmaps::ConfigItem &layout);
+        void fillObservation();
+        void applyAction();
+
         cfg_manager::cfgPropertyStruct example;
         //PythonMars_MainWin *plugin_win;
         utils::Mutex gpMutex, mutex, guiMapMutex, mutexPoints, mutexCamera;
@@ -134,6 +156,12 @@ namespace mars {
         configmaps::ConfigItem iMap;
         double updateTime;
         std::vector<configmaps::ConfigMap> guiMaps;
+        // buffers shared with numpy arrays of the python plugin
+        std::vector<ObservationEntry> observationLayout;
+        std::vector<unsigned long> actionMotors;
+        std::string observationKey, actionKey;
+        double *observation, *action;
+        int observationSize;
 
         }; // end of class definition PythonMars
 
@@ -0,0 +1,143 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file bridge_bench.cpp
+ * \brief Compares the steps per second of the ConfigMap request path of
+ *        PythonMars with the numpy observation/action buffers.
+ *
+ * The benchmark runs the python policy of bridge_bench.py without a
+ * simulation. The map path builds the request map of 50 nodes and 20
+ * motors like PythonMars::update, converts it to python and reads the
+ * motor commands from the returned map by name. The buffer path fills the
+ * observation buffer at the offsets of its layout and reads the action
+ * buffer. The test fails if both paths compute different motor values.
+ * The number of steps can be given as first argument.
+ */
+
+#include "PythonInterpreter.hpp"
+
+#include <mars/utils/misc.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace mars;
+using namespace configmaps;
+
+static const int numNodes = 50;
+static const int numMotors = 20;
+
+// the state of the simulation in a step
+static double getNodeValue(long step, int node, int i) {
+  return 0.001*step + node + 0.1*i;
+}
+
+static double getMotorValue(long step, int motor, int i) {
+  return 0.002*step - motor + 0.1*i;
+}
+
+int main(int argc, char *argv[]) {
+  long numSteps = 1000;
+  std::vector<std::string> nodeNames, motorNames;
+  std::vector<double> mapAction(numMotors), observation, action(numMotors);
+  long long startTime, mapTime, bufferTime;
+  double maxError = 0.0;
+  const char *pos = "xyz", *rot = "xyzw";
+  char name[32];
+
+  if(argc > 1) {
+    numSteps = atol(argv[1]);
+  }
+  for(int i=0; i<numNodes; ++i) {
+    sprintf(name, "node%d", i);
+    nodeNames.push_back(name);
+  }
+  for(int i=0; i<numMotors; ++i) {
+    sprintf(name, "motor%d", i);
+    motorNames.push_back(name);
+  }
+
+  try {
+    PythonInterpreter::instance().addToPythonpath(BRIDGE_BENCH_DIR);
+    shared_ptr<Module> bench = PythonInterpreter::instance().import("bridge_bench");
+    bench->function("setup").pass(INT).pass(INT).call(0, numNodes, numMotors);
+
+    // the request map path
+    startTime = utils::getTimeMicro();
+    for(long step=0; step<numSteps; ++step) {
+      ConfigMap sendMap;
+      ConfigItem result;
+      for(int i=0; i<numNodes; ++i) {
+        ConfigItem &node = sendMap["Nodes"][nodeNames[i]];
+        for(int k=0; k<3; ++k) {
+          node["pos"][std::string(1, pos[k])] = getNodeValue(step, i, k);
+        }
+        for(int k=0; k<4; ++k) {
+          node["rot"][std::string(1, rot[k])] = getNodeValue(step, i, 3+k);
+        }
+      }
+      for(int i=0; i<numMotors; ++i) {
+        sendMap["Motors"][motorNames[i]]["position"] = getMotorValue(step, i, 0);
+        sendMap["Motors"][motorNames[i]]["torque"] = getMotorValue(step, i, 1);
+      }
+      toConfigMap(bench->function("update").pass(MAP).call(0, &sendMap).returnObject(), result);
+      for(int i=0; i<numMotors; ++i) {
+        mapAction[i] = result["commands"][motorNames[i]]["value"];
+      }
+    }
+    mapTime = utils::getTimeMicro() - startTime;
+
+    // the observation/action buffer path
+    observation.resize(numNodes*7 + numMotors*2);
+    bench->function("setObservationBuffer").pass(ONEDCARRAY).call(0, &observation[0], (int)observation.size());
+    bench->function("setActionBuffer").pass(ONEDCARRAY).call(0, &action[0], numMotors);
+    startTime = utils::getTimeMicro();
+    for(long step=0; step<numSteps; ++step) {
+      double *values = &observation[0];
+      for(int i=0; i<numNodes; ++i, values+=7) {
+        for(int k=0; k<7; ++k) {
+          values[k] = getNodeValue(step, i, k);
+        }
+      }
+      for(int i=0; i<numMotors; ++i, values+=2) {
+        values[0] = getMotorValue(step, i, 0);
+        values[1] = getMotorValue(step, i, 1);
+      }
+      bench->function("updateBuffers").call(0);
+    }
+    bufferTime = utils::getTimeMicro() - startTime;
+  }
+  catch(const std::exception &e) {
+    printf("Error: %s\n", e.what());
+    return 1;
+  }
+
+  for(int i=0; i<numMotors; ++i) {
+    maxError = fmax(maxError, fabs(mapAction[i] - action[i]));
+  }
+  printf("map path: %.0f steps/s, buffer path: %.0f steps/s, error %g\n",
+         mapTime > 0 ? numSteps*1000000.0/mapTime : 0.0,
+         bufferTime > 0 ? numSteps*1000000.0/bufferTime : 0.0, maxError);
+  return maxError < 1e-9 ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+# Policy of bridge_bench: every motor is set to half of the x position of
+# its node plus its position. update() uses the maps of the request path,
+# updateBuffers() the numpy arrays of the observation/action layout.
+
+numNodes = 0
+numMotors = 0
+observation = None
+action = None
+
+def setup(nodes, motors):
+    global numNodes, numMotors
+    numNodes = nodes
+    numMotors = motors
+
+def update(marsData):
+    commands = {}
+    for i in range(numMotors):
+        node = marsData["Nodes"]["node%d" % i]
+        motor = marsData["Motors"]["motor%d" % i]
+        commands["motor%d" % i] = {"value": 0.5*node["pos"]["x"] +
+                                   motor["position"]}
+    return {"commands": commands}
+
+def setObservationBuffer(array):
+    global observation
+    observation = array
+
+def setActionBuffer(array):
+    global action
+    action = array
+
+def updateBuffers():
+    motorOffset = numNodes*7
+    action[:] = (0.5*observation[0:numMotors*7:7] +
+                 observation[motorOffset:motorOffset+numMotors*2:2])
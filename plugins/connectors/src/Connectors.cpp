@@ -129,6 +129,8 @@ namespace mars {
           femaleconnectors[female]["jointid"] = jointid;
           femaleconnectors[female]["partner"] = male;
           connections[male] = female;
+          // the breakable check reads the joint load
+          control->joints->getSimJoint(jointid)->setFeedbackRequired(true);
         }
       }
 
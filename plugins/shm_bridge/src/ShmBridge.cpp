@@ -0,0 +1,410 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ShmBridge.cpp
+ * \brief "ShmBridge" mirrors DataBroker streams into a POSIX shared memory
+ *        segment.
+ */
+
+#include "ShmBridge.h"
+
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/data_broker/DataPackage.h>
+#include <mars/utils/misc.h>
+
+#include <cstdio>
+#include <cstring>
+
+#ifndef WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+#endif
+
+namespace mars {
+  namespace plugins {
+    namespace shm_bridge {
+
+      using namespace mars::utils;
+      using namespace mars::data_broker;
+
+      static size_t align8(size_t size) {
+        return (size + 7) & ~(size_t)7;
+      }
+
+      static ShmBridgeType getShmType(DataType type) {
+        switch(type) {
+        case INT_TYPE: return SHM_BRIDGE_INT32;
+        case UINT_TYPE: return SHM_BRIDGE_UINT32;
+        case LONG_TYPE: return SHM_BRIDGE_INT64;
+        case ULONG_TYPE: return SHM_BRIDGE_UINT64;
+        case FLOAT_TYPE: return SHM_BRIDGE_FLOAT;
+        case DOUBLE_TYPE: return SHM_BRIDGE_DOUBLE;
+        case BOOL_TYPE: return SHM_BRIDGE_BOOL;
+        case STRING_TYPE: return SHM_BRIDGE_STRING;
+        default: return SHM_BRIDGE_UNDEFINED;
+        }
+      }
+
+      static size_t getShmTypeSize(ShmBridgeType type) {
+        switch(type) {
+        case SHM_BRIDGE_INT32:
+        case SHM_BRIDGE_UINT32:
+        case SHM_BRIDGE_FLOAT:
+          return 4;
+        case SHM_BRIDGE_INT64:
+        case SHM_BRIDGE_UINT64:
+        case SHM_BRIDGE_DOUBLE:
+          return 8;
+        case SHM_BRIDGE_BOOL:
+          return 1;
+        case SHM_BRIDGE_STRING:
+          return SHM_BRIDGE_STRING_SIZE;
+        default:
+          return 0;
+        }
+      }
+
+      ShmBridge::ShmBridge(lib_manager::LibManager *theManager)
+        : lib_manager::LibInterface(theManager), dataBroker(NULL), cfg(NULL),
+          segment(NULL), segmentSize(0), segmentUsed(0), numSlots(1024),
+          header(NULL) {
+
+        std::string streamList;
+        unsigned int slots;
+
+        dataBroker = libManager->getLibraryAs<DataBrokerInterface>("data_broker");
+        if(!dataBroker) {
+          fprintf(stderr, "******* shm_bridge: couldn't find data_broker\n");
+          return;
+        }
+
+        segmentName = "/mars_shm_bridge";
+        segmentSize = 64;
+        cfg = libManager->getLibraryAs<cfg_manager::CFGManagerInterface>("cfg_manager");
+        if(cfg) {
+          segmentName = cfg->getOrCreateProperty("ShmBridge", "segment",
+                                                 segmentName).sValue;
+          segmentSize = cfg->getOrCreateProperty("ShmBridge", "size MB",
+                                                 (int)segmentSize).iValue;
+          numSlots = cfg->getOrCreateProperty("ShmBridge", "slots",
+                                              (int)numSlots).iValue;
+          cfgStreams = cfg->getOrCreateProperty("ShmBridge", "streams",
+                                                std::string(""), this);
+          streamList = cfgStreams.sValue;
+        }
+        segmentSize *= 1024*1024;
+        // the slot of a sample is found by masking its number
+        for(slots = 1; slots < numSlots; slots <<= 1) ;
+        numSlots = slots;
+
+        if(openSegment()) {
+          setStreams(streamList);
+        }
+      }
+
+      ShmBridge::~ShmBridge() {
+        setStreams("");
+        closeSegment();
+        for(size_t i=0; i<streams.size(); ++i) {
+          delete streams[i];
+        }
+        if(cfg) libManager->releaseLibrary("cfg_manager");
+        if(dataBroker) libManager->releaseLibrary("data_broker");
+      }
+
+      bool ShmBridge::openSegment() {
+#ifdef WIN32
+        dataBroker->pushError("ShmBridge: shared memory is not supported");
+        return false;
+#else
+        const unsigned int maxStreams = 256;
+        void *region;
+        int fd;
+
+        // readers of an old segment keep their mapping
+        shm_unlink(segmentName.c_str());
+        fd = shm_open(segmentName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if(fd < 0) {
+          dataBroker->pushError("ShmBridge: could not create segment \"%s\"",
+                                segmentName.c_str());
+          return false;
+        }
+        if(ftruncate(fd, segmentSize) != 0) {
+          dataBroker->pushError("ShmBridge: could not resize segment \"%s\"",
+                                segmentName.c_str());
+          ::close(fd);
+          shm_unlink(segmentName.c_str());
+          return false;
+        }
+        region = mmap(NULL, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+        ::close(fd);
+        if(region == MAP_FAILED) {
+          dataBroker->pushError("ShmBridge: could not map segment \"%s\"",
+                                segmentName.c_str());
+          shm_unlink(segmentName.c_str());
+          return false;
+        }
+        segment = (char*)region;
+        segmentUsed = align8(sizeof(ShmBridgeHeader) +
+                             maxStreams*sizeof(ShmBridgeStream));
+        if(segmentUsed > segmentSize) {
+          dataBroker->pushError("ShmBridge: segment \"%s\" is too small",
+                                segmentName.c_str());
+          closeSegment();
+          return false;
+        }
+        // the new segment is filled with zeros
+        header = (ShmBridgeHeader*)segment;
+        header->version = SHM_BRIDGE_VERSION;
+        header->maxStreams = maxStreams;
+        header->numStreams = 0;
+        header->size = segmentSize;
+        __sync_synchronize();
+        header->magic = SHM_BRIDGE_MAGIC;
+        return true;
+#endif
+      }
+
+      void ShmBridge::closeSegment() {
+#ifndef WIN32
+        if(segment) {
+          munmap(segment, segmentSize);
+          shm_unlink(segmentName.c_str());
+          segment = NULL;
+          header = NULL;
+        }
+#endif
+      }
+
+      void ShmBridge::setStreams(const std::string &streamList) {
+        std::vector<std::pair<std::string, std::string> >::iterator it;
+        std::vector<std::string> entries;
+        std::string entry;
+        size_t pos;
+
+        if(!dataBroker) return;
+        for(it=patterns.begin(); it!=patterns.end(); ++it) {
+          dataBroker->unregisterSyncReceiver(this, it->first, it->second);
+        }
+        patterns.clear();
+        if(!segment) return;
+
+        entries = explodeString(';', streamList);
+        for(size_t i=0; i<entries.size(); ++i) {
+          entry = trim(entries[i]);
+          if(entry.empty()) continue;
+          pos = entry.find('/');
+          if(pos == std::string::npos) {
+            patterns.push_back(std::make_pair(entry, std::string("*")));
+          } else {
+            patterns.push_back(std::make_pair(entry.substr(0, pos),
+                                              entry.substr(pos+1)));
+          }
+          dataBroker->registerSyncReceiver(this, patterns.back().first,
+                                           patterns.back().second);
+        }
+      }
+
+      ShmStream* ShmBridge::getStream(const DataInfo &info,
+                                      const DataPackage &package) {
+        ShmStream *stream = NULL;
+        bool skipped = false;
+
+        streamsLock.lockForRead();
+        if(info.dataId < streams.size()) {
+          stream = streams[info.dataId];
+          skipped = skippedStreams[info.dataId];
+        }
+        streamsLock.unlock();
+        if(stream || skipped) return stream;
+
+        streamsLock.lockForWrite();
+        if(info.dataId >= streams.size()) {
+          streams.resize(info.dataId+1, NULL);
+          skippedStreams.resize(info.dataId+1, false);
+        }
+        stream = streams[info.dataId];
+        if(!stream && !skippedStreams[info.dataId]) {
+          stream = createStream(info, package);
+          streams[info.dataId] = stream;
+          skippedStreams[info.dataId] = (stream == NULL);
+        }
+        streamsLock.unlock();
+        return stream;
+      }
+
+      ShmStream* ShmBridge::createStream(const DataInfo &info,
+                                         const DataPackage &package) {
+        ShmBridgeStream *streamHeader;
+        ShmBridgeItem *items;
+        ShmBridgeType type;
+        size_t itemsOffset, slotsOffset, offset, size, slotSize;
+        size_t numItems = package.size();
+
+        if(header->numStreams >= header->maxStreams) {
+          dataBroker->pushWarning("ShmBridge: too many streams, \"%s/%s\" is"
+                                  " not mirrored", info.groupName.c_str(),
+                                  info.dataName.c_str());
+          return NULL;
+        }
+        if(info.groupName.size() >= SHM_BRIDGE_NAME_SIZE ||
+           info.dataName.size() >= SHM_BRIDGE_NAME_SIZE) {
+          dataBroker->pushWarning("ShmBridge: the name of \"%s/%s\" is too"
+                                  " long", info.groupName.c_str(),
+                                  info.dataName.c_str());
+          return NULL;
+        }
+
+        // place every value at an offset aligned to its size
+        offset = 0;
+        for(size_t i=0; i<numItems; ++i) {
+          size = getShmTypeSize(getShmType(package[i].type));
+          if(size == 4 || size == 8) offset = (offset + size-1) & ~(size-1);
+          offset += size;
+        }
+        slotSize = align8(sizeof(ShmBridgeSlot) + offset);
+        itemsOffset = segmentUsed;
+        slotsOffset = itemsOffset + align8(numItems*sizeof(ShmBridgeItem));
+        if(slotsOffset + slotSize*numSlots > segmentSize) {
+          dataBroker->pushWarning("ShmBridge: the segment is full, \"%s/%s\""
+                                  " is not mirrored", info.groupName.c_str(),
+                                  info.dataName.c_str());
+          return NULL;
+        }
+        segmentUsed = slotsOffset + slotSize*numSlots;
+
+        items = (ShmBridgeItem*)(segment + itemsOffset);
+        offset = 0;
+        for(size_t i=0; i<numItems; ++i) {
+          type = getShmType(package[i].type);
+          size = getShmTypeSize(type);
+          if(size == 4 || size == 8) offset = (offset + size-1) & ~(size-1);
+          strncpy(items[i].name, package[i].getName().c_str(),
+                  SHM_BRIDGE_NAME_SIZE-1);
+          items[i].type = type;
+          items[i].offset = offset;
+          offset += size;
+        }
+
+        streamHeader = ((ShmBridgeStream*)(header+1)) + header->numStreams;
+        strcpy(streamHeader->groupName, info.groupName.c_str());
+        strcpy(streamHeader->dataName, info.dataName.c_str());
+        streamHeader->numItems = numItems;
+        streamHeader->slotSize = slotSize;
+        streamHeader->numSlots = numSlots;
+        streamHeader->itemsOffset = itemsOffset;
+        streamHeader->slotsOffset = slotsOffset;
+        streamHeader->writeCount = 0;
+        // publish the stream after its header is written
+        __sync_synchronize();
+        header->numStreams += 1;
+
+        ShmStream *stream = new ShmStream;
+        stream->header = streamHeader;
+        stream->items = items;
+        stream->slots = segment + slotsOffset;
+        stream->numItems = numItems;
+        return stream;
+      }
+
+      /**
+       * A stream is written by the thread that pushes its packages. Like
+       * the DataBroker itself the bridge expects one producer per stream.
+       */
+      void ShmBridge::receiveData(const DataInfo &info,
+                                  const DataPackage &package,
+                                  int callbackParam) {
+        ShmStream *stream = getStream(info, package);
+        // the layout of a stream is fixed by its first package
+        if(!stream || package.size() != stream->numItems) return;
+
+        ShmBridgeStream *streamHeader = stream->header;
+        uint64_t n = streamHeader->writeCount;
+        char *slotData = stream->slots + ((n & (streamHeader->numSlots-1)) *
+                                          streamHeader->slotSize);
+        ShmBridgeSlot *slot = (ShmBridgeSlot*)slotData;
+        char *values = slotData + sizeof(ShmBridgeSlot);
+
+        slot->sequence = 0;
+        __sync_synchronize();
+        slot->time = getTimeMicro();
+        for(size_t i=0; i<stream->numItems; ++i) {
+          const DataItem &item = package[i];
+          char *value = values + stream->items[i].offset;
+          switch(stream->items[i].type) {
+          case SHM_BRIDGE_INT32: {
+            int32_t v = item.i;
+            memcpy(value, &v, 4);
+            break;
+          }
+          case SHM_BRIDGE_UINT32: {
+            uint32_t v = item.ui;
+            memcpy(value, &v, 4);
+            break;
+          }
+          case SHM_BRIDGE_INT64: {
+            int64_t v = item.l;
+            memcpy(value, &v, 8);
+            break;
+          }
+          case SHM_BRIDGE_UINT64: {
+            uint64_t v = item.ul;
+            memcpy(value, &v, 8);
+            break;
+          }
+          case SHM_BRIDGE_FLOAT:
+            memcpy(value, &item.f, 4);
+            break;
+          case SHM_BRIDGE_DOUBLE:
+            memcpy(value, &item.d, 8);
+            break;
+          case SHM_BRIDGE_BOOL:
+            *value = item.b ? 1 : 0;
+            break;
+          case SHM_BRIDGE_STRING:
+            strncpy(value, item.s.c_str(), SHM_BRIDGE_STRING_SIZE-1);
+            value[SHM_BRIDGE_STRING_SIZE-1] = '\0';
+            break;
+          default:
+            break;
+          }
+        }
+        __sync_synchronize();
+        slot->sequence = n+1;
+        __sync_synchronize();
+        streamHeader->writeCount = n+1;
+      }
+
+      void ShmBridge::cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property) {
+        if(_property.paramId == cfgStreams.paramId) {
+          cfgStreams.sValue = _property.sValue;
+          setStreams(cfgStreams.sValue);
+        }
+      }
+
+    } // end of namespace shm_bridge
+  } // end of namespace plugins
+} // end of namespace mars
+
+DESTROY_LIB(mars::plugins::shm_bridge::ShmBridge);
+CREATE_LIB(mars::plugins::shm_bridge::ShmBridge);
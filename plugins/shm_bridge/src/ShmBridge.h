@@ -0,0 +1,126 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ShmBridge.h
+ * \brief "ShmBridge" mirrors DataBroker streams into a POSIX shared memory
+ *        segment.
+ *
+ * The streams are selected by the cfg property "ShmBridge/streams", a list
+ * of "groupName/dataName" patterns separated by ';'. The group name ends at
+ * the first '/' and both names may contain wildcards. Every stream gets a
+ * ring buffer in the segment "ShmBridge/segment" which is filled in the
+ * thread of the producer. The layout is described in ShmBridgeLayout.h,
+ * the ShmBridgeReader reads it from other processes.
+ *
+ * The segment, its size and the number of slots per stream are read when
+ * the library is loaded.
+ */
+
+#ifndef MARS_PLUGINS_SHM_BRIDGE_H
+#define MARS_PLUGINS_SHM_BRIDGE_H
+
+#ifdef _PRINT_HEADER_
+  #warning "ShmBridge.h"
+#endif
+
+#include "ShmBridgeLayout.h"
+
+#include <lib_manager/LibInterface.hpp>
+#include <mars/data_broker/ReceiverInterface.h>
+#include <mars/cfg_manager/CFGManagerInterface.h>
+#include <mars/cfg_manager/CFGClient.h>
+#include <mars/utils/ReadWriteLock.h>
+
+#include <string>
+#include <vector>
+
+namespace mars {
+
+  namespace data_broker {
+    class DataBrokerInterface;
+  }
+
+  namespace plugins {
+    namespace shm_bridge {
+
+      /// \cond HIDDEN_SYMBOLS
+      struct ShmStream {
+        ShmBridgeStream *header;
+        const ShmBridgeItem *items;
+        char *slots;
+        size_t numItems;
+      };
+      /// \endcond
+
+      class ShmBridge : public lib_manager::LibInterface,
+                        public data_broker::ReceiverInterface,
+                        public cfg_manager::CFGClient {
+
+      public:
+        ShmBridge(lib_manager::LibManager *theManager);
+        ~ShmBridge();
+
+        // LibInterface methods
+        int getLibVersion() const
+        { return 1; }
+        const std::string getLibName() const
+        { return std::string("shm_bridge"); }
+        CREATE_MODULE_INFO();
+
+        // DataBrokerReceiver methods
+        virtual void receiveData(const data_broker::DataInfo &info,
+                                 const data_broker::DataPackage &package,
+                                 int callbackParam);
+        // CFGClient methods
+        virtual void cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property);
+
+      private:
+        bool openSegment();
+        void closeSegment();
+        void setStreams(const std::string &streams);
+        ShmStream* getStream(const data_broker::DataInfo &info,
+                             const data_broker::DataPackage &package);
+        ShmStream* createStream(const data_broker::DataInfo &info,
+                                const data_broker::DataPackage &package);
+
+        data_broker::DataBrokerInterface *dataBroker;
+        cfg_manager::CFGManagerInterface *cfg;
+        cfg_manager::cfgPropertyStruct cfgStreams;
+        std::vector<std::pair<std::string, std::string> > patterns;
+
+        std::string segmentName;
+        char *segment;
+        size_t segmentSize, segmentUsed;
+        unsigned int numSlots;
+        ShmBridgeHeader *header;
+
+        /// indexed by the dataId, NULL for streams that are not mirrored
+        std::vector<ShmStream*> streams;
+        std::vector<bool> skippedStreams;
+        utils::ReadWriteLock streamsLock;
+
+      }; // end of class definition ShmBridge
+
+    } // end of namespace shm_bridge
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_SHM_BRIDGE_H
@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ShmBridgeLayout.h
+ * \brief Layout of the shared memory segment written by the ShmBridge.
+ *
+ * The header is plain C so that readers in other languages can map the
+ * segment directly.
+ *
+ * The segment starts with a ShmBridgeHeader followed by maxStreams
+ * ShmBridgeStream entries. The first numStreams entries are valid. Every
+ * stream points to its ShmBridgeItem table and to a ring of numSlots
+ * slots. A slot is a ShmBridgeSlot followed by the values of the items at
+ * their offsets. Strings are stored zero terminated with at most
+ * SHM_BRIDGE_STRING_SIZE bytes.
+ *
+ * There is one writer per stream. It writes the sample n into the slot
+ * n % numSlots: it sets the sequence of the slot to 0, writes the values,
+ * sets the sequence to n+1 and then writeCount to n+1. A reader copies a
+ * slot and accepts the copy if the sequence was n+1 before and after the
+ * copy. Otherwise the writer has overtaken the reader.
+ */
+
+#ifndef MARS_PLUGINS_SHM_BRIDGE_LAYOUT_H
+#define MARS_PLUGINS_SHM_BRIDGE_LAYOUT_H
+
+#ifdef _PRINT_HEADER_
+  #warning "ShmBridgeLayout.h"
+#endif
+
+#include <stdint.h>
+
+#define SHM_BRIDGE_MAGIC 0x42484d53 /* "SMHB" */
+#define SHM_BRIDGE_VERSION 1
+#define SHM_BRIDGE_NAME_SIZE 64
+#define SHM_BRIDGE_STRING_SIZE 64
+
+#ifdef __cplusplus
+namespace mars {
+  namespace plugins {
+    namespace shm_bridge {
+#endif
+
+      enum ShmBridgeType {
+        SHM_BRIDGE_UNDEFINED,
+        SHM_BRIDGE_INT32,
+        SHM_BRIDGE_UINT32,
+        SHM_BRIDGE_INT64,
+        SHM_BRIDGE_UINT64,
+        SHM_BRIDGE_FLOAT,
+        SHM_BRIDGE_DOUBLE,
+        SHM_BRIDGE_BOOL,
+        SHM_BRIDGE_STRING
+      };
+
+      typedef struct {
+        /** set after the segment is initialized */
+        volatile uint32_t magic;
+        uint32_t version;
+        uint32_t maxStreams;
+        volatile uint32_t numStreams;
+        uint64_t size;
+      } ShmBridgeHeader;
+
+      typedef struct {
+        char groupName[SHM_BRIDGE_NAME_SIZE];
+        char dataName[SHM_BRIDGE_NAME_SIZE];
+        uint32_t numItems;
+        uint32_t slotSize; /**< including the ShmBridgeSlot */
+        uint32_t numSlots; /**< a power of two */
+        uint32_t reserved;
+        uint64_t itemsOffset; /**< from the start of the segment */
+        uint64_t slotsOffset; /**< from the start of the segment */
+        volatile uint64_t writeCount;
+      } ShmBridgeStream;
+
+      typedef struct {
+        char name[SHM_BRIDGE_NAME_SIZE];
+        uint32_t type; /**< a ShmBridgeType */
+        uint32_t offset; /**< from the start of the values of a slot */
+      } ShmBridgeItem;
+
+      typedef struct {
+        /** the number of the sample plus one, 0 while it is written */
+        volatile uint64_t sequence;
+        /** time of the writer in microseconds */
+        int64_t time;
+      } ShmBridgeSlot;
+
+#ifdef __cplusplus
+    } // end of namespace shm_bridge
+  } // end of namespace plugins
+} // end of namespace mars
+#endif
+
+#endif // MARS_PLUGINS_SHM_BRIDGE_LAYOUT_H
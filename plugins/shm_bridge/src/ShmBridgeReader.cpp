@@ -0,0 +1,273 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ShmBridgeReader.cpp
+ * \brief "ShmBridgeReader" reads the streams a ShmBridge writes into shared
+ *        memory.
+ */
+
+#include "ShmBridgeReader.h"
+
+#include <cstring>
+
+#ifndef WIN32
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+namespace mars {
+  namespace plugins {
+    namespace shm_bridge {
+
+      ShmBridgeReader::ShmBridgeReader()
+        : segment(NULL), segmentSize(0), header(NULL) {
+      }
+
+      ShmBridgeReader::~ShmBridgeReader() {
+        close();
+      }
+
+      bool ShmBridgeReader::open(const std::string &segmentName) {
+        close();
+#ifdef WIN32
+        return false;
+#else
+        struct stat segmentStat;
+        void *region;
+        int fd = shm_open(segmentName.c_str(), O_RDONLY, 0);
+        if(fd < 0) return false;
+        if(fstat(fd, &segmentStat) != 0 ||
+           (size_t)segmentStat.st_size < sizeof(ShmBridgeHeader)) {
+          ::close(fd);
+          return false;
+        }
+        segmentSize = segmentStat.st_size;
+        region = mmap(NULL, segmentSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(region == MAP_FAILED) return false;
+        segment = (const char*)region;
+        header = (const ShmBridgeHeader*)segment;
+        if(header->magic != SHM_BRIDGE_MAGIC ||
+           header->version != SHM_BRIDGE_VERSION) {
+          close();
+          return false;
+        }
+        __sync_synchronize();
+        return true;
+#endif
+      }
+
+      void ShmBridgeReader::close() {
+#ifndef WIN32
+        if(segment) {
+          munmap((void*)segment, segmentSize);
+        }
+#endif
+        segment = NULL;
+        segmentSize = 0;
+        header = NULL;
+      }
+
+      bool ShmBridgeReader::isOpen() const {
+        return segment != NULL;
+      }
+
+      unsigned int ShmBridgeReader::getNumStreams() const {
+        unsigned int numStreams;
+        if(!header) return 0;
+        numStreams = header->numStreams;
+        // the stream headers are written before the count
+        __sync_synchronize();
+        return numStreams;
+      }
+
+      const ShmBridgeStream* ShmBridgeReader::getStream(unsigned int stream) const {
+        if(stream >= getNumStreams()) return NULL;
+        return ((const ShmBridgeStream*)(header+1)) + stream;
+      }
+
+      const ShmBridgeItem* ShmBridgeReader::getItem(unsigned int stream,
+                                                    unsigned int item) const {
+        const ShmBridgeStream *streamHeader = getStream(stream);
+        if(!streamHeader || item >= streamHeader->numItems) return NULL;
+        return ((const ShmBridgeItem*)(segment +
+                                       streamHeader->itemsOffset)) + item;
+      }
+
+      int ShmBridgeReader::getStreamIndex(const std::string &groupName,
+                                          const std::string &dataName) const {
+        unsigned int numStreams = getNumStreams();
+        const ShmBridgeStream *streams = (const ShmBridgeStream*)(header+1);
+        for(unsigned int i=0; i<numStreams; ++i) {
+          if(groupName == streams[i].groupName &&
+             dataName == streams[i].dataName) {
+            return i;
+          }
+        }
+        return -1;
+      }
+
+      std::string ShmBridgeReader::getGroupName(unsigned int stream) const {
+        const ShmBridgeStream *streamHeader = getStream(stream);
+        return streamHeader ? streamHeader->groupName : "";
+      }
+
+      std::string ShmBridgeReader::getDataName(unsigned int stream) const {
+        const ShmBridgeStream *streamHeader = getStream(stream);
+        return streamHeader ? streamHeader->dataName : "";
+      }
+
+      unsigned int ShmBridgeReader::getNumItems(unsigned int stream) const {
+        const ShmBridgeStream *streamHeader = getStream(stream);
+        return streamHeader ? streamHeader->numItems : 0;
+      }
+
+      int ShmBridgeReader::getItemIndex(unsigned int stream,
+                                        const std::string &name) const {
+        unsigned int numItems = getNumItems(stream);
+        for(unsigned int i=0; i<numItems; ++i) {
+          if(name == getItem(stream, i)->name) return i;
+        }
+        return -1;
+      }
+
+      std::string ShmBridgeReader::getItemName(unsigned int stream,
+                                               unsigned int item) const {
+        const ShmBridgeItem *itemHeader = getItem(stream, item);
+        return itemHeader ? itemHeader->name : "";
+      }
+
+      ShmBridgeType ShmBridgeReader::getItemType(unsigned int stream,
+                                                 unsigned int item) const {
+        const ShmBridgeItem *itemHeader = getItem(stream, item);
+        return itemHeader ? (ShmBridgeType)itemHeader->type : SHM_BRIDGE_UNDEFINED;
+      }
+
+      unsigned int ShmBridgeReader::getSampleSize(unsigned int stream) const {
+        const ShmBridgeStream *streamHeader = getStream(stream);
+        if(!streamHeader) return 0;
+        return streamHeader->slotSize - sizeof(ShmBridgeSlot);
+      }
+
+      uint64_t ShmBridgeReader::getWriteCount(unsigned int stream) const {
+        const ShmBridgeStream *streamHeader = getStream(stream);
+        return streamHeader ? streamHeader->writeCount : 0;
+      }
+
+      bool ShmBridgeReader::readNext(unsigned int stream, uint64_t *cursor,
+                                     void *sample, int64_t *time,
+                                     uint64_t *lost) const {
+        const ShmBridgeStream *streamHeader = getStream(stream);
+        const ShmBridgeSlot *slot;
+        uint64_t writeCount, sequence;
+        int64_t slotTime;
+
+        if(!streamHeader) return false;
+        while(true) {
+          writeCount = streamHeader->writeCount;
+          __sync_synchronize();
+          if(*cursor >= writeCount) return false;
+          // skip the samples that are already overwritten
+          if(writeCount - *cursor > streamHeader->numSlots) {
+            if(lost) *lost += writeCount - streamHeader->numSlots - *cursor;
+            *cursor = writeCount - streamHeader->numSlots;
+          }
+          slot = (const ShmBridgeSlot*)(segment + streamHeader->slotsOffset +
+                                        ((*cursor & (streamHeader->numSlots-1)) *
+                                         streamHeader->slotSize));
+          sequence = slot->sequence;
+          __sync_synchronize();
+          if(sequence == *cursor+1) {
+            slotTime = slot->time;
+            memcpy(sample, slot+1,
+                   streamHeader->slotSize - sizeof(ShmBridgeSlot));
+            __sync_synchronize();
+            if(slot->sequence == sequence) {
+              if(time) *time = slotTime;
+              *cursor += 1;
+              return true;
+            }
+          }
+          // the writer overtook us while we were reading the slot
+          if(lost) *lost += 1;
+          *cursor += 1;
+        }
+      }
+
+      double ShmBridgeReader::getDouble(unsigned int stream, unsigned int item,
+                                        const void *sample) const {
+        const ShmBridgeItem *itemHeader = getItem(stream, item);
+        const char *value;
+        if(!itemHeader) return 0.0;
+        value = (const char*)sample + itemHeader->offset;
+        switch(itemHeader->type) {
+        case SHM_BRIDGE_INT32: {
+          int32_t v;
+          memcpy(&v, value, 4);
+          return v;
+        }
+        case SHM_BRIDGE_UINT32: {
+          uint32_t v;
+          memcpy(&v, value, 4);
+          return v;
+        }
+        case SHM_BRIDGE_INT64: {
+          int64_t v;
+          memcpy(&v, value, 8);
+          return v;
+        }
+        case SHM_BRIDGE_UINT64: {
+          uint64_t v;
+          memcpy(&v, value, 8);
+          return v;
+        }
+        case SHM_BRIDGE_FLOAT: {
+          float v;
+          memcpy(&v, value, 4);
+          return v;
+        }
+        case SHM_BRIDGE_DOUBLE: {
+          double v;
+          memcpy(&v, value, 8);
+          return v;
+        }
+        case SHM_BRIDGE_BOOL:
+          return *value ? 1.0 : 0.0;
+        default:
+          return 0.0;
+        }
+      }
+
+      std::string ShmBridgeReader::getString(unsigned int stream,
+                                             unsigned int item,
+                                             const void *sample) const {
+        const ShmBridgeItem *itemHeader = getItem(stream, item);
+        const char *value;
+        if(!itemHeader || itemHeader->type != SHM_BRIDGE_STRING) return "";
+        value = (const char*)sample + itemHeader->offset;
+        return std::string(value, strnlen(value, SHM_BRIDGE_STRING_SIZE));
+      }
+
+    } // end of namespace shm_bridge
+  } // end of namespace plugins
+} // end of namespace mars
@@ -0,0 +1,133 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ShmBridgeReader.h
+ * \brief "ShmBridgeReader" reads the streams a ShmBridge writes into shared
+ *        memory.
+ *
+ * The reader only maps the segment, reading a sample does not need a
+ * system call. It does not depend on other MARS libraries and can be
+ * used in any process on the host of the simulation.
+ */
+
+#ifndef MARS_PLUGINS_SHM_BRIDGE_READER_H
+#define MARS_PLUGINS_SHM_BRIDGE_READER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "ShmBridgeReader.h"
+#endif
+
+#include "ShmBridgeLayout.h"
+
+#include <string>
+
+namespace mars {
+  namespace plugins {
+    namespace shm_bridge {
+
+      class ShmBridgeReader {
+      public:
+        ShmBridgeReader();
+        ~ShmBridgeReader();
+
+        /**
+         * \brief Maps the segment of a ShmBridge.
+         * \return \c false if the segment does not exist or is not
+         *         initialized yet.
+         */
+        bool open(const std::string &segmentName="/mars_shm_bridge");
+        void close();
+        bool isOpen() const;
+
+        /**
+         * \brief Returns the number of streams. Streams are added while
+         *        the simulation runs, their index does not change.
+         */
+        unsigned int getNumStreams() const;
+
+        /**
+         * \return The index of the stream or -1 if it does not exist (yet).
+         */
+        int getStreamIndex(const std::string &groupName,
+                           const std::string &dataName) const;
+        std::string getGroupName(unsigned int stream) const;
+        std::string getDataName(unsigned int stream) const;
+
+        unsigned int getNumItems(unsigned int stream) const;
+        /**
+         * \return The index of the item or -1 if it does not exist.
+         */
+        int getItemIndex(unsigned int stream, const std::string &name) const;
+        std::string getItemName(unsigned int stream, unsigned int item) const;
+        ShmBridgeType getItemType(unsigned int stream,
+                                  unsigned int item) const;
+
+        /**
+         * \brief Returns the size of the buffer that is passed to readNext.
+         */
+        unsigned int getSampleSize(unsigned int stream) const;
+
+        /**
+         * \brief Returns the number of samples written into the stream.
+         *        Use it as cursor to read only new samples.
+         */
+        uint64_t getWriteCount(unsigned int stream) const;
+
+        /**
+         * \brief Copies the next sample of a stream.
+         * \param cursor The number of the sample to read. It is advanced
+         *               behind the sample that was read.
+         * \param sample A buffer of getSampleSize() bytes.
+         * \param time If not \c NULL the time of the sample in microseconds.
+         * \param lost If not \c NULL the number of samples that were
+         *             overwritten before they could be read is added.
+         * \return \c false if there is no sample after the cursor.
+         */
+        bool readNext(unsigned int stream, uint64_t *cursor, void *sample,
+                      int64_t *time=NULL, uint64_t *lost=NULL) const;
+
+        /**
+         * \brief Returns a numeric item of a sample converted to double.
+         */
+        double getDouble(unsigned int stream, unsigned int item,
+                         const void *sample) const;
+        std::string getString(unsigned int stream, unsigned int item,
+                              const void *sample) const;
+
+      private:
+        // disallow copying
+        ShmBridgeReader(const ShmBridgeReader &);
+        ShmBridgeReader &operator=(const ShmBridgeReader &);
+
+        const ShmBridgeStream* getStream(unsigned int stream) const;
+        const ShmBridgeItem* getItem(unsigned int stream,
+                                     unsigned int item) const;
+
+        const char *segment;
+        size_t segmentSize;
+        const ShmBridgeHeader *header;
+      };
+
+    } // end of namespace shm_bridge
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_SHM_BRIDGE_READER_H
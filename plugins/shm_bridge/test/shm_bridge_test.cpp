@@ -0,0 +1,158 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file shm_bridge_test.cpp
+ * \brief Streams samples at 10 kHz through a ShmBridge to a reader in
+ *        another process.
+ *
+ * The writer process pushes 20000 samples into a DataBroker with a ShmBridge.
+ * A forked reader process polls the segment with the ShmBridgeReader and
+ * checks that it gets every sample once, in order and with the values
+ * that were pushed.
+ */
+
+#include "ShmBridge.h"
+#include "ShmBridgeReader.h"
+
+#include <mars/data_broker/DataBroker.h>
+#include <mars/cfg_manager/CFGManager.h>
+#include <mars/utils/misc.h>
+#include <lib_manager/LibManager.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace mars;
+using namespace mars::plugins::shm_bridge;
+
+static const long numSamples = 20000;
+static const long samplePeriod = 100; // us, 10 kHz
+static const long long readTimeout = 10000000; // us
+
+static const char* getParity(long i) {
+  return (i%2) ? "odd" : "even";
+}
+
+static int runReader(const std::string &segmentName) {
+  ShmBridgeReader reader;
+  std::vector<char> sample;
+  uint64_t cursor = 0, lost = 0;
+  long numRead = 0;
+  long long startTime = utils::getTimeMicro();
+  int stream = -1, xItem, parityItem;
+  bool ok = true;
+
+  while(!reader.open(segmentName) || (stream = reader.getStreamIndex("test", "samples")) < 0) {
+    if(utils::getTimeMicro() - startTime > readTimeout) {
+      printf("reader: the stream was not created\n");
+      return 1;
+    }
+    utils::msleep(1);
+  }
+  sample.resize(reader.getSampleSize(stream));
+  xItem = reader.getItemIndex(stream, "x");
+  parityItem = reader.getItemIndex(stream, "parity");
+  if(xItem < 0 || parityItem < 0) {
+    printf("reader: the items were not found\n");
+    return 1;
+  }
+
+  // poll the ring without sleeping, as a consumer at full step rate would
+  while(numRead + (long)lost < numSamples) {
+    if(utils::getTimeMicro() - startTime > readTimeout) {
+      printf("reader: timeout\n");
+      ok = false;
+      break;
+    }
+    if(!reader.readNext(stream, &cursor, &sample[0], NULL, &lost)) {
+      continue;
+    }
+    long x = (long)reader.getDouble(stream, xItem, &sample[0]);
+    if(x != numRead + (long)lost ||
+       reader.getString(stream, parityItem, &sample[0]) != getParity(x)) {
+      ok = false;
+    }
+    ++numRead;
+  }
+  printf("reader: %ld samples read, %lu lost\n", numRead,
+         (unsigned long)lost);
+  return (ok && lost == 0 && numRead == numSamples) ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+  // the libraries are not cleared, they are released at the end of the
+  // process
+  lib_manager::LibManager *libManager = new lib_manager::LibManager();
+  cfg_manager::CFGManager *cfg = new cfg_manager::CFGManager(libManager);
+  data_broker::DataBroker *dataBroker = new data_broker::DataBroker(libManager);
+  data_broker::DataPackage package;
+  ShmBridge *bridge;
+  unsigned long id;
+  long long startTime, time;
+  char segmentName[64];
+  int status = 1;
+  pid_t pid;
+
+  libManager->addLibrary(cfg);
+  libManager->addLibrary(dataBroker);
+  sprintf(segmentName, "/mars_shm_bridge_test_%d", (int)getpid());
+  cfg->getOrCreateProperty("ShmBridge", "segment", std::string(segmentName));
+  cfg->getOrCreateProperty("ShmBridge", "size MB", 16);
+  // the ring holds all samples, a reader that is descheduled loses none
+  cfg->getOrCreateProperty("ShmBridge", "slots", 32768);
+  cfg->getOrCreateProperty("ShmBridge", "streams", std::string("test/*"));
+  bridge = new ShmBridge(libManager);
+
+  fflush(stdout);
+  pid = fork();
+  if(pid == 0) {
+    status = runReader(segmentName);
+    fflush(stdout);
+    _exit(status);
+  }
+  if(pid < 0) {
+    printf("writer: fork failed\n");
+    return 1;
+  }
+
+  package.add("x", 0.0);
+  package.add("parity", std::string(getParity(0)));
+  id = dataBroker->pushData("test", "samples", package, NULL,
+                            data_broker::DATA_PACKAGE_READ_FLAG);
+  startTime = utils::getTimeMicro();
+  for(long i=1; i<numSamples; ++i) {
+    while(utils::getTimeMicro() < startTime + i*samplePeriod) ;
+    package.set(0, (double)i);
+    package.set(1, std::string(getParity(i)));
+    dataBroker->pushData(id, package);
+  }
+  time = utils::getTimeMicro() - startTime;
+  printf("writer: %ld samples in %lld us\n", numSamples, time);
+
+  waitpid(pid, &status, 0);
+  // unlinks the segment
+  delete bridge;
+  return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
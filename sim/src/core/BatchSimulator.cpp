@@ -0,0 +1,446 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file BatchSimulator.cpp
+ *
+ */
+
+#include "BatchSimulator.h"
+#include "Simulator.h"
+
+#include <mars/data_broker/DataBroker.h>
+#include <mars/interfaces/sim/ControlCenter.h>
+#include <mars/interfaces/sim/LoadCenter.h>
+#include <mars/interfaces/sim/NodeManagerInterface.h>
+#include <mars/interfaces/sim/JointManagerInterface.h>
+#include <mars/interfaces/sim/MotorManagerInterface.h>
+#include <mars/interfaces/NodeData.h>
+#include <mars/interfaces/JointData.h>
+#include <mars/interfaces/MotorData.h>
+#include <mars/interfaces/terrainStruct.h>
+#include <mars/interfaces/core_objects_exchange.h>
+#include <mars/interfaces/Logging.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+namespace mars {
+  namespace sim {
+
+    using namespace utils;
+    using namespace interfaces;
+
+    /**
+     * \brief Provides the mesh and heightmap data of the copied scene to
+     * the NodeManagers of the batch worlds.
+     *
+     * The meshes handed to the worlds already point to the shared data and
+     * are marked as shared, so neither the SimNodes nor the physics copy or
+     * free them. Nodes without data are forwarded to the loaders of the
+     * source scene.
+     */
+    class BatchSceneLoader : public LoadMeshInterface,
+                             public LoadHeightmapInterface {
+    public:
+      BatchSceneLoader() : source(0) {}
+
+      void getPhysicsFromMesh(NodeData *node) {
+        if(node->mesh.shared) return;
+        if(source && source->loadMesh) {
+          source->loadMesh->getPhysicsFromMesh(node);
+        }
+        else {
+          LOG_ERROR("BatchSimulator: no mesh data for node \"%s\"",
+                    node->name.c_str());
+        }
+      }
+
+      std::vector<double> getMeshSize(const std::string &filename) {
+        if(source && source->loadMesh) {
+          return source->loadMesh->getMeshSize(filename);
+        }
+        return std::vector<double>(3, 0.0);
+      }
+
+      void readPixelData(terrainStruct *terrain) {
+        if(terrain->pixelData) {
+          terrain->pixelData = copyPixelData(terrain);
+        }
+        else if(source && source->loadHeightmap) {
+          source->loadHeightmap->readPixelData(terrain);
+        }
+      }
+
+      static double* copyPixelData(const terrainStruct *terrain) {
+        size_t size = (size_t)terrain->width*terrain->height;
+        double *pixelData = (double*)calloc(size, sizeof(double));
+        memcpy(pixelData, terrain->pixelData, sizeof(double)*size);
+        return pixelData;
+      }
+
+      LoadCenter *source;
+    };
+
+    /**
+     * \brief Executes one operation of the BatchSimulator for every
+     * world.
+     */
+    class BatchJob : public ParallelJob {
+    public:
+      enum Type {
+        RESET,
+        STEP,
+        OBSERVE
+      };
+
+      BatchJob(BatchSimulator *batch, Type type) : batch(batch), type(type) {}
+
+      void runJob(std::size_t index) {
+        switch(type) {
+        case RESET:
+          batch->resetWorld(index);
+          break;
+        case STEP:
+          batch->stepWorld(index);
+          break;
+        case OBSERVE:
+          batch->observeWorld(index);
+          break;
+        }
+      }
+
+    private:
+      BatchSimulator *batch;
+      Type type;
+    };
+
+    static const size_t observationNodeSize = 13;
+
+    BatchSimulator::BatchSimulator(lib_manager::LibManager *theManager,
+                                   size_t numWorlds, size_t numThreads)
+      : libManager(theManager), jobActions(0), jobObservations(0),
+        jobSteps(0), actionSize(0), numObservationNodes(0),
+        numObservationMotors(0) {
+
+      sceneLoader = new BatchSceneLoader();
+      setNumThreads(numThreads);
+
+      worlds.resize(numWorlds);
+      for(size_t i=0; i<numWorlds; ++i) {
+        World &world = worlds[i];
+        world.dataBroker = new data_broker::DataBroker(libManager);
+        world.sim = new Simulator(libManager, world.dataBroker);
+        world.control = world.sim->getControlCenter();
+        world.control->loadCenter->loadMesh = sceneLoader;
+        world.control->loadCenter->loadHeightmap = sceneLoader;
+        world.sim->runSimulation(false);
+      }
+    }
+
+    BatchSimulator::~BatchSimulator() {
+      // a world deletes its managers, physics and ControlCenter with the
+      // Simulator and needs its DataBroker until then
+      for(size_t i=0; i<worlds.size(); ++i) {
+        worlds[i].sim->newWorld(true);
+        delete worlds[i].sim;
+        delete worlds[i].dataBroker;
+      }
+      clearSharedMeshes();
+      delete sceneLoader;
+    }
+
+    size_t BatchSimulator::getNumWorlds() const {
+      return worlds.size();
+    }
+
+    ControlCenter* BatchSimulator::getControlCenter(size_t world) const {
+      if(world >= worlds.size()) return 0;
+      return worlds[world].control;
+    }
+
+    void BatchSimulator::setNumThreads(size_t numThreads) {
+      pool.setNumThreads(numThreads > 1 ? numThreads-1 : 0);
+    }
+
+    void BatchSimulator::clearSharedMeshes() {
+      for(size_t i=0; i<sharedMeshes.size(); ++i) {
+        delete[] sharedMeshes[i].vertices;
+        delete[] sharedMeshes[i].indices;
+      }
+      sharedMeshes.clear();
+    }
+
+    bool BatchSimulator::copyScene(ControlCenter *source) {
+      std::vector<core_objects_exchange> objList;
+      std::vector<NodeData> nodes;
+      std::vector<JointData> joints;
+      std::vector<MotorData> motors;
+      std::vector<core_objects_exchange>::iterator it;
+      bool ok = true;
+
+      for(size_t i=0; i<worlds.size(); ++i) {
+        worlds[i].sim->newWorld(true);
+      }
+
+      // collect the scene once; the meshes are shared by all worlds
+      clearSharedMeshes();
+      source->nodes->getListNodes(&objList);
+      for(it=objList.begin(); it!=objList.end(); ++it) {
+        NodeData node = source->nodes->getFullNode(it->index);
+        if(node.mesh.vertices) {
+          snmesh mesh;
+          mesh.vertexcount = node.mesh.vertexcount;
+          mesh.indexcount = node.mesh.indexcount;
+          mesh.vertices = new mydVector3[mesh.vertexcount];
+          mesh.indices = new int[mesh.indexcount];
+          memcpy(mesh.vertices, node.mesh.vertices,
+                 sizeof(mydVector3)*mesh.vertexcount);
+          memcpy(mesh.indices, node.mesh.indices,
+                 sizeof(int)*mesh.indexcount);
+          mesh.shared = true;
+          sharedMeshes.push_back(mesh);
+          node.mesh = mesh;
+        }
+        // the positions are already absolute
+        node.relative_id = 0;
+        node.map.erase("vizLink");
+        nodes.push_back(node);
+      }
+      source->joints->getListJoints(&objList);
+      for(it=objList.begin(); it!=objList.end(); ++it) {
+        joints.push_back(source->joints->getFullJoint(it->index));
+      }
+      source->motors->getListMotors(&objList);
+      for(it=objList.begin(); it!=objList.end(); ++it) {
+        motors.push_back(source->motors->getFullMotor(it->index));
+      }
+      sceneLoader->source = source->loadCenter;
+
+      for(size_t i=0; i<worlds.size(); ++i) {
+        ControlCenter *control = worlds[i].control;
+        std::map<unsigned long, unsigned long> nodeMap, jointMap;
+
+        for(size_t k=0; k<nodes.size(); ++k) {
+          NodeData node = nodes[k];
+          // the SimNode takes the ownership of these
+          if(node.c_params.friction_direction1) {
+            node.c_params.friction_direction1 =
+              new Vector(*(node.c_params.friction_direction1));
+          }
+          if(node.terrain) {
+            node.terrain = new terrainStruct(*(node.terrain));
+            if(node.terrain->pixelData) {
+              node.terrain->pixelData = BatchSceneLoader::copyPixelData(node.terrain);
+            }
+          }
+          NodeId id = control->nodes->addNode(&node);
+          if(id == INVALID_ID) {
+            LOG_ERROR("BatchSimulator: could not copy node \"%s\"",
+                      nodes[k].name.c_str());
+            ok = false;
+          }
+          nodeMap[nodes[k].index] = id;
+        }
+        for(size_t k=0; k<joints.size(); ++k) {
+          JointData joint = joints[k];
+          if(joint.nodeIndex1) joint.nodeIndex1 = nodeMap[joint.nodeIndex1];
+          if(joint.nodeIndex2) joint.nodeIndex2 = nodeMap[joint.nodeIndex2];
+          unsigned long id = control->joints->addJoint(&joint);
+          if(!id) {
+            LOG_ERROR("BatchSimulator: could not copy joint \"%s\"",
+                      joints[k].name.c_str());
+            ok = false;
+          }
+          jointMap[joints[k].index] = id;
+        }
+        for(size_t k=0; k<motors.size(); ++k) {
+          MotorData motor = motors[k];
+          motor.jointIndex = jointMap[motor.jointIndex];
+          if(motor.jointIndex2) motor.jointIndex2 = jointMap[motor.jointIndex2];
+          control->motors->addMotor(&motor);
+        }
+        control->motors->connectMimics();
+      }
+      return ok;
+    }
+
+    bool BatchSimulator::setActionMotors(const std::vector<std::string> &names) {
+      bool ok = true;
+      for(size_t i=0; i<worlds.size(); ++i) {
+        worlds[i].actionIds.clear();
+        for(size_t k=0; k<names.size(); ++k) {
+          unsigned long id = worlds[i].control->motors->getID(names[k]);
+          if(!id) {
+            if(i == 0) {
+              LOG_ERROR("BatchSimulator: unknown motor \"%s\"", names[k].c_str());
+            }
+            ok = false;
+          }
+          worlds[i].actionIds.push_back(id);
+        }
+      }
+      actionSize = names.size();
+      return ok;
+    }
+
+    bool BatchSimulator::setObservationNodes(const std::vector<std::string> &names) {
+      bool ok = true;
+      for(size_t i=0; i<worlds.size(); ++i) {
+        worlds[i].nodeIds.clear();
+        for(size_t k=0; k<names.size(); ++k) {
+          NodeId id = worlds[i].control->nodes->getID(names[k]);
+          if(id == INVALID_ID) {
+            if(i == 0) {
+              LOG_ERROR("BatchSimulator: unknown node \"%s\"", names[k].c_str());
+            }
+            ok = false;
+          }
+          worlds[i].nodeIds.push_back(id);
+        }
+      }
+      numObservationNodes = names.size();
+      return ok;
+    }
+
+    bool BatchSimulator::setObservationMotors(const std::vector<std::string> &names) {
+      bool ok = true;
+      for(size_t i=0; i<worlds.size(); ++i) {
+        worlds[i].motorIds.clear();
+        for(size_t k=0; k<names.size(); ++k) {
+          unsigned long id = worlds[i].control->motors->getID(names[k]);
+          if(!id) {
+            if(i == 0) {
+              LOG_ERROR("BatchSimulator: unknown motor \"%s\"", names[k].c_str());
+            }
+            ok = false;
+          }
+          worlds[i].motorIds.push_back(id);
+        }
+      }
+      numObservationMotors = names.size();
+      return ok;
+    }
+
+    size_t BatchSimulator::getActionSize() const {
+      return actionSize;
+    }
+
+    size_t BatchSimulator::getObservationSize() const {
+      return numObservationNodes*observationNodeSize + numObservationMotors;
+    }
+
+    void BatchSimulator::reset() {
+      jobWorlds.resize(worlds.size());
+      for(size_t i=0; i<worlds.size(); ++i) {
+        jobWorlds[i] = i;
+      }
+      BatchJob job(this, BatchJob::RESET);
+      pool.run(&job, jobWorlds.size());
+    }
+
+    void BatchSimulator::reset(const std::vector<size_t> &worldList) {
+      jobWorlds.clear();
+      for(size_t i=0; i<worldList.size(); ++i) {
+        if(worldList[i] < worlds.size()) {
+          jobWorlds.push_back(worldList[i]);
+        }
+      }
+      BatchJob job(this, BatchJob::RESET);
+      pool.run(&job, jobWorlds.size());
+    }
+
+    void BatchSimulator::step(const std::vector<sReal> &actions,
+                              unsigned int numSteps) {
+      if(actions.size() != worlds.size()*actionSize) {
+        LOG_ERROR("BatchSimulator::step: got %lu actions, expected %lu",
+                  (unsigned long)actions.size(),
+                  (unsigned long)(worlds.size()*actionSize));
+        return;
+      }
+      jobActions = &actions;
+      jobSteps = numSteps;
+      BatchJob job(this, BatchJob::STEP);
+      pool.run(&job, worlds.size());
+      jobActions = 0;
+    }
+
+    void BatchSimulator::observe(std::vector<sReal> *observations) {
+      observations->resize(worlds.size()*getObservationSize());
+      jobObservations = observations;
+      BatchJob job(this, BatchJob::OBSERVE);
+      pool.run(&job, worlds.size());
+      jobObservations = 0;
+    }
+
+    void BatchSimulator::resetWorld(size_t index) {
+      worlds[jobWorlds[index]].sim->resetWorld();
+    }
+
+    void BatchSimulator::stepWorld(size_t index) {
+      World &world = worlds[index];
+
+      for(size_t k=0; k<world.actionIds.size(); ++k) {
+        if(world.actionIds[k]) {
+          world.control->motors->setMotorValue(world.actionIds[k],
+                                               (*jobActions)[index*actionSize+k]);
+        }
+      }
+      for(unsigned int i=0; i<jobSteps; ++i) {
+        world.sim->step();
+      }
+    }
+
+    void BatchSimulator::observeWorld(size_t index) {
+      World &world = worlds[index];
+      Vector v;
+      Quaternion q;
+
+      if(jobObservations->empty()) return;
+      sReal *out = &((*jobObservations)[0]) + index*getObservationSize();
+
+      for(size_t k=0; k<world.nodeIds.size(); ++k) {
+        NodeId id = world.nodeIds[k];
+        v = world.control->nodes->getPosition(id);
+        *(out++) = v.x();
+        *(out++) = v.y();
+        *(out++) = v.z();
+        q = world.control->nodes->getRotation(id);
+        *(out++) = q.x();
+        *(out++) = q.y();
+        *(out++) = q.z();
+        *(out++) = q.w();
+        v = world.control->nodes->getLinearVelocity(id);
+        *(out++) = v.x();
+        *(out++) = v.y();
+        *(out++) = v.z();
+        v = world.control->nodes->getAngularVelocity(id);
+        *(out++) = v.x();
+        *(out++) = v.y();
+        *(out++) = v.z();
+      }
+      for(size_t k=0; k<world.motorIds.size(); ++k) {
+        *(out++) = world.control->motors->getActualPosition(world.motorIds[k]);
+      }
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file BatchSimulator.h
+ * \brief "BatchSimulator" runs several independent simulation worlds in
+ *        one process.
+ *
+ * Every world is a Simulator with its own ControlCenter, physics, managers
+ * and DataBroker. The scene is loaded once by the main simulator and
+ * copied into the worlds by copyScene(). Mesh and heightmap data are read
+ * from the source scene instead of parsing the files again for every
+ * world. The mesh arrays and their ODE trimesh data exist only once and
+ * are shared by all worlds. The worlds are stepped, reset and observed
+ * concurrently by a thread pool.
+ *
+ * Only nodes, joints and motors are copied. Sensors and controllers of
+ * the source scene are not part of the batch worlds.
+ */
+
+#ifndef BATCH_SIMULATOR_H
+#define BATCH_SIMULATOR_H
+
+#ifdef _PRINT_HEADER_
+  #warning "BatchSimulator.h"
+#endif
+
+#include <mars/interfaces/MARSDefs.h>
+#include <mars/interfaces/snmesh.h>
+#include <mars/utils/ThreadPool.h>
+
+#include <string>
+#include <vector>
+
+namespace lib_manager {
+  class LibManager;
+}
+
+namespace mars {
+
+  namespace data_broker {
+    class DataBroker;
+  }
+
+  namespace interfaces {
+    class ControlCenter;
+  }
+
+  namespace sim {
+
+    class Simulator;
+    class BatchSceneLoader;
+
+    class BatchSimulator {
+    public:
+      /**
+       * \brief Creates \a numWorlds empty worlds.
+       *
+       * \param numThreads The number of threads used to process the worlds
+       *                   including the calling thread. With one thread
+       *                   all worlds are processed serially.
+       */
+      BatchSimulator(lib_manager::LibManager *theManager, size_t numWorlds,
+                     size_t numThreads = 1);
+      ~BatchSimulator();
+
+      size_t getNumWorlds() const;
+      interfaces::ControlCenter* getControlCenter(size_t world) const;
+      void setNumThreads(size_t numThreads);
+
+      /**
+       * \brief Copies the nodes, joints and motors of \a source into all
+       * worlds.
+       *
+       * The source scene should not have been stepped, since the current
+       * state of its objects becomes the initial state of the worlds.
+       * \return \c false if an object could not be created in a world.
+       */
+      bool copyScene(interfaces::ControlCenter *source);
+
+      /**
+       * \brief Selects the motors that are set by the actions of step().
+       * \return \c false if a motor name is unknown.
+       */
+      bool setActionMotors(const std::vector<std::string> &names);
+      /**
+       * \brief Selects the nodes that are part of the observation.
+       *
+       * Every node adds its position (3), rotation quaternion (4, x y z w),
+       * linear velocity (3) and angular velocity (3) to the observation.
+       * \return \c false if a node name is unknown.
+       */
+      bool setObservationNodes(const std::vector<std::string> &names);
+      /**
+       * \brief Selects the motors whose actual position is appended to the
+       * node values of the observation.
+       * \return \c false if a motor name is unknown.
+       */
+      bool setObservationMotors(const std::vector<std::string> &names);
+
+      size_t getActionSize() const;
+      size_t getObservationSize() const;
+
+      /**
+       * \brief Resets all worlds to the state after copyScene().
+       */
+      void reset();
+      void reset(const std::vector<size_t> &worlds);
+
+      /**
+       * \brief Applies the actions and advances every world by
+       * \a numSteps physics steps.
+       *
+       * \param actions The actions of all worlds in a row, world after
+       *                world. Its size has to be
+       *                getNumWorlds()*getActionSize().
+       */
+      void step(const std::vector<interfaces::sReal> &actions,
+                unsigned int numSteps = 1);
+
+      /**
+       * \brief Collects the observations of all worlds in a row, world
+       * after world.
+       */
+      void observe(std::vector<interfaces::sReal> *observations);
+
+      // used by the jobs of the thread pool
+      void resetWorld(size_t world);
+      void stepWorld(size_t world);
+      void observeWorld(size_t world);
+
+    private:
+      struct World {
+        Simulator *sim;
+        data_broker::DataBroker *dataBroker;
+        interfaces::ControlCenter *control;
+        std::vector<unsigned long> actionIds;
+        std::vector<unsigned long> nodeIds;
+        std::vector<unsigned long> motorIds;
+      };
+
+      // disallow copying
+      BatchSimulator(const BatchSimulator &);
+      BatchSimulator &operator=(const BatchSimulator &);
+
+      void clearSharedMeshes();
+
+      lib_manager::LibManager *libManager;
+      std::vector<World> worlds;
+      std::vector<interfaces::snmesh> sharedMeshes;
+      BatchSceneLoader *sceneLoader;
+      utils::ThreadPool pool;
+
+      // data of the current job
+      std::vector<size_t> jobWorlds;
+      const std::vector<interfaces::sReal> *jobActions;
+      std::vector<interfaces::sReal> *jobObservations;
+      unsigned int jobSteps;
+      size_t actionSize, numObservationNodes, numObservationMotors;
+
+    }; // end of class BatchSimulator
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif  // BATCH_SIMULATOR_H
@@ -43,6 +43,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <cerrno>
 
 namespace mars {
   namespace sim {
@@ -54,6 +55,13 @@ namespace mars {
     bool Controller::sock_init = false;
 #endif
 
+#ifdef WIN32
+#define CONTROLLER_SEND_FLAGS 0
+#else
+// the pipelined mode must not block in send()
+#define CONTROLLER_SEND_FLAGS MSG_DONTWAIT
+#endif
+
     
     Controller::Controller(sReal rate,
                            const std::vector<SimMotor*> &motors,
@@ -86,6 +94,11 @@ namespace mars {
       dy = 0;
       dylibController = 0;
       count_ms = 0;
+      binaryProtocol = false;
+      sequence = 0;
+      sent = queuedFrame = 0;
+      received = 0;
+      resetRequested = false;
 #ifdef WIN32
       if(!Controller::sock_init) {
         /* Initialisiere TCP f�r Windows ("winsock") */
@@ -161,8 +174,7 @@ namespace mars {
       double *pt_sensors = t_sensors;
       double t_motors[100];
       double *pt_motors = t_motors;
-      int flags = 0, count_val, i, command;
-      sReal *sens_val;
+      int flags = 0, i, command;
       char *other_stuff = 0;
       char *pt_stuff;
       unsigned long command_id = 0;
@@ -175,9 +187,11 @@ namespace mars {
         if (dylibController) {
           for (i=0; i<100; i++) t_sensors[i] = t_motors[i] = 0;
           for (iter = sensors.begin(); iter != sensors.end(); iter++) {
-            count_val = (*iter)->getSensorData(&sens_val);
-            for(i=0; i<count_val; i++) *(pt_sensors++) = (double)sens_val[i];
-            free(sens_val);
+            SensorDataView view = (*iter)->getSensorView();
+            if(view.size) {
+              memcpy(pt_sensors, view.data, view.size*sizeof(double));
+              pt_sensors += view.size;
+            }
           }
           /*
           if (sParams.size()) {
@@ -409,6 +423,9 @@ namespace mars {
               (*jter)->setControlValue((sReal)*pt_motors);
           }
         }
+        else if(connected && binaryProtocol) {
+          updateBinary();
+        }
         else if(connected) {
           // here we can communicate
 #ifdef WIN32
@@ -773,6 +790,195 @@ namespace mars {
       }
     }
 
+    void Controller::updateBinary(void) {
+      std::vector<BaseSensor*>::iterator iter;
+
+      sensorValues.clear();
+      for(iter = sensors.begin(); iter != sensors.end(); iter++) {
+        SensorDataView view = (*iter)->getSensorView();
+        sensorValues.insert(sensorValues.end(), view.data,
+                            view.data+view.size);
+      }
+      uint64_t depth = 0;
+      if(sController.pipeline_depth > 0) depth = sController.pipeline_depth;
+      if(!sendFrame(CONTROLLER_FRAME_SENSORS, ++sequence, sensorValues,
+                    depth == 0)) {
+        connectionLost();
+        return;
+      }
+
+      // only the synchronous mode waits for the answer
+      do {
+        if(!receiveFrames(depth == 0)) {
+          connectionLost();
+          return;
+        }
+      } while(depth == 0 && !resetRequested &&
+              (motorFrames.empty() || motorFrames.back().first < sequence));
+
+      if(resetRequested) {
+        resetRequested = false;
+        motorFrames.clear();
+        control->sim->resetSim();
+        return;
+      }
+
+      // apply the newest frame that answers step sequence-depth or earlier
+      if(sequence <= depth) return;
+      uint64_t target = sequence - depth;
+      std::vector<double> values;
+      bool apply = false;
+      while(!motorFrames.empty() && motorFrames.front().first <= target) {
+        values.swap(motorFrames.front().second);
+        motorFrames.pop_front();
+        apply = true;
+      }
+      if(apply) {
+        for(size_t k=0; k<motors.size() && k<values.size(); ++k) {
+          motors[k]->setControlValue((sReal)values[k]);
+        }
+      }
+    }
+
+    /**
+     * Appends a frame to the send queue and sends as much of the queue as
+     * possible. A frame that is queued but not started yet is replaced. If
+     * \a wait is set it blocks until the whole queue is sent.
+     */
+    bool Controller::sendFrame(ControllerFrameType type, uint64_t seq,
+                               const std::vector<double> &values, bool wait) {
+      ControllerFrameHeader header;
+      size_t start;
+
+      if(sent <= queuedFrame && queuedFrame < sendBuffer.size()) {
+        // the remote controller only needs the newest values
+        sendBuffer.resize(queuedFrame);
+      }
+      if(sent) {
+        sendBuffer.erase(sendBuffer.begin(), sendBuffer.begin()+sent);
+        sent = 0;
+      }
+      header.magic = CONTROLLER_FRAME_MAGIC;
+      header.type = type;
+      header.sequence = seq;
+      header.count = values.size();
+      header.reserved = 0;
+      start = sendBuffer.size();
+      sendBuffer.resize(start+sizeof(header)+values.size()*sizeof(double));
+      memcpy(&sendBuffer[start], &header, sizeof(header));
+      if(!values.empty()) {
+        memcpy(&sendBuffer[start+sizeof(header)], &values[0],
+               values.size()*sizeof(double));
+      }
+      queuedFrame = start;
+      return flushFrames(wait);
+    }
+
+    /**
+     * Sends the queued frames. Without \a wait it returns as soon as the
+     * connection would block, the rest is sent with the next frame.
+     */
+    bool Controller::flushFrames(bool wait) {
+      fd_set writeSet;
+      struct timeval timeout;
+      int n;
+
+      while(sent < sendBuffer.size()) {
+        FD_ZERO(&writeSet);
+        FD_SET(conn, &writeSet);
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 0;
+        n = select(conn+1, NULL, &writeSet, NULL, wait ? NULL : &timeout);
+        if(n < 0) return false;
+        if(n == 0) return true;
+
+        n = send(conn, &sendBuffer[sent], sendBuffer.size()-sent,
+                 CONTROLLER_SEND_FLAGS);
+#ifndef WIN32
+        if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+#endif
+        if(n <= 0) return false;
+        sent += n;
+      }
+      return true;
+    }
+
+    /**
+     * Reads the available data from the connection and stores the motor
+     * frames it contains. If \a wait is set it blocks until some data was
+     * received, otherwise it returns when no more data is available.
+     */
+    bool Controller::receiveFrames(bool wait) {
+      ControllerFrameHeader header;
+      fd_set readSet;
+      struct timeval timeout;
+      size_t frameSize, offset;
+      int n;
+
+      if(receiveBuffer.size() < PACKAGE_SIZE) {
+        receiveBuffer.resize(PACKAGE_SIZE);
+      }
+      while(true) {
+        FD_ZERO(&readSet);
+        FD_SET(conn, &readSet);
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 0;
+        n = select(conn+1, &readSet, NULL, NULL, wait ? NULL : &timeout);
+        if(n < 0) return false;
+        if(n == 0) return true;
+
+        n = recv(conn, &receiveBuffer[received],
+                 receiveBuffer.size()-received, 0);
+        if(n <= 0) return false;
+        received += n;
+
+        offset = 0;
+        while(received-offset >= sizeof(header)) {
+          memcpy(&header, &receiveBuffer[offset], sizeof(header));
+          if(header.magic != CONTROLLER_FRAME_MAGIC ||
+             header.count > CONTROLLER_FRAME_MAX_COUNT) {
+            LOG_ERROR("Controller: received an invalid frame");
+            return false;
+          }
+          frameSize = sizeof(header)+header.count*sizeof(double);
+          if(frameSize > receiveBuffer.size()) {
+            // make room for the frame, the buffer only grows
+            receiveBuffer.resize(frameSize);
+          }
+          if(received-offset < frameSize) break;
+          if(header.type == CONTROLLER_FRAME_MOTORS) {
+            motorFrames.push_back(std::make_pair(header.sequence,
+                                                 std::vector<double>(header.count)));
+            if(header.count) {
+              memcpy(&(motorFrames.back().second[0]),
+                     &receiveBuffer[offset+sizeof(header)],
+                     header.count*sizeof(double));
+            }
+          }
+          else if(header.type == CONTROLLER_FRAME_RESET) {
+            resetRequested = true;
+          }
+          offset += frameSize;
+        }
+        if(offset) {
+          memmove(&receiveBuffer[0], &receiveBuffer[offset], received-offset);
+          received -= offset;
+        }
+        if(wait) return true;
+      }
+    }
+
+    void Controller::connectionLost(void) {
+      connected = false;
+      sock_state = 0;
+      sendBuffer.clear();
+      sent = queuedFrame = 0;
+      received = 0;
+      resetRequested = false;
+      motorFrames.clear();
+      LOG_ERROR("Controller: connection lost");
+    }
+
     int Controller::getSReal(const char *data, sReal *value) const {
       size_t d=0, i=0;
       const size_t BUFFER_SIZE = 50;
@@ -1011,6 +1217,17 @@ namespace mars {
       }
     }
 
+    void Controller::setProtocol(const std::string &protocol,
+                                 int pipeline_depth) {
+      sController.protocol = protocol;
+      sController.pipeline_depth = pipeline_depth;
+      binaryProtocol = (protocol == "binary");
+      if(!binaryProtocol && protocol != "ascii") {
+        LOG_WARN("Controller: unknown protocol \"%s\", using ascii",
+                 protocol.c_str());
+      }
+    }
+
     void Controller::setAutoMode(bool mode) {
       auto_connect = mode;
     }
@@ -1046,15 +1263,12 @@ namespace mars {
 
     std::list<sReal> Controller::getSensorValues(void) {
       std::vector<BaseSensor*>::iterator iter;
-      sReal *sens_val;
       std::list<sReal> sensorValues;
 
       for (iter=sensors.begin(); iter!=sensors.end(); ++iter) {
-        int count_val = (*iter)->getSensorData(&sens_val);
-        for(int i=0; i<count_val; i++) {
-          sensorValues.push_back(sens_val[i]);
-        }
-        free(sens_val);
+        SensorDataView view = (*iter)->getSensorView();
+        sensorValues.insert(sensorValues.end(), view.data,
+                            view.data+view.size);
       }
       return sensorValues;
     }
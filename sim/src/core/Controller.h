@@ -33,6 +33,7 @@
 #endif
 
 #include "SimMotor.h"
+#include "ControllerProtocol.h"
 
 #ifdef WIN32
 #include <windows.h>
@@ -57,6 +58,8 @@
 #include <mars/interfaces/ControllerData.h>
 #include <mars/interfaces/sim/ControllerInterface.h>
 
+#include <deque>
+
 namespace mars {
   namespace sim {
 
@@ -82,6 +85,14 @@ namespace mars {
       void getCoreExchange(interfaces::core_objects_exchange *obj) const;
       void resetData(void);
       void setDylibPath(const std::string &dylib_path);
+      /**
+       * \brief Selects the protocol used to talk to a remote controller.
+       *
+       * \param protocol "ascii" or "binary", see ControllerProtocol.h
+       * \param pipeline_depth number of steps the motor commands of the
+       *        binary protocol may lag behind, 0 waits for every answer
+       */
+      void setProtocol(const std::string &protocol, int pipeline_depth);
 
       void setAutoMode(bool mode);
       void setIP(const std::string &ip);
@@ -120,12 +131,30 @@ namespace mars {
       std::vector<SimMotor*> motors;
       std::vector<interfaces::BaseSensor*> sensors;
       std::vector<interfaces::NodeData*> sNodes;
+
+      // binary protocol
+      bool binaryProtocol;
+      uint64_t sequence;
+      std::vector<double> sensorValues;
+      std::vector<char> sendBuffer, receiveBuffer;
+      size_t sent; ///< bytes of sendBuffer that are sent
+      size_t queuedFrame; ///< start of the last frame in sendBuffer
+      size_t received;
+      bool resetRequested;
+      std::deque<std::pair<uint64_t, std::vector<double> > > motorFrames;
+
       int initServer(int port);
       void getClient(void);
       int openClient(const char *host, int port);
       int connectClient(void);
       int getSReal(const char *data, interfaces::sReal *value) const;
       int getChar(const char *data, char *c) const;
+      void updateBinary(void);
+      bool sendFrame(ControllerFrameType type, uint64_t seq,
+                     const std::vector<double> &values, bool wait);
+      bool flushFrames(bool wait);
+      bool receiveFrames(bool wait);
+      void connectionLost(void);
       void run(void);
     };
 
@@ -350,6 +350,8 @@ namespace mars {
       newController = new Controller(controller.rate, vmotor, vsensor, nodes,
                                      control, std_port);
       newController->setDylibPath(controller.dylib_path);
+      newController->setProtocol(controller.protocol,
+                                 controller.pipeline_depth);
       newController->setID(id);
       iMutex.lock();
       simController[id] = newController;
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ControllerProtocol.h
+ * \brief Frames of the binary protocol between a Controller and a remote
+ *        controller process.
+ *
+ * The protocol is selected by the controller property "protocol" ("ascii"
+ * or "binary"). Every binary frame is a ControllerFrameHeader followed by
+ * \c count doubles. All values are in host byte order.
+ *
+ * The simulation sends a CONTROLLER_FRAME_SENSORS frame with the values of
+ * all sensors of the controller every control step and increments the
+ * sequence with every frame. The remote controller answers with a
+ * CONTROLLER_FRAME_MOTORS frame that contains one value per motor and the
+ * sequence of the sensor frame it was computed from, or with a
+ * CONTROLLER_FRAME_RESET frame.
+ *
+ * With the property "pipeline_depth" set to 0 the simulation waits for the
+ * answer to every sensor frame. With a depth of k the simulation does not
+ * wait: step N sends its sensor frame and applies the newest motor frame
+ * that answers a sensor frame of step N-k or earlier. If none has arrived
+ * yet the motors keep their values.
+ *
+ * In the pipelined mode sending never blocks the simulation. Frames that
+ * cannot be sent yet are queued, and a queued sensor frame that was not
+ * started is replaced by the next one. The remote controller then skips
+ * sequences and only sees the newest sensor values.
+ */
+
+#ifndef CONTROLLER_PROTOCOL_H
+#define CONTROLLER_PROTOCOL_H
+
+#ifdef _PRINT_HEADER_
+  #warning "ControllerProtocol.h"
+#endif
+
+#include <stdint.h>
+
+#define CONTROLLER_FRAME_MAGIC 0x4c54434d /* "MCTL" */
+#define CONTROLLER_FRAME_MAX_COUNT 65536
+
+namespace mars {
+  namespace sim {
+
+    enum ControllerFrameType {
+      CONTROLLER_FRAME_SENSORS = 1,
+      CONTROLLER_FRAME_MOTORS,
+      CONTROLLER_FRAME_RESET
+    };
+
+    struct ControllerFrameHeader {
+      uint32_t magic;
+      uint32_t type; ///< a ControllerFrameType
+      uint64_t sequence;
+      uint32_t count; ///< number of doubles following the header
+      uint32_t reserved; ///< 0, pads the header to 24 bytes
+    };
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif // CONTROLLER_PROTOCOL_H
@@ -47,6 +47,7 @@ namespace mars {
       unsigned long id = 0;
       MutexLocker locker(&iMutex);
       entities[id = getNextId()] = new SimEntity(control, name);
+      entityNames.add(entities[id]->getName(), id);
       notifySubscribers(entities[id]);
       return id;
     }
@@ -55,6 +56,7 @@ namespace mars {
       unsigned long id = 0;
       MutexLocker locker(&iMutex);
       entities[id = getNextId()] = entity;
+      entityNames.add(entity->getName(), id);
       notifySubscribers(entity);
       return id;
     }
@@ -64,6 +66,7 @@ namespace mars {
       //remove from entity map
       for (auto it = entities.begin(); it != entities.end(); ++it) {
         if (it->second == entity) {
+          entityNames.remove(name, it->first);
           entities.erase(it);
           break;
         }
@@ -90,15 +93,7 @@ namespace mars {
 
     void EntityManager::addNode(const std::string& entityName, long unsigned int nodeId,
         const std::string& nodeName) {
-      SimEntity *entity = 0;
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          entity = iter->second;
-          break;
-        }
-      }
+      SimEntity *entity = findEntity(entityName);
       if (entity) {
         MutexLocker locker(&iMutex);
         entity->addNode(nodeId, nodeName);
@@ -107,40 +102,28 @@ namespace mars {
 
     void EntityManager::addMotor(const std::string& entityName, long unsigned int motorId,
         const std::string& motorName) {
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          MutexLocker locker(&iMutex);
-          iter->second->addMotor(motorId, motorName);
-          break;
-        }
+      SimEntity *entity = findEntity(entityName);
+      if (entity) {
+        MutexLocker locker(&iMutex);
+        entity->addMotor(motorId, motorName);
       }
     }
 
     void EntityManager::addJoint(const std::string& entityName, long unsigned int jointId,
         const std::string& jointName) {
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          MutexLocker locker(&iMutex);
-          iter->second->addJoint(jointId, jointName);
-          break;
-        }
+      SimEntity *entity = findEntity(entityName);
+      if (entity) {
+        MutexLocker locker(&iMutex);
+        entity->addJoint(jointId, jointName);
       }
     }
 
     void EntityManager::addController(const std::string& entityName,
         long unsigned int controllerId) {
-      //iterate over all robots to find the robot with the given name
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == entityName) {
-          MutexLocker locker(&iMutex);
-          iter->second->addController(controllerId);
-          break;
-        }
+      SimEntity *entity = findEntity(entityName);
+      if (entity) {
+        MutexLocker locker(&iMutex);
+        entity->addController(controllerId);
       }
     }
 
@@ -161,12 +144,16 @@ namespace mars {
       //TODO <jonas.peter@dfki.de> handle deselection
     }
 
+    SimEntity* EntityManager::findEntity(const std::string& name) {
+      std::map<unsigned long, SimEntity*>::iterator iter;
+      iter = entities.find(entityNames.find(name));
+      return iter == entities.end() ? 0 : iter->second;
+    }
+
     SimEntity* EntityManager::getEntity(const std::string& name) {
-      for (std::map<unsigned long, SimEntity*>::iterator iter = entities.begin();
-          iter != entities.end(); ++iter) {
-        if (iter->second->getName() == name) {
-          return iter->second;
-        }
+      SimEntity *entity = findEntity(name);
+      if (entity) {
+        return entity;
       }
       fprintf(stderr, "ERROR: Entity with name %s not found!\n", name.c_str());
       return 0;
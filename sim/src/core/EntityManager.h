@@ -43,6 +43,8 @@
 #include <mars/utils/Mutex.h>
 #include <configmaps/ConfigData.h>
 
+#include "NameIndex.h"
+
 namespace mars {
   namespace sim {
 
@@ -115,10 +117,13 @@ namespace mars {
     private:
       std::vector<interfaces::EntitySubscriberInterface*> subscribers;
       void notifySubscribers(SimEntity* entity);
+      /**returns the entity with the given name or 0*/
+      SimEntity* findEntity(const std::string &name);
       interfaces::ControlCenter *control;
       /**the id assigned to the next created entity; use getNextId function*/
       unsigned long next_entity_id;
       std::map<unsigned long, SimEntity*> entities;
+      NameIndex entityNames;
 
       /**returns the id to be assigned to the next entity*/
       unsigned long getNextId() {
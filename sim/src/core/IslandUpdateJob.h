@@ -0,0 +1,75 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file IslandUpdateJob.h
+ * \brief "IslandUpdateJob" updates the simulation objects of independent
+ * physics islands on a utils::ThreadPool.
+ *
+ */
+
+#ifndef ISLAND_UPDATE_JOB_H
+#define ISLAND_UPDATE_JOB_H
+
+#ifdef _PRINT_HEADER_
+  #warning "IslandUpdateJob.h"
+#endif
+
+#include <mars/interfaces/MARSDefs.h>
+#include <mars/utils/ThreadPool.h>
+#include <mars/utils/misc.h>
+
+#include <vector>
+
+namespace mars {
+  namespace sim {
+
+    /**
+     * Calls updateIsland(index, calc_ms) of a manager per job index. The
+     * manager reads the physics state of the island with one lock of the
+     * world and updates the objects of the island from it. The objects of
+     * different islands must not share any state.
+     */
+    template <typename T>
+    class IslandUpdateJob : public utils::ParallelJob {
+    public:
+      IslandUpdateJob(T *manager, interfaces::sReal calc_ms,
+                      std::vector<double> *islandTimes)
+        : manager(manager), calc_ms(calc_ms), islandTimes(islandTimes) {}
+
+      void runJob(std::size_t index) {
+        long long time = utils::getTime();
+        manager->updateIsland(index, calc_ms);
+        // every job index writes only to its own entry
+        if(islandTimes) {
+          (*islandTimes)[index] += utils::getTimeDiff(time);
+        }
+      }
+
+    private:
+      T *manager;
+      interfaces::sReal calc_ms;
+      std::vector<double> *islandTimes;
+    }; // end of class IslandUpdateJob
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif // ISLAND_UPDATE_JOB_H
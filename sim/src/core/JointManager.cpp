@@ -31,6 +31,7 @@
 #include "JointManager.h"
 #include "NodeManager.h"
 #include "PhysicsMapper.h"
+#include "IslandUpdateJob.h"
 
 
 #include <stdexcept>
@@ -61,6 +62,13 @@ namespace mars {
     JointManager::JointManager(ControlCenter *c) {
       control = c;
       next_joint_id = 1;
+      jointsChanged = true;
+      receiverRevision = 0;
+      dbUpdateTimeId = 0;
+      dbUpdateTimeReceivers = true;
+      dbUpdateTimePackage.add("time", 0.0);
+      dbUpdateTimePackage.add("joints", 0);
+      dbUpdateTimePackage.add("feedbackJoints", 0);
     }
 
     unsigned long JointManager::addJoint(JointData *jointS, bool reload) {
@@ -120,6 +128,8 @@ namespace mars {
         //    newJoint->setSJoint(*jointS);
         newJoint->setPhysicalJoint(newJointInterface);
         simJoints[jointS->index] = newJoint;
+        jointsChanged = true;
+        jointNames.add(jointS->name, jointS->index);
         iMutex.unlock();
         control->sim->sceneHasChanged(false);
         return jointS->index;
@@ -193,7 +203,9 @@ namespace mars {
 
       if (iter != simJoints.end()) {
         tmpJoint = iter->second;
+        jointNames.remove(tmpJoint->getSJoint().name, index);
         simJoints.erase(iter);
+        jointsChanged = true;
       }
 
       control->motors->removeJointFromMotors(index);
@@ -249,11 +261,158 @@ namespace mars {
         addJoint(&(*iter), true);
     }
 
-    void JointManager::updateJoints(sReal calc_ms) {
-      MutexLocker locker(&iMutex);
+    void JointManager::rebuildUpdateList(void) {
       map<unsigned long, SimJoint*>::iterator iter;
+      JointInterface *physicalJoint;
+
+      updateJointsList.clear();
+      physicalJoints.clear();
+      jointReceivers.clear();
       for(iter = simJoints.begin(); iter != simJoints.end(); iter++) {
-        iter->second->update(calc_ms);
+        physicalJoint = iter->second->getPhysicalJoint();
+        if(!physicalJoint) continue;
+        updateJointsList.push_back(iter->second);
+        physicalJoints.push_back(physicalJoint);
+        jointReceivers.push_back(!control->dataBroker ||
+                                 control->dataBroker->hasReceivers(iter->second->getDataBrokerId()));
+      }
+      feedback.resize(updateJointsList.size());
+      dbUpdateTimeReceivers = (!control->dataBroker || !dbUpdateTimeId ||
+                               control->dataBroker->hasReceivers(dbUpdateTimeId));
+      jointsChanged = false;
+    }
+
+    void JointManager::publishUpdateTime(double time, size_t numFeedback) {
+      if(!control->dataBroker || !dbUpdateTimeReceivers) return;
+      dbUpdateTimePackage[0].d = time;
+      dbUpdateTimePackage[1].i = (int)updateJointsList.size();
+      dbUpdateTimePackage[2].i = (int)numFeedback;
+      if(!dbUpdateTimeId) {
+        dbUpdateTimeId = control->dataBroker->pushData("mars_sim", "jointUpdateTime",
+                                                       dbUpdateTimePackage, NULL,
+                                                       data_broker::DATA_PACKAGE_READ_FLAG);
+        dbUpdateTimeReceivers = control->dataBroker->hasReceivers(dbUpdateTimeId);
+      }
+      else {
+        control->dataBroker->pushData(dbUpdateTimeId, dbUpdateTimePackage);
+      }
+    }
+
+    /**
+     * The states of all joints are read from the physics in one locked
+     * pass. Forces and torques are only computed for joints that are
+     * pushed to a DataBroker receiver or that require them explicitly.
+     */
+    void JointManager::updateJoints(sReal calc_ms) {
+      long long startTime = getTimeMicro();
+      size_t numFeedback = 0;
+      iMutex.lock();
+      if(control->dataBroker) {
+        unsigned long revision = control->dataBroker->getReceiverRevision();
+        if(revision != receiverRevision) {
+          receiverRevision = revision;
+          jointsChanged = true;
+        }
+      }
+      if(jointsChanged) rebuildUpdateList();
+
+      for(size_t i=0; i<updateJointsList.size(); ++i) {
+        feedback[i] = jointReceivers[i] || updateJointsList[i]->isFeedbackRequired();
+        if(feedback[i]) ++numFeedback;
+      }
+      if(control->sim->getPhysics()->getJointStates(physicalJoints, feedback,
+                                                    &jointStates)) {
+        for(size_t i=0; i<updateJointsList.size(); ++i) {
+          updateJointsList[i]->updateState(jointStates[i], calc_ms, feedback[i]);
+        }
+      }
+      else {
+        numFeedback = updateJointsList.size();
+        for(size_t i=0; i<updateJointsList.size(); ++i) {
+          updateJointsList[i]->update(calc_ms);
+        }
+      }
+      iMutex.unlock();
+      publishUpdateTime((getTimeMicro()-startTime)*0.001, numFeedback);
+    }
+
+    /**
+     * The joints are grouped by island. Every island reads the states of
+     * its joints with one lock of the world, see updateIsland(). Like
+     * updateJoints(sReal), only joints with a physical representation are
+     * updated.
+     */
+    void JointManager::updateJoints(sReal calc_ms,
+                                    const std::vector<std::vector<unsigned long> > &islands,
+                                    ThreadPool *pool,
+                                    std::vector<double> *islandTimes) {
+      MutexLocker locker(&iMutex);
+      std::vector<size_t> remaining;
+      std::map<NodeId, size_t> nodeIsland;
+      std::map<NodeId, size_t>::iterator it;
+      SimJoint *joint;
+      bool jointFeedback;
+
+      if(control->dataBroker) {
+        unsigned long revision = control->dataBroker->getReceiverRevision();
+        if(revision != receiverRevision) {
+          receiverRevision = revision;
+          jointsChanged = true;
+        }
+      }
+      if(jointsChanged) rebuildUpdateList();
+
+      jointIslands.resize(islands.size());
+      for(size_t i=0; i<islands.size(); ++i) {
+        jointIslands[i].joints.clear();
+        jointIslands[i].physicalJoints.clear();
+        jointIslands[i].feedback.clear();
+        for(size_t k=0; k<islands[i].size(); ++k) {
+          nodeIsland[islands[i][k]] = i;
+        }
+      }
+      for(size_t i=0; i<updateJointsList.size(); ++i) {
+        joint = updateJointsList[i];
+        // both nodes of a joint are part of the same island
+        it = nodeIsland.find(joint->getNodeId(1));
+        if(it == nodeIsland.end()) {
+          it = nodeIsland.find(joint->getNodeId(2));
+        }
+        if(it == nodeIsland.end()) {
+          remaining.push_back(i);
+          continue;
+        }
+        jointFeedback = jointReceivers[i] || joint->isFeedbackRequired();
+        jointIslands[it->second].joints.push_back(joint);
+        jointIslands[it->second].physicalJoints.push_back(physicalJoints[i]);
+        jointIslands[it->second].feedback.push_back(jointFeedback);
+      }
+
+      IslandUpdateJob<JointManager> job(this, calc_ms, islandTimes);
+      pool->run(&job, islands.size());
+      for(size_t i=0; i<remaining.size(); ++i) {
+        updateJointsList[remaining[i]]->update(calc_ms);
+      }
+    }
+
+    /**
+     * Called by an IslandUpdateJob with a locked iMutex.
+     */
+    void JointManager::updateIsland(size_t index, sReal calc_ms) {
+      JointIsland &island = jointIslands[index];
+      PhysicsInterface *physics = control->sim->getPhysics();
+
+      if(physics->getJointStates(island.physicalJoints, island.feedback,
+                                 &island.states)) {
+        for(size_t i=0; i<island.joints.size(); ++i) {
+          island.joints[i]->updateState(island.states[i], calc_ms,
+                                        island.feedback[i]);
+        }
+      }
+      else {
+        for(size_t i=0; i<island.joints.size(); ++i) {
+          island.joints[i]->update(calc_ms);
+        }
       }
     }
 
@@ -266,7 +425,9 @@ namespace mars {
         control->motors->removeJointFromMotors(simJoints.begin()->first);
         delete simJoints.begin()->second;
         simJoints.erase(simJoints.begin());
+        jointsChanged = true;
       }
+      jointNames.clear();
       control->sim->sceneHasChanged(false);
 
       next_joint_id = 1;
@@ -369,14 +530,8 @@ namespace mars {
 
 
     unsigned long JointManager::getID(const std::string& joint_name) const {
-      map<unsigned long, SimJoint*>::const_iterator iter;
       MutexLocker locker(&iMutex);
-      for(iter = simJoints.begin(); iter != simJoints.end(); iter++) {
-        JointData joint = iter->second->getSJoint();
-        if (joint.name == joint_name)
-          return joint.index;
-      }
-      return 0;
+      return jointNames.find(joint_name);
     }
 
     unsigned long JointManager::getIDByNodeIDs(unsigned long id1, unsigned long id2) {
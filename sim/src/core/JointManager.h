@@ -36,11 +36,15 @@
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/JointManagerInterface.h>
 #include <mars/utils/Mutex.h>
+#include <mars/data_broker/DataPackage.h>
+
+#include "NameIndex.h"
 
 namespace mars {
   namespace sim {
 
     class SimJoint;
+    template <typename T> class IslandUpdateJob;
 
     /**
      * The declaration of the JointManager class.
@@ -62,6 +66,10 @@ namespace mars {
       virtual void reattacheJoints(unsigned long node_id);
       virtual void reloadJoints(void);
       virtual void updateJoints(interfaces::sReal calc_ms);
+      virtual void updateJoints(interfaces::sReal calc_ms,
+                                const std::vector<std::vector<unsigned long> > &islands,
+                                utils::ThreadPool *pool,
+                                std::vector<double> *islandTimes=NULL);
       virtual void clearAllJoints(bool clear_all=false);
       virtual void setReloadJointOffset(unsigned long id, interfaces::sReal offset);
       virtual void setReloadJointAxis(unsigned long id, const utils::Vector &axis);
@@ -96,12 +104,37 @@ namespace mars {
     private:
       unsigned long next_joint_id;
       std::map<unsigned long, SimJoint*> simJoints;
+      NameIndex jointNames; ///< guarded by iMutex
       std::list<interfaces::JointData> simJointsReload;
       interfaces::ControlCenter *control;
       mutable utils::Mutex iMutex;
       interfaces::JointManagerInterface* getJointInterface(unsigned long node_id);
       std::list<interfaces::JointData>::iterator getReloadJoint(unsigned long id);
 
+      // joints with a physical representation, gathered in one pass
+      void rebuildUpdateList(void);
+      void publishUpdateTime(double time, size_t numFeedback);
+      std::vector<SimJoint*> updateJointsList;
+      std::vector<interfaces::JointInterface*> physicalJoints;
+      std::vector<bool> jointReceivers, feedback;
+      std::vector<interfaces::JointState> jointStates;
+      bool jointsChanged;
+      unsigned long receiverRevision;
+      data_broker::DataPackage dbUpdateTimePackage;
+      unsigned long dbUpdateTimeId;
+      bool dbUpdateTimeReceivers; ///< checked by rebuildUpdateList()
+
+      // the joints of one physics island, see updateIsland()
+      struct JointIsland {
+        std::vector<SimJoint*> joints;
+        std::vector<interfaces::JointInterface*> physicalJoints;
+        std::vector<bool> feedback;
+        std::vector<interfaces::JointState> states;
+      };
+      friend class IslandUpdateJob<JointManager>;
+      void updateIsland(size_t index, interfaces::sReal calc_ms);
+      std::vector<JointIsland> jointIslands;
+
     };
 
   } // end of namespace sim
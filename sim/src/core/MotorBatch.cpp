@@ -0,0 +1,177 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MotorBatch.h"
+#include "SimMotor.h"
+
+#include <mars/interfaces/sim/PhysicsInterface.h>
+
+#include <cmath>
+#include <algorithm>
+
+namespace mars {
+  namespace sim {
+
+    using namespace interfaces;
+
+    void MotorBatch::clear() {
+      motors.clear();
+    }
+
+    void MotorBatch::add(SimMotor *motor) {
+      motors.push_back(motor);
+    }
+
+    size_t MotorBatch::size() const {
+      return motors.size();
+    }
+
+    bool MotorBatch::update(sReal time_ms, PhysicsInterface *physics) {
+      if(motors.empty()) return true;
+      if(!gather()) return false;
+      runPositionControllers(time_ms);
+      scatter(time_ms, physics);
+      return true;
+    }
+
+    bool MotorBatch::gather() {
+      size_t n = motors.size();
+      position.resize(n);
+      controlValue.resize(n);
+      minValue.resize(n);
+      maxValue.resize(n);
+      p.resize(n);
+      i.resize(n);
+      d.resize(n);
+      maxSpeed.resize(n);
+      filterValue.resize(n);
+      error.resize(n);
+      integError.resize(n);
+      lastError.resize(n);
+      velocity.resize(n);
+      lastVelocity.resize(n);
+      momentaryMaxSpeed.resize(n);
+      momentaryMaxEffort.resize(n);
+
+      for(size_t k=0; k<n; ++k) {
+        SimMotor *motor = motors[k];
+        // the motor could have been changed via its pointer
+        if(!motor->active || !motor->myJoint || motor->myPlayJoint ||
+           motor->mimic || !motor->mimics.empty() ||
+           motor->runController != &SimMotor::runPositionController) {
+          return false;
+        }
+        // the joint caches its state, this does not lock the world
+        motor->refreshPosition();
+        motor->sensedEffort = motor->myJoint->getMotorTorque();
+        position[k] = *(motor->position);
+        controlValue[k] = motor->controlValue;
+        minValue[k] = motor->sMotor.minValue;
+        maxValue[k] = motor->sMotor.maxValue;
+        p[k] = motor->sMotor.p;
+        i[k] = motor->sMotor.i;
+        d[k] = motor->sMotor.d;
+        maxSpeed[k] = motor->sMotor.maxSpeed;
+        filterValue[k] = motor->filterValue;
+        integError[k] = motor->integ_error;
+        lastError[k] = motor->last_error;
+        lastVelocity[k] = motor->lastVelocity;
+        // the approximations may depend on the position read above
+        momentaryMaxSpeed[k] = motor->getMomentaryMaxSpeed();
+        momentaryMaxEffort[k] = motor->getMomentaryMaxEffort();
+      }
+      return true;
+    }
+
+    /*
+     * Equals SimMotor::runPositionController() followed by the speed cap
+     * of SimMotor::update() for all motors of the batch. The loop only
+     * works on the arrays so that the compiler can vectorize it.
+     */
+    void MotorBatch::runPositionControllers(sReal time_ms) {
+      size_t n = motors.size();
+      for(size_t k=0; k<n; ++k) {
+        sReal e, iPart, v;
+        controlValue[k] = std::max(minValue[k],
+                                   std::min(controlValue[k], maxValue[k]));
+        e = controlValue[k] - position[k];
+        if(std::abs(e) < 0.000001) e = 0.0;
+        integError[k] += e*time_ms;
+
+        // anti wind up, see SimMotor::runPositionController()
+        iPart = integError[k] * i[k];
+        if(iPart > maxSpeed[k]) {
+          iPart = maxSpeed[k];
+          integError[k] = maxSpeed[k] / i[k];
+        }
+        if(iPart < -maxSpeed[k]) {
+          iPart = -maxSpeed[k];
+          integError[k] = -maxSpeed[k] / i[k];
+        }
+
+        v = e*p[k] + iPart + ((e - lastError[k])/time_ms)*d[k];
+        v = lastVelocity[k]*filterValue[k] + v*(1-filterValue[k]);
+        lastVelocity[k] = v;
+        lastError[k] = e;
+        error[k] = e;
+        velocity[k] = std::max(-momentaryMaxSpeed[k],
+                               std::min(v, momentaryMaxSpeed[k]));
+      }
+    }
+
+    void MotorBatch::scatter(sReal time_ms, PhysicsInterface *physics) {
+      size_t n = motors.size();
+      size_t numCommands = 0;
+      commands.resize(n);
+
+      for(size_t k=0; k<n; ++k) {
+        SimMotor *motor = motors[k];
+        motor->time = time_ms;
+        motor->controlValue = controlValue[k];
+        motor->error = error[k];
+        motor->integ_error = integError[k];
+        motor->last_error = lastError[k];
+        motor->lastVelocity = lastVelocity[k];
+        motor->velocity = velocity[k];
+        motor->tmpmaxspeed = momentaryMaxSpeed[k];
+        motor->tmpmaxeffort = momentaryMaxEffort[k];
+        motor->effort = std::max(-motor->tmpmaxeffort,
+                                 std::min(motor->effort, motor->tmpmaxeffort));
+        motor->estimateCurrent();
+        motor->estimateTemperature(time_ms);
+        if(motor->myJoint->getMotorCommand(&commands[numCommands],
+                                           velocity[k], momentaryMaxEffort[k],
+                                           motor->sMotor.axis)) {
+          ++numCommands;
+        }
+      }
+      commands.resize(numCommands);
+
+      if(physics && physics->setJointMotorCommands(commands)) return;
+      for(size_t k=0; k<n; ++k) {
+        SimMotor *motor = motors[k];
+        motor->myJoint->setEffortLimit(momentaryMaxEffort[k],
+                                       motor->sMotor.axis);
+        motor->myJoint->setVelocity(velocity[k], motor->sMotor.axis);
+      }
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
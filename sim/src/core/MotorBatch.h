@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file MotorBatch.h
+ * \brief "MotorBatch" updates the position controlled motors together.
+ *
+ * The batch keeps the state of its motors in one array per value. A step
+ * gathers the joint positions, runs the pid controllers and the limits of
+ * all motors in one loop and passes the velocities and effort limits to
+ * the physics with PhysicsInterface::setJointMotorCommands(), which locks
+ * the world only once. The result equals SimMotor::update().
+ *
+ * Only motors for which SimMotor::isBatchable() is true are added. Motors
+ * with mimic relations, a play joint or a "spring" config keep their
+ * update.
+ */
+
+#ifndef MOTOR_BATCH_H
+#define MOTOR_BATCH_H
+
+#ifdef _PRINT_HEADER_
+  #warning "MotorBatch.h"
+#endif
+
+#include <mars/interfaces/sim/JointInterface.h>
+
+#include <vector>
+
+namespace mars {
+
+  namespace interfaces {
+    class PhysicsInterface;
+  }
+
+  namespace sim {
+
+    class SimMotor;
+
+    class MotorBatch {
+    public:
+      void clear();
+      void add(SimMotor *motor);
+      size_t size() const;
+
+      /**
+       * \brief Updates the motors of the batch.
+       * \return \c false if a motor is not batchable any more. The motors
+       *         are not updated in that case and the batch has to be
+       *         rebuilt.
+       */
+      bool update(interfaces::sReal time_ms,
+                  interfaces::PhysicsInterface *physics);
+
+    private:
+      bool gather();
+      void runPositionControllers(interfaces::sReal time_ms);
+      void scatter(interfaces::sReal time_ms,
+                   interfaces::PhysicsInterface *physics);
+
+      std::vector<SimMotor*> motors;
+      std::vector<interfaces::sReal> position, controlValue, minValue, maxValue;
+      std::vector<interfaces::sReal> p, i, d, maxSpeed, filterValue;
+      std::vector<interfaces::sReal> error, integError, lastError;
+      std::vector<interfaces::sReal> velocity, lastVelocity;
+      std::vector<interfaces::sReal> momentaryMaxSpeed, momentaryMaxEffort;
+      std::vector<interfaces::JointMotorCommand> commands;
+    };
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif  // MOTOR_BATCH_H
@@ -35,6 +35,7 @@
 #include "SimMotor.h"
 #include "PhysicsMapper.h"
 #include "MotorManager.h"
+#include "IslandUpdateJob.h"
 
 #include <stdexcept>
 
@@ -60,6 +61,8 @@ namespace mars {
     {
       control = c;
       next_motor_id = 1;
+      batchedUpdate = false;
+      batchDirty = true;
     }
 
 
@@ -96,6 +99,8 @@ namespace mars {
       newMotor->setSMotor(*motorS);
       iMutex.lock();
       simMotors[newMotor->getIndex()] = newMotor;
+      motorNames.add(newMotor->getName(), newMotor->getIndex());
+      batchDirty = true;
       iMutex.unlock();
       control->sim->sceneHasChanged(false);
 
@@ -168,8 +173,12 @@ namespace mars {
     void MotorManager::editMotor(const MotorData &motorS) {
       MutexLocker locker(&iMutex);
       map<unsigned long, SimMotor*>::iterator iter = simMotors.find(motorS.index);
-      if (iter != simMotors.end())
+      if (iter != simMotors.end()) {
+        std::string name = iter->second->getName();
         iter->second->setSMotor(motorS);
+        motorNames.rename(name, iter->second->getName(), motorS.index);
+        batchDirty = true;
+      }
     }
 
 
@@ -225,7 +234,9 @@ namespace mars {
       map<unsigned long, SimMotor*>::iterator iter = simMotors.find(index);
       if (iter != simMotors.end()) {
         tmpMotor = iter->second;
+        motorNames.remove(tmpMotor->getName(), index);
         simMotors.erase(iter);
+        batchDirty = true;
         if (tmpMotor)
           delete tmpMotor;
       }
@@ -273,9 +284,9 @@ namespace mars {
     SimMotor* MotorManager::getSimMotorByName(const std::string &name) const {
       MutexLocker locker(&iMutex);
       std::map<unsigned long, SimMotor*>::const_iterator iter;
-      for (iter = simMotors.begin(); iter != simMotors.end(); iter++)
-        if (iter->second->getName() == name)
-          return iter->second;
+      iter = simMotors.find(motorNames.find(name));
+      if (iter != simMotors.end())
+        return iter->second;
       return NULL;
     }
 
@@ -373,8 +384,10 @@ namespace mars {
     void MotorManager::deactivateMotor(unsigned long id) {
       MutexLocker locker(&iMutex);
       map<unsigned long, SimMotor*>::iterator iter = simMotors.find(id);
-      if (iter != simMotors.end())
+      if (iter != simMotors.end()) {
         iter->second->deactivate();
+        batchDirty = true;
+      }
     }
 
 
@@ -386,14 +399,8 @@ namespace mars {
      * \return Id of the motor if it exists, otherwise 0
      */
     unsigned long MotorManager::getID(const std::string& name) const {
-      map<unsigned long, SimMotor*>::const_iterator iter;
       MutexLocker locker(&iMutex);
-
-      for (iter = simMotors.begin(); iter != simMotors.end(); iter++) {
-        if (iter->second->getName() == name)
-          return iter->first;
-      }
-      return 0;
+      return motorNames.find(name);
     }
 
 
@@ -431,7 +438,9 @@ namespace mars {
       for(iter = simMotors.begin(); iter != simMotors.end(); iter++)
         delete iter->second;
       simMotors.clear();
+      motorNames.clear();
       mimicmotors.clear();
+      batchDirty = true;
       if(clear_all) simMotorsReload.clear();
       next_motor_id = 1;
     }
@@ -466,10 +475,116 @@ namespace mars {
     void MotorManager::updateMotors(double calc_ms) {
       map<unsigned long, SimMotor*>::iterator iter;
       MutexLocker locker(&iMutex);
+      if(batchedUpdate) {
+        PhysicsInterface *physics = control->sim->getPhysics();
+        if(batchDirty) rebuildMotorBatch();
+        // a motor of the batch was changed via its SimMotor
+        if(!motorBatch.update(calc_ms, physics)) {
+          rebuildMotorBatch();
+          motorBatch.update(calc_ms, physics);
+        }
+        for(size_t i=0; i<unbatchedMotors.size(); ++i) {
+          unbatchedMotors[i]->update(calc_ms);
+        }
+        return;
+      }
       for(iter = simMotors.begin(); iter != simMotors.end(); iter++)
         iter->second->update(calc_ms);
     }
 
+    void MotorManager::setBatchedUpdate(bool batched) {
+      MutexLocker locker(&iMutex);
+      batchedUpdate = batched;
+      batchDirty = true;
+    }
+
+    /**
+     * Has to be called with a locked iMutex. The unbatched motors keep the
+     * order of simMotors, the mimics are updated after their motor.
+     */
+    void MotorManager::rebuildMotorBatch() {
+      map<unsigned long, SimMotor*>::iterator iter;
+      motorBatch.clear();
+      unbatchedMotors.clear();
+      for(iter = simMotors.begin(); iter != simMotors.end(); iter++) {
+        if(iter->second->isBatchable()) motorBatch.add(iter->second);
+        else unbatchedMotors.push_back(iter->second);
+      }
+      batchDirty = false;
+    }
+
+    /**
+     * The motors are grouped by island. With batched updates the position
+     * controlled motors of an island are updated as a MotorBatch, which
+     * passes their commands to the physics with one lock of the world, see
+     * updateIsland(). Otherwise every motor is updated by itself as in the
+     * serial update.
+     */
+    void MotorManager::updateMotors(sReal calc_ms,
+                                    const vector<vector<unsigned long> > &islands,
+                                    ThreadPool *pool,
+                                    vector<double> *islandTimes) {
+      MutexLocker locker(&iMutex);
+      vector<SimMotor*> remaining;
+      map<NodeId, size_t> nodeIsland;
+      map<NodeId, size_t>::iterator it;
+      map<unsigned long, SimMotor*>::iterator iter;
+      SimJoint *joint;
+
+      motorIslands.resize(islands.size());
+      for(size_t i=0; i<islands.size(); ++i) {
+        motorIslands[i].batch.clear();
+        motorIslands[i].batched.clear();
+        motorIslands[i].unbatched.clear();
+        for(size_t k=0; k<islands[i].size(); ++k) {
+          nodeIsland[islands[i][k]] = i;
+        }
+      }
+      for(iter = simMotors.begin(); iter != simMotors.end(); iter++) {
+        joint = iter->second->getJoint();
+        it = nodeIsland.end();
+        // a motor sets the control value of its mimics during its update
+        if(joint && !iter->second->isMimic() && !iter->second->hasMimics()) {
+          it = nodeIsland.find(joint->getNodeId(1));
+          if(it == nodeIsland.end()) {
+            it = nodeIsland.find(joint->getNodeId(2));
+          }
+        }
+        if(it == nodeIsland.end()) {
+          remaining.push_back(iter->second);
+        }
+        else if(batchedUpdate && iter->second->isBatchable()) {
+          motorIslands[it->second].batch.add(iter->second);
+          motorIslands[it->second].batched.push_back(iter->second);
+        }
+        else {
+          motorIslands[it->second].unbatched.push_back(iter->second);
+        }
+      }
+
+      IslandUpdateJob<MotorManager> job(this, calc_ms, islandTimes);
+      pool->run(&job, islands.size());
+      for(size_t i=0; i<remaining.size(); ++i) {
+        remaining[i]->update(calc_ms);
+      }
+    }
+
+    /**
+     * Called by an IslandUpdateJob with a locked iMutex.
+     */
+    void MotorManager::updateIsland(size_t index, sReal calc_ms) {
+      MotorIsland &island = motorIslands[index];
+
+      if(!island.batch.update(calc_ms, control->sim->getPhysics())) {
+        // a motor was changed via its SimMotor since the grouping
+        for(size_t i=0; i<island.batched.size(); ++i) {
+          island.batched[i]->update(calc_ms);
+        }
+      }
+      for(size_t i=0; i<island.unbatched.size(); ++i) {
+        island.unbatched[i]->update(calc_ms);
+      }
+    }
 
     sReal MotorManager::getActualPosition(unsigned long motorId) const {
       MutexLocker locker(&iMutex);
@@ -522,6 +637,7 @@ namespace mars {
       for (iter = simMotors.begin(); iter != simMotors.end(); iter++)
         if (iter->second->getJointIndex() == joint_index)
           iter->second->attachJoint(0);
+      batchDirty = true;
     }
 
     void MotorManager::getDataBrokerNames(unsigned long jointId,
@@ -540,6 +656,9 @@ namespace mars {
         if (parentmotor != NULL)
           parentmotor->addMimic(simMotors[it->first]);
       }
+      iMutex.lock();
+      batchDirty = true;
+      iMutex.unlock();
     }
 
     void MotorManager::edit(interfaces::MotorId id, const std::string &key,
@@ -568,6 +687,7 @@ namespace mars {
         if(matchPattern("*/maxValue", key)) {
           iter->second->setMaxValue(atof(value.c_str()));
         }
+        batchDirty = true;
         if(matchPattern("*/type", key)) {
           if(value == "DC" || value == "2") {
             iter->second->setType(MOTOR_TYPE_VELOCITY);
@@ -42,10 +42,14 @@
 #include <mars/interfaces/sim/MotorManagerInterface.h>
 #include <mars/utils/Mutex.h>
 
+#include "NameIndex.h"
+#include "MotorBatch.h"
+
 namespace mars {
   namespace sim {
 
     class SimMotor;
+    template <typename T> class IslandUpdateJob;
 
     /**
      * \brief "MotorManager" imlements the interfaces for all motor 
@@ -263,6 +267,21 @@ namespace mars {
        */
       virtual void updateMotors(interfaces::sReal calc_ms);
 
+      /**
+       * \brief Updates the motors island by island on the given thread pool.
+       * Motors with mimic relations keep the serial update order.
+       */
+      virtual void updateMotors(interfaces::sReal calc_ms,
+                                const std::vector<std::vector<unsigned long> > &islands,
+                                utils::ThreadPool *pool,
+                                std::vector<double> *islandTimes=NULL);
+
+      /**
+       * \brief Enables the update of the position controlled motors with a
+       *        MotorBatch.
+       */
+      virtual void setBatchedUpdate(bool batched);
+
       /**
        * \returns the actual position of the motor with the given Id.
        *          returns 0 if a motor with the given Id doesn't exist.
@@ -318,12 +337,17 @@ namespace mars {
                         const std::string &value);
 
     private:
+      void rebuildMotorBatch();
+
       //! the id of the next motor that is added to the simulation
       unsigned long next_motor_id;
 
       //! a container for all motors currently present in the simulation
       std::map<unsigned long, SimMotor*> simMotors;
 
+      //! the names of the motors, guarded by iMutex
+      NameIndex motorNames;
+
       //! a containter for all motors that are reloaded after a reset of the simulation
       std::list<interfaces::MotorData> simMotorsReload;
 
@@ -335,6 +359,20 @@ namespace mars {
 
       // map of mimicmotors
       std::map<unsigned long, std::string> mimicmotors;
+
+      //! the batched and the remaining motors, guarded by iMutex
+      bool batchedUpdate, batchDirty;
+      MotorBatch motorBatch;
+      std::vector<SimMotor*> unbatchedMotors;
+
+      //! the motors of one physics island, see updateIsland()
+      struct MotorIsland {
+        MotorBatch batch;
+        std::vector<SimMotor*> batched, unbatched;
+      };
+      friend class IslandUpdateJob<MotorManager>;
+      void updateIsland(size_t index, interfaces::sReal calc_ms);
+      std::vector<MotorIsland> motorIslands;
     }; // class MotorManager
 
   } // end of namespace sim
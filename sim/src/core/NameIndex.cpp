@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "NameIndex.h"
+
+#include <algorithm>
+
+namespace mars {
+  namespace sim {
+
+    void NameIndex::add(const std::string &name, unsigned long id) {
+      ids[name].insert(id);
+    }
+
+    void NameIndex::remove(const std::string &name, unsigned long id) {
+      IdMap::iterator it = ids.find(name);
+      if(it == ids.end()) return;
+      it->second.erase(id);
+      if(it->second.empty()) ids.erase(it);
+    }
+
+    void NameIndex::rename(const std::string &oldName,
+                           const std::string &newName, unsigned long id) {
+      if(oldName == newName) return;
+      remove(oldName, id);
+      add(newName, id);
+    }
+
+    void NameIndex::clear() {
+      ids.clear();
+    }
+
+    unsigned long NameIndex::find(const std::string &name) const {
+      IdMap::const_iterator it = ids.find(name);
+      if(it == ids.end()) return 0;
+      return *(it->second.begin());
+    }
+
+    std::vector<unsigned long> NameIndex::findSubstring(const std::string &str) const {
+      std::vector<unsigned long> out;
+      IdMap::const_iterator it = ids.begin();
+      for(; it!=ids.end(); ++it) {
+        if(it->first.find(str) != std::string::npos) {
+          out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+      }
+      std::sort(out.begin(), out.end());
+      return out;
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
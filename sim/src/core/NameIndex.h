@@ -0,0 +1,75 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/**
+ * \file NameIndex.h
+ * \brief "NameIndex" maps the names of simulation objects to their ids.
+ *
+ * The managers keep the index next to their object maps and update it when
+ * an object is added, removed or renamed. It is not locked, the managers
+ * guard it with the mutex of their maps.
+ */
+
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#ifdef _PRINT_HEADER_
+  #warning "NameIndex.h"
+#endif
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mars {
+  namespace sim {
+
+    class NameIndex {
+    public:
+      void add(const std::string &name, unsigned long id);
+      void remove(const std::string &name, unsigned long id);
+      void rename(const std::string &oldName, const std::string &newName,
+                  unsigned long id);
+      void clear();
+
+      /**
+       * \brief Returns the lowest id with the name or 0. Names do not have
+       * to be unique, the lowest id is the one a search through the map of
+       * the manager finds first.
+       */
+      unsigned long find(const std::string &name) const;
+
+      /**
+       * \brief Returns the sorted ids of all objects whose name contains
+       * \a str. Only the distinct names are compared.
+       */
+      std::vector<unsigned long> findSubstring(const std::string &str) const;
+
+    private:
+      typedef std::unordered_map<std::string, std::set<unsigned long> > IdMap;
+      IdMap ids;
+    }; // end of class NameIndex
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif // NAME_INDEX_H
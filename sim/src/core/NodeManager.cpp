@@ -30,12 +30,14 @@
 #include "NodeManager.h"
 #include "JointManager.h"
 #include "PhysicsMapper.h"
+#include "IslandUpdateJob.h"
 
 #include <mars/interfaces/sim/LoadCenter.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/terrainStruct.h>
 #include <mars/interfaces/Logging.hpp>
+#include <mars/data_broker/DataBrokerInterface.h>
 
 #include <lib_manager/LibManager.hpp>
 
@@ -69,8 +71,14 @@ namespace mars {
                                                  visual_rep(1),
                                                  maxGroupID(0),
                                                  control(c),
-                                                 libManager(theManager)
+                                                 libManager(theManager),
+                                                 nodesChanged(true),
+                                                 dbUpdateTimeId(0),
+                                                 dbUpdateTimeRevision(~0ul),
+                                                 dbUpdateTimeReceivers(true)
     {
+      dbUpdateTimePackage.add("time", 0.0);
+      dbUpdateTimePackage.add("nodes", 0);
       if(control->graphics) {
         GraphicsUpdateInterface *gui = static_cast<GraphicsUpdateInterface*>(this);
         control->graphics->addGraphicsUpdateInterface(gui);
@@ -258,8 +266,11 @@ namespace mars {
         newNode->setInterface(newNodeInterface);
         iMutex.lock();
         simNodes[nodeS->index] = newNode;
-        if (nodeS->movable)
+        nodeNames.add(nodeS->name, nodeS->index);
+        if (nodeS->movable) {
           simNodesDyn[nodeS->index] = newNode;
+          nodesChanged = true;
+        }
         iMutex.unlock();
         control->sim->sceneHasChanged(false);
         NodeId id;
@@ -324,8 +335,10 @@ namespace mars {
         else {
           iMutex.lock();
           simNodes[nodeS->index] = newNode;
+          nodeNames.add(nodeS->name, nodeS->index);
           if (nodeS->movable) {
             simNodesDyn[nodeS->index] = newNode;
+            nodesChanged = true;
           }
           iMutex.unlock();
         }
@@ -446,6 +459,7 @@ namespace mars {
       //cout << "NodeManager::editNode !!!" << endl;
       // first lock all core functions
       iMutex.lock();
+      stateSnapshot.invalidate();
 
       iter = simNodes.find(nodeS->index);
       if(iter == simNodes.end()) {
@@ -668,10 +682,12 @@ namespace mars {
       SimNode *tmpNode = 0;
 
       if(lock) iMutex.lock();
+      stateSnapshot.invalidate();
 
       iter = simNodes.find(id);
       if (iter != simNodes.end()) {
         tmpNode = iter->second; //iter->second is a pointer to the SimNode associated with the map
+        nodeNames.remove(tmpNode->getName(), id);
         simNodes.erase(iter);
       }
 
@@ -691,6 +707,7 @@ namespace mars {
         iter = simNodesDyn.find(id);
         if (iter != simNodesDyn.end()) {
           simNodesDyn.erase(iter);
+          nodesChanged = true;
         }
       }
 
@@ -712,6 +729,7 @@ namespace mars {
      */
     void NodeManager::setNodeState(NodeId id, const nodeState &state) {
       MutexLocker locker(&iMutex);
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
         iter->second->setPhysicalState(state);
@@ -752,6 +770,7 @@ namespace mars {
      */
     void NodeManager::setPosition(NodeId id, const Vector &pos) {
       MutexLocker locker(&iMutex);
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodes.find(id);
       if (iter != simNodes.end()) {
         iter->second->setPosition(pos, 1);
@@ -762,6 +781,10 @@ namespace mars {
 
     const Vector NodeManager::getPosition(NodeId id) const {
       Vector pos(0.0,0.0,0.0);
+      NodeStateEntry state;
+      if(stateSnapshot.read(id, &state)) {
+        return Vector(state.pos[0], state.pos[1], state.pos[2]);
+      }
       MutexLocker locker(&iMutex);
       NodeMap::const_iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
@@ -772,6 +795,10 @@ namespace mars {
 
     const Quaternion NodeManager::getRotation(NodeId id) const {
       Quaternion q(Quaternion::Identity());
+      NodeStateEntry state;
+      if(stateSnapshot.read(id, &state)) {
+        return Quaternion(state.rot[3], state.rot[0], state.rot[1], state.rot[2]);
+      }
       MutexLocker locker(&iMutex);
       NodeMap::const_iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
@@ -782,6 +809,11 @@ namespace mars {
 
     const Vector NodeManager::getLinearVelocity(NodeId id) const {
       Vector vel(0.0,0.0,0.0);
+      NodeStateEntry state;
+      if(stateSnapshot.read(id, &state)) {
+        return Vector(state.linearVelocity[0], state.linearVelocity[1],
+                      state.linearVelocity[2]);
+      }
       MutexLocker locker(&iMutex);
       NodeMap::const_iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
@@ -791,6 +823,11 @@ namespace mars {
 
     const Vector NodeManager::getAngularVelocity(NodeId id) const {
       Vector avel(0.0,0.0,0.0);
+      NodeStateEntry state;
+      if(stateSnapshot.read(id, &state)) {
+        return Vector(state.angularVelocity[0], state.angularVelocity[1],
+                      state.angularVelocity[2]);
+      }
       MutexLocker locker(&iMutex);
       NodeMap::const_iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
@@ -801,6 +838,11 @@ namespace mars {
 
     const Vector NodeManager::getLinearAcceleration(NodeId id) const {
       Vector acc(0.0,0.0,0.0);
+      NodeStateEntry state;
+      if(stateSnapshot.read(id, &state)) {
+        return Vector(state.linearAcceleration[0], state.linearAcceleration[1],
+                      state.linearAcceleration[2]);
+      }
       MutexLocker locker(&iMutex);
       NodeMap::const_iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
@@ -810,6 +852,11 @@ namespace mars {
 
     const Vector NodeManager::getAngularAcceleration(NodeId id) const {
       Vector aacc(0.0,0.0,0.0);
+      NodeStateEntry state;
+      if(stateSnapshot.read(id, &state)) {
+        return Vector(state.angularAcceleration[0], state.angularAcceleration[1],
+                      state.angularAcceleration[2]);
+      }
       MutexLocker locker(&iMutex);
       NodeMap::const_iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
@@ -825,6 +872,7 @@ namespace mars {
      */
     void NodeManager::setRotation(NodeId id, const Quaternion &rot) {
       MutexLocker locker(&iMutex);
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
         iter->second->setRotation(rot, 1);
@@ -880,8 +928,10 @@ namespace mars {
       if (iter != simNodes.end()) {
         iter->second->addSensor(sensor);
         NodeMap::iterator kter = simNodesDyn.find(sensor->getAttachedNode());
-        if (kter == simNodesDyn.end())
+        if (kter == simNodesDyn.end()) {
           simNodesDyn[iter->first] = iter->second;
+          nodesChanged = true;
+        }
       }
       else
         {
@@ -1089,6 +1139,7 @@ namespace mars {
     void NodeManager::rotateNode(NodeId id, Vector pivot, Quaternion q,
                                  unsigned long excludeJointId, bool includeConnected) {
       std::vector<int> gids;
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodes.find(id);
       if(iter == simNodes.end()) {
         iMutex.unlock();
@@ -1125,6 +1176,7 @@ namespace mars {
     void NodeManager::positionNode(NodeId id, Vector pos,
                                    unsigned long excludeJointId) {
       std::vector<int> gids;
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodes.find(id);
       if(iter == simNodes.end()) {
         iMutex.unlock();
@@ -1190,6 +1242,7 @@ namespace mars {
       Vector* friction;
 
       iMutex.lock();
+      stateSnapshot.invalidate();
       for(iter = simNodesReload.begin(); iter != simNodesReload.end(); iter++) {
         tmp = *iter;
         if(tmp.c_params.friction_direction1) {
@@ -1268,14 +1321,182 @@ namespace mars {
     /**
      *\brief Updates the Node values of dynamical nodes from the physics.
      */
+    void NodeManager::rebuildUpdateList(void) {
+      NodeMap::iterator iter;
+      NodeInterface *physicalNode;
+
+      updateNodesList.clear();
+      physicalNodes.clear();
+      for(iter = simNodesDyn.begin(); iter != simNodesDyn.end(); iter++) {
+        physicalNode = iter->second->getInterface();
+        if(!physicalNode) continue;
+        updateNodesList.push_back(iter->second);
+        physicalNodes.push_back(physicalNode);
+      }
+      nodesChanged = false;
+    }
+
+    void NodeManager::publishUpdateTime(double time) {
+      if(!control->dataBroker) return;
+      if(dbUpdateTimeId) {
+        unsigned long revision = control->dataBroker->getReceiverRevision();
+        if(revision != dbUpdateTimeRevision) {
+          dbUpdateTimeRevision = revision;
+          dbUpdateTimeReceivers = control->dataBroker->hasReceivers(dbUpdateTimeId);
+        }
+        if(!dbUpdateTimeReceivers) return;
+      }
+      dbUpdateTimePackage[0].d = time;
+      dbUpdateTimePackage[1].i = (int)updateNodesList.size();
+      if(!dbUpdateTimeId) {
+        dbUpdateTimeId = control->dataBroker->pushData("mars_sim", "nodeUpdateTime",
+                                                       dbUpdateTimePackage, NULL,
+                                                       data_broker::DATA_PACKAGE_READ_FLAG);
+      }
+      else {
+        control->dataBroker->pushData(dbUpdateTimeId, dbUpdateTimePackage);
+      }
+    }
+
+    /**
+     * The states of all dynamic nodes are read from the physics in one
+     * locked pass into nodeStates. The damped velocities are collected
+     * and also set in one pass.
+     */
     void NodeManager::updateDynamicNodes(sReal calc_ms, bool physics_thread) {
+      long long startTime = getTimeMicro();
+      NodeVelocityCommand damping;
+      PhysicsInterface *physics = control->sim->getPhysics();
+      iMutex.lock();
+      if(nodesChanged) rebuildUpdateList();
+
+      if(physics->getNodeStates(physicalNodes, &nodeStates)) {
+        dampingCommands.clear();
+        for(size_t i=0; i<updateNodesList.size(); ++i) {
+          if(updateNodesList[i]->updateState(nodeStates[i], calc_ms,
+                                             physics_thread, &damping)) {
+            dampingCommands.push_back(damping);
+          }
+        }
+        if(!dampingCommands.empty()) {
+          physics->setNodeVelocities(dampingCommands);
+        }
+      }
+      else {
+        for(size_t i=0; i<updateNodesList.size(); ++i) {
+          updateNodesList[i]->update(calc_ms, physics_thread);
+        }
+      }
+      iMutex.unlock();
+      publishUpdateTime((getTimeMicro()-startTime)*0.001);
+    }
+
+    /**
+     * The nodes are grouped by island. Every island reads the states of
+     * its nodes with one lock of the world, see updateIsland().
+     */
+    void NodeManager::updateDynamicNodes(sReal calc_ms,
+                                         const std::vector<std::vector<unsigned long> > &islands,
+                                         ThreadPool *pool,
+                                         std::vector<double> *islandTimes) {
       MutexLocker locker(&iMutex);
+      std::vector<SimNode*> remaining;
+      std::map<NodeId, size_t> nodeIsland;
+      std::map<NodeId, size_t>::iterator it;
       NodeMap::iterator iter;
+      NodeInterface *physicalNode;
+
+      nodeIslands.resize(islands.size());
+      for(size_t i=0; i<islands.size(); ++i) {
+        nodeIslands[i].nodes.clear();
+        nodeIslands[i].physicalNodes.clear();
+        for(size_t k=0; k<islands[i].size(); ++k) {
+          nodeIsland[islands[i][k]] = i;
+        }
+      }
       for(iter = simNodesDyn.begin(); iter != simNodesDyn.end(); iter++) {
-        iter->second->update(calc_ms, physics_thread);
+        physicalNode = iter->second->getInterface();
+        it = nodeIsland.find(iter->first);
+        if(physicalNode && it != nodeIsland.end()) {
+          nodeIslands[it->second].nodes.push_back(iter->second);
+          nodeIslands[it->second].physicalNodes.push_back(physicalNode);
+        }
+        else remaining.push_back(iter->second);
+      }
+
+      IslandUpdateJob<NodeManager> job(this, calc_ms, islandTimes);
+      pool->run(&job, islands.size());
+      for(size_t i=0; i<remaining.size(); ++i) {
+        remaining[i]->update(calc_ms);
+      }
+    }
+
+    /**
+     * Called by an IslandUpdateJob with a locked iMutex.
+     */
+    void NodeManager::updateIsland(size_t index, sReal calc_ms) {
+      NodeIsland &island = nodeIslands[index];
+      NodeVelocityCommand damping;
+      PhysicsInterface *physics = control->sim->getPhysics();
+
+      if(physics->getNodeStates(island.physicalNodes, &island.states)) {
+        island.dampingCommands.clear();
+        for(size_t i=0; i<island.nodes.size(); ++i) {
+          if(island.nodes[i]->updateState(island.states[i], calc_ms,
+                                          true, &damping)) {
+            island.dampingCommands.push_back(damping);
+          }
+        }
+        if(!island.dampingCommands.empty()) {
+          physics->setNodeVelocities(island.dampingCommands);
+        }
+      }
+      else {
+        for(size_t i=0; i<island.nodes.size(); ++i) {
+          island.nodes[i]->update(calc_ms);
+        }
       }
     }
 
+    static void copyVector(const Vector &v, sReal *dest) {
+      dest[0] = v.x();
+      dest[1] = v.y();
+      dest[2] = v.z();
+    }
+
+    /**
+     * \brief Publishes the states of all dynamic nodes. The getters read
+     * them without locking any mutex, see NodeStateSnapshot.
+     */
+    void NodeManager::publishNodeStates() {
+      NodeMap::iterator iter;
+      NodeStateEntry state;
+      Quaternion q;
+
+      MutexLocker locker(&iMutex);
+      publishIds.clear();
+      publishStates.clear();
+      // the map is sorted by id as required by the snapshot
+      for(iter = simNodesDyn.begin(); iter != simNodesDyn.end(); ++iter) {
+        copyVector(iter->second->getPosition(), state.pos);
+        q = iter->second->getRotation();
+        state.rot[0] = q.x();
+        state.rot[1] = q.y();
+        state.rot[2] = q.z();
+        state.rot[3] = q.w();
+        copyVector(iter->second->getLinearVelocity(), state.linearVelocity);
+        copyVector(iter->second->getAngularVelocity(), state.angularVelocity);
+        copyVector(iter->second->getLinearAcceleration(),
+                   state.linearAcceleration);
+        copyVector(iter->second->getAngularAcceleration(),
+                   state.angularAcceleration);
+        copyVector(iter->second->getContactForce(), state.contactForce);
+        publishIds.push_back(iter->first);
+        publishStates.push_back(state);
+      }
+      stateSnapshot.publish(publishIds, publishStates);
+    }
+
     void NodeManager::preGraphicsUpdate() {
       NodeMap::iterator iter;
       if(!control->graphics)
@@ -1326,14 +1547,17 @@ namespace mars {
      */
     void NodeManager::clearAllNodes(bool clear_all, bool clearGraphics) {
       MutexLocker locker(&iMutex);
+      stateSnapshot.invalidate();
       NodeMap::iterator iter;
       while (!simNodes.empty())
         removeNode(simNodes.begin()->first, false, clearGraphics);
       while (!vizNodes.empty())
         removeNode(vizNodes.begin()->first, false, clearGraphics);
       simNodes.clear();
+      nodeNames.clear();
       vizNodes.clear();
       simNodesDyn.clear();
+      nodesChanged = true;
       if(clear_all) simNodesReload.clear();
       next_node_id = 1;
       iMutex.unlock();
@@ -1371,6 +1595,7 @@ namespace mars {
 
     void NodeManager::setVelocity(NodeId id, const Vector& vel) {
       MutexLocker locker(&iMutex);
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodesDyn.find(id);
       if (iter != simNodesDyn.end())
         iter->second->setLinearVelocity(vel);
@@ -1379,6 +1604,7 @@ namespace mars {
 
     void NodeManager::setAngularVelocity(NodeId id, const Vector& vel) {
       MutexLocker locker(&iMutex);
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodesDyn.find(id);
       if (iter != simNodesDyn.end())
         iter->second->setAngularVelocity(vel);
@@ -1430,6 +1656,7 @@ namespace mars {
 
     void NodeManager::addRotation(NodeId id, const Quaternion &q) {
       MutexLocker locker(&iMutex);
+      stateSnapshot.invalidate();
       NodeMap::iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
         iter->second->addRotation(q);
@@ -1513,6 +1740,11 @@ namespace mars {
 
 
     const Vector NodeManager::getContactForce(NodeId id) const {
+      NodeStateEntry state;
+      if(stateSnapshot.read(id, &state)) {
+        return Vector(state.contactForce[0], state.contactForce[1],
+                      state.contactForce[2]);
+      }
       MutexLocker locker(&iMutex);
       NodeMap::const_iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
@@ -1560,30 +1792,13 @@ namespace mars {
     }
 
     NodeId NodeManager::getID(const std::string& node_name) const {
-
-      iMutex.lock();
-      NodeMap::const_iterator iter;
-      for(iter = simNodes.begin(); iter != simNodes.end(); iter++) {
-        if (iter->second->getName() == node_name)  {
-          iMutex.unlock();
-          return iter->first;
-        }
-      }
-      iMutex.unlock();
-      return INVALID_ID;
+      MutexLocker locker(&iMutex);
+      return nodeNames.find(node_name);
     }
 
     std::vector<interfaces::NodeId> NodeManager::getNodeIDs(const std::string& str_in_name) const {
-      iMutex.lock();
-      NodeMap::const_iterator iter;
-      std::vector<interfaces::NodeId> out;
-      for(iter = simNodes.begin(); iter != simNodes.end(); iter++) {
-        if (iter->second->getName().find(str_in_name) != std::string::npos)  {
-          out.push_back(iter->first);
-        }
-      }
-      iMutex.unlock();
-      return out;
+      MutexLocker locker(&iMutex);
+      return nodeNames.findSubstring(str_in_name);
     }
 
     void NodeManager::pushToUpdate(SimNode* node) {
@@ -1661,6 +1876,7 @@ namespace mars {
                                const Quaternion &visOffsetRot,
                                bool doLock) {
       NodeMap::const_iterator iter = simNodes.find(id);
+      stateSnapshot.invalidate();
 
       if (iter != simNodes.end()) {
         iter->second->updatePR(pos, rot, visOffsetPos, visOffsetRot);
@@ -1678,6 +1894,7 @@ namespace mars {
 
     void NodeManager::setIsMovable(NodeId id, bool isMovable) {
       NodeMap::iterator iter = simNodes.find(id);
+      stateSnapshot.invalidate();
       if(iter != simNodes.end())
         iter->second->setMovable(isMovable);
     }
@@ -1917,6 +2134,7 @@ namespace mars {
         control->graphics->setDrawObjectScale(editedNode->getGraphicsID2(), nodeS->ext);
       }
       editedNode->changeNode(nodeS);
+      nodeNames.rename(sNode.name, editedNode->getName(), sNode.index);
       if(sNode.groupID != 0 || nodeS->groupID != 0) {
         for(auto it: simNodes) {
           if(it.second->getGroupID() == sNode.groupID ||
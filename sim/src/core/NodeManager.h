@@ -36,12 +36,17 @@
 #include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/NodeManagerInterface.h>
+#include <mars/data_broker/DataPackage.h>
+
+#include "NodeStateSnapshot.h"
+#include "NameIndex.h"
 
 namespace mars {
   namespace sim {
 
     class SimJoint;
     class SimNode;
+    template <typename T> class IslandUpdateJob;
 
     typedef std::map<interfaces::NodeId, SimNode*> NodeMap;
 
@@ -107,6 +112,11 @@ namespace mars {
       virtual void setReloadFriction(interfaces::NodeId id, interfaces::sReal friction1,
                                      interfaces::sReal friction2);
       virtual void updateDynamicNodes(interfaces::sReal calc_ms, bool physics_thread = true);
+      virtual void updateDynamicNodes(interfaces::sReal calc_ms,
+                                      const std::vector<std::vector<unsigned long> > &islands,
+                                      utils::ThreadPool *pool,
+                                      std::vector<double> *islandTimes=NULL);
+      virtual void publishNodeStates();
       virtual void clearAllNodes(bool clear_all=false, bool clearGraphics=true);
       virtual void setReloadAngle(interfaces::NodeId id, const utils::sRotation &angle);
       virtual void setContactParams(interfaces::NodeId id, const interfaces::contact_params &cp);
@@ -169,10 +179,41 @@ namespace mars {
       NodeMap simNodesDyn;
       NodeMap nodesToUpdate;
       NodeMap vizNodes;
+      /// names of simNodes, guarded by iMutex
+      NameIndex nodeNames;
       std::list<interfaces::NodeData> simNodesReload;
       unsigned long maxGroupID;
       lib_manager::LibManager *libManager;
       mutable utils::Mutex iMutex;
+      NodeStateSnapshot stateSnapshot;
+      std::vector<interfaces::NodeId> publishIds;
+      std::vector<NodeStateEntry> publishStates;
+
+      // dynamic nodes with a physical representation, gathered in one pass
+      void rebuildUpdateList(void);
+      void publishUpdateTime(double time);
+      std::vector<SimNode*> updateNodesList;
+      std::vector<interfaces::NodeInterface*> physicalNodes;
+      std::vector<interfaces::NodeBodyState> nodeStates;
+      std::vector<interfaces::NodeVelocityCommand> dampingCommands;
+      bool nodesChanged;
+      data_broker::DataPackage dbUpdateTimePackage;
+      unsigned long dbUpdateTimeId;
+      // the receivers of the update time are checked again if the receiver
+      // revision of the DataBroker changed
+      unsigned long dbUpdateTimeRevision;
+      bool dbUpdateTimeReceivers;
+
+      // the dynamic nodes of one physics island, see updateIsland()
+      struct NodeIsland {
+        std::vector<SimNode*> nodes;
+        std::vector<interfaces::NodeInterface*> physicalNodes;
+        std::vector<interfaces::NodeBodyState> states;
+        std::vector<interfaces::NodeVelocityCommand> dampingCommands;
+      };
+      friend class IslandUpdateJob<NodeManager>;
+      void updateIsland(size_t index, interfaces::sReal calc_ms);
+      std::vector<NodeIsland> nodeIslands;
 
       interfaces::ControlCenter *control;
 
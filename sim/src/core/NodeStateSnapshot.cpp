@@ -0,0 +1,125 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "NodeStateSnapshot.h"
+
+#include <algorithm>
+
+namespace mars {
+  namespace sim {
+
+    using namespace interfaces;
+
+    NodeStateSnapshot::NodeStateSnapshot() : current(0), readers(0) {
+    }
+
+    NodeStateSnapshot::~NodeStateSnapshot() {
+      delete current;
+      for(size_t i=0; i<retired.size(); ++i) {
+        delete retired[i];
+      }
+    }
+
+    void NodeStateSnapshot::publish(const std::vector<NodeId> &ids,
+                                    const std::vector<NodeStateEntry> &states) {
+      Frame *frame = current;
+
+      if(!frame || frame->ids != ids) {
+        if(frame) retired.push_back(frame);
+        // a new frame is complete before readers can see it
+        frame = new Frame;
+        frame->ids = ids;
+        frame->states[0] = states;
+        frame->states[1] = states;
+        frame->sequence[0] = frame->sequence[1] = 0;
+        frame->version = 0;
+        frame->valid = true;
+        __sync_synchronize();
+        current = frame;
+        __sync_synchronize();
+      }
+      else {
+        // write the buffer the readers are not directed to
+        unsigned long buffer = (frame->version+1) & 1;
+        frame->sequence[buffer]++;
+        __sync_synchronize();
+        std::copy(states.begin(), states.end(),
+                  frame->states[buffer].begin());
+        __sync_synchronize();
+        frame->sequence[buffer]++;
+        __sync_synchronize();
+        frame->version++;
+        frame->valid = true;
+        __sync_synchronize();
+      }
+
+      // a reader counts itself before it loads the current frame, so
+      // without readers no one can hold a retired frame anymore
+      if(!retired.empty() && readers == 0) {
+        for(size_t i=0; i<retired.size(); ++i) {
+          delete retired[i];
+        }
+        retired.clear();
+      }
+    }
+
+    void NodeStateSnapshot::invalidate() {
+      if(current) {
+        current->valid = false;
+        __sync_synchronize();
+      }
+    }
+
+    bool NodeStateSnapshot::read(NodeId id, NodeStateEntry *state) const {
+      bool result;
+
+      __sync_fetch_and_add(&readers, 1);
+      result = readFrame(current, id, state);
+      __sync_fetch_and_sub(&readers, 1);
+      return result;
+    }
+
+    bool NodeStateSnapshot::readFrame(const Frame *frame, NodeId id,
+                                      NodeStateEntry *state) {
+      unsigned long buffer, sequence;
+
+      __sync_synchronize();
+      if(!frame || !frame->valid) return false;
+      std::vector<NodeId>::const_iterator it;
+      it = std::lower_bound(frame->ids.begin(), frame->ids.end(), id);
+      if(it == frame->ids.end() || *it != id) return false;
+      size_t index = it - frame->ids.begin();
+
+      while(true) {
+        buffer = frame->version & 1;
+        __sync_synchronize();
+        sequence = frame->sequence[buffer];
+        __sync_synchronize();
+        if(sequence & 1) continue;
+        *state = frame->states[buffer][index];
+        __sync_synchronize();
+        if(frame->sequence[buffer] == sequence) break;
+      }
+      return frame->valid;
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
@@ -0,0 +1,115 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+/**
+ * \file NodeStateSnapshot.h
+ * \brief "NodeStateSnapshot" publishes the states of the dynamic nodes
+ *        once per step for readers that must not lock.
+ *
+ * The states are written into two buffers in turn. Each buffer is guarded
+ * by a sequence counter: the writer makes it odd while the buffer is
+ * written, readers retry if the counter changed while they copied an
+ * entry. Readers never take a mutex.
+ */
+
+#ifndef NODE_STATE_SNAPSHOT_H
+#define NODE_STATE_SNAPSHOT_H
+
+#ifdef _PRINT_HEADER_
+  #warning "NodeStateSnapshot.h"
+#endif
+
+#include <mars/interfaces/MARSDefs.h>
+
+#include <vector>
+
+namespace mars {
+  namespace sim {
+
+    /**
+     * The published state of one node. Only plain values are used, so an
+     * entry can be copied while it might be overwritten.
+     */
+    struct NodeStateEntry {
+      interfaces::sReal pos[3];
+      interfaces::sReal rot[4]; ///< x, y, z, w
+      interfaces::sReal linearVelocity[3];
+      interfaces::sReal angularVelocity[3];
+      interfaces::sReal linearAcceleration[3];
+      interfaces::sReal angularAcceleration[3];
+      interfaces::sReal contactForce[3];
+    };
+
+    class NodeStateSnapshot {
+    public:
+      NodeStateSnapshot();
+      ~NodeStateSnapshot();
+
+      /**
+       * \brief Publishes the states of the nodes \a ids.
+       *
+       * \a ids has to be sorted. Calls of publish() and invalidate() have
+       * to be serialized by the caller.
+       */
+      void publish(const std::vector<interfaces::NodeId> &ids,
+                   const std::vector<NodeStateEntry> &states);
+
+      /**
+       * \brief Marks the published states as outdated until the next
+       * publish(), e.g. because a node was moved.
+       */
+      void invalidate();
+
+      /**
+       * \brief Copies the published state of node \a id.
+       * \return \c false if the node is not published or the states are
+       *         outdated.
+       */
+      bool read(interfaces::NodeId id, NodeStateEntry *state) const;
+
+    private:
+      struct Frame {
+        std::vector<interfaces::NodeId> ids;
+        std::vector<NodeStateEntry> states[2];
+        volatile unsigned long sequence[2];
+        volatile unsigned long version;
+        volatile bool valid;
+      };
+
+      static bool readFrame(const Frame *frame, interfaces::NodeId id,
+                            NodeStateEntry *state);
+
+      // disallow copying
+      NodeStateSnapshot(const NodeStateSnapshot &);
+      NodeStateSnapshot &operator=(const NodeStateSnapshot &);
+
+      Frame * volatile current;
+      // frames are replaced if the set of nodes changes; a reader might
+      // still use an old one, so they are deleted by a later publish()
+      // that finds no reader
+      std::vector<Frame*> retired;
+      mutable volatile int readers;
+    }; // end of class NodeStateSnapshot
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif // NODE_STATE_SNAPSHOT_H
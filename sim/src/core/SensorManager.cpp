@@ -185,12 +185,8 @@ namespace mars {
 
     unsigned long SensorManager::getSensorID(std::string name) const {
       MutexLocker locker(&iMutex);
-      std::map<unsigned long, BaseSensor*>::const_iterator it;
-      for(it = simSensors.begin(); it != simSensors.end(); it++){
-        if(it->second->name.compare(name) == 0){
-          return it->first;
-        }
-      }
+      unsigned long id = sensorNames.find(name);
+      if(id) return id;
       printf("Cannot find Sensor with name: \"%s\"\n",name.c_str());
       return 0;
     }
@@ -207,8 +203,10 @@ namespace mars {
       if (iter != simSensors.end()) {
         tmpSensor = iter->second;
         simSensors.erase(iter);
-        if (tmpSensor)
+        if (tmpSensor) {
+          sensorNames.remove(tmpSensor->name, index);
           delete tmpSensor;
+        }
       }
       iMutex.unlock();
 
@@ -252,6 +250,16 @@ namespace mars {
       return 0;
     }
 
+    SensorDataView SensorManager::getSensorView(unsigned long id) const {
+      MutexLocker locker(&iMutex);
+      map<unsigned long, BaseSensor*>::const_iterator iter;
+
+      iter = simSensors.find(id);
+      if (iter != simSensors.end())
+        return iter->second->getSensorView();
+      return SensorDataView();
+    }
+
 
     /**
      *\brief Returns the number of sensors that are currently present in the simulation.
@@ -282,6 +290,7 @@ namespace mars {
         delete sensor;
       }
       simSensors.clear();
+      sensorNames.clear();
       if(clear_all) simSensorsReload.clear();
       next_sensor_id = 1;
     }
@@ -339,6 +348,7 @@ namespace mars {
       BaseSensor *sensor = ((*it).second)(this->control,config);
       iMutex.lock();
       simSensors[id] = sensor;
+      sensorNames.add(sensor->name, id);
       iMutex.unlock();
 
       if(!reload) {
@@ -43,6 +43,8 @@
 #include <mars/utils/Mutex.h>
 #include <configmaps/ConfigData.h>
 
+#include "NameIndex.h"
+
 namespace mars {
   namespace sim {
 
@@ -176,6 +178,7 @@ namespace mars {
        * \param index The index of the sensor to get the data
        */
       virtual int getSensorData(unsigned long id, interfaces::sReal **data) const;
+      virtual interfaces::SensorDataView getSensorView(unsigned long id) const;
 
       /**
        *\brief Returns the number of sensors that are currently present in the simulation.
@@ -224,6 +227,9 @@ namespace mars {
       //! a containter for all sensors currently present in the simulation
       std::map<unsigned long, interfaces::BaseSensor*> simSensors;
 
+      //! the names of the sensors, guarded by iMutex
+      NameIndex sensorNames;
+
       //! a containter for all sensors that are loaded after a reset of the simulation
       std::vector<SensorReloadHelper> simSensorsReload;
 
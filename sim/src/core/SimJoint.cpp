@@ -41,6 +41,9 @@ namespace mars {
       : control(c) {
 
       physical_joint = 0;
+      dbId = 0;
+      feedbackRequired = false;
+      feedbackValid = false;
       setSJoint(sJoint_);
 
       pushToDataBroker = 2;
@@ -58,9 +61,9 @@ namespace mars {
         std::string groupName, dataName;
         getDataBrokerNames(&groupName, &dataName);
         if(control->dataBroker) {
-          control->dataBroker->pushData(groupName, dataName,
-                                        dbPackage, NULL,
-                                        data_broker::DATA_PACKAGE_READ_FLAG);
+          dbId = control->dataBroker->pushData(groupName, dataName,
+                                               dbPackage, NULL,
+                                               data_broker::DATA_PACKAGE_READ_FLAG);
           control->dataBroker->registerTimedProducer(this, groupName, dataName,
                                                      "mars_sim/simTimer", 0);
         }
@@ -224,28 +227,49 @@ namespace mars {
     }
 
     void SimJoint::update(sReal calc_ms){
-      CPP_UNUSED(calc_ms);
       if (physical_joint) {
-        // update the position and rotation of the node
-        double ode_position1 = (sJoint.angle1_offset + invert*physical_joint->getPosition());
-        double ode_position2 = (sJoint.angle2_offset + invert*physical_joint->getPosition2());
-
-        physical_joint->getAnchor(&anchor);
-        physical_joint->getAxis(&axis1);
-        physical_joint->getAxis2(&axis2);
-        physical_joint->getForce1(&f1);
-        physical_joint->getForce2(&f2);
-        physical_joint->getTorque1(&t1);
-        physical_joint->getTorque2(&t2);
+        JointState state;
+        state.position1 = physical_joint->getPosition();
+        state.position2 = physical_joint->getPosition2();
+        physical_joint->getAnchor(&state.anchor);
+        physical_joint->getAxis(&state.axis1);
+        physical_joint->getAxis2(&state.axis2);
+        physical_joint->getForce1(&state.f1);
+        physical_joint->getForce2(&state.f2);
+        physical_joint->getTorque1(&state.t1);
+        physical_joint->getTorque2(&state.t2);
         physical_joint->update();
-        physical_joint->getAxisTorque(&axis1_torque);
-        physical_joint->getAxis2Torque(&axis2_torque);
-        physical_joint->getJointLoad(&joint_load);
-        axis1_torque *= invert;
-        axis2_torque *= invert;
-        joint_load *= invert;
-        velocity1 = invert*physical_joint->getVelocity();
-        velocity2 = invert*physical_joint->getVelocity2();
+        physical_joint->getAxisTorque(&state.axis1Torque);
+        physical_joint->getAxis2Torque(&state.axis2Torque);
+        physical_joint->getJointLoad(&state.jointLoad);
+        state.velocity1 = physical_joint->getVelocity();
+        state.velocity2 = physical_joint->getVelocity2();
+        state.motorTorque = physical_joint->getMotorTorque();
+        updateState(state, calc_ms, true);
+      }
+    }
+
+    void SimJoint::updateState(const JointState &state, sReal calc_ms,
+                               bool withFeedback) {
+        // update the position and rotation of the node
+        double ode_position1 = (sJoint.angle1_offset + invert*state.position1);
+        double ode_position2 = (sJoint.angle2_offset + invert*state.position2);
+
+        anchor = state.anchor;
+        axis1 = state.axis1;
+        axis2 = state.axis2;
+        if(withFeedback) {
+          f1 = state.f1;
+          f2 = state.f2;
+          t1 = state.t1;
+          t2 = state.t2;
+          axis1_torque = state.axis1Torque*invert;
+          axis2_torque = state.axis2Torque*invert;
+          joint_load = state.jointLoad*invert;
+        }
+        feedbackValid = withFeedback;
+        velocity1 = invert*state.velocity1;
+        velocity2 = invert*state.velocity2;
         if(sJoint.type == JOINT_TYPE_SLIDER) {
           position1 = ode_position1;
           position2 = ode_position2;
@@ -261,8 +285,7 @@ namespace mars {
           else error = fmod(position2, M_PI) - fmod(ode_position2-M_PI, M_PI);
           if(fabs(error) < 0.1) position2 -= error;
         }
-        motor_torque = invert*physical_joint->getMotorTorque();
-      }
+        motor_torque = invert*state.motorTorque;
     }
 
     void SimJoint::setSJoint(const JointData &sJoint) {
@@ -354,6 +377,18 @@ namespace mars {
       }
     }
 
+    bool SimJoint::getMotorCommand(interfaces::JointMotorCommand *command,
+                                   interfaces::sReal velocity,
+                                   interfaces::sReal effortLimit,
+                                   unsigned char axis_index) const {
+      if(!physical_joint) return false;
+      command->joint = physical_joint;
+      command->axis = axis_index == 1 ? 1 : 2;
+      command->velocity = velocity*invert;
+      command->effortLimit = effortLimit;
+      return true;
+    }
+
     void SimJoint::setVelocity2(sReal velocity) { // deprecated
       setVelocity(velocity, 1);
     }
@@ -407,7 +442,28 @@ namespace mars {
       obj->rot = angleAxisToQuaternion(position1*invert, axis1);
     }
 
+    /**
+     * Reads the forces and torques of the last step from the physics if
+     * the JointManager skipped them.
+     */
+    void SimJoint::updateFeedback(void) const {
+      if(feedbackValid || !physical_joint) return;
+      physical_joint->getForce1(&f1);
+      physical_joint->getForce2(&f2);
+      physical_joint->getTorque1(&t1);
+      physical_joint->getTorque2(&t2);
+      physical_joint->update();
+      physical_joint->getAxisTorque(&axis1_torque);
+      physical_joint->getAxis2Torque(&axis2_torque);
+      physical_joint->getJointLoad(&joint_load);
+      axis1_torque *= invert;
+      axis2_torque *= invert;
+      joint_load *= invert;
+      feedbackValid = true;
+    }
+
     const utils::Vector SimJoint::getForceVector(unsigned char axis_index) const {
+      updateFeedback();
       return axis_index == 1 ? f1 : f2;
     }
 
@@ -420,6 +476,7 @@ namespace mars {
     }
 
     const Vector SimJoint::getTorqueVector(unsigned char axis_index) const {
+      updateFeedback();
       return axis_index == 1 ? t1 : t2;
     }
 
@@ -436,6 +493,7 @@ namespace mars {
     }
 
     const Vector SimJoint::getTorqueVectorAroundAxis(unsigned char axis_index) const {
+      updateFeedback();
       return axis_index == 1 ? axis1_torque : axis2_torque;
     }
 
@@ -448,6 +506,7 @@ namespace mars {
     }
 
     const Vector SimJoint::getJointLoad(void) const {
+      updateFeedback();
       return joint_load;
     }
 
@@ -485,6 +544,22 @@ namespace mars {
       updateStepSize();
     }
 
+    JointInterface* SimJoint::getPhysicalJoint(void) const {
+      return physical_joint;
+    }
+
+    unsigned long SimJoint::getDataBrokerId(void) const {
+      return dbId;
+    }
+
+    bool SimJoint::isFeedbackRequired(void) const {
+      return feedbackRequired;
+    }
+
+    void SimJoint::setFeedbackRequired(bool required) {
+      feedbackRequired = required;
+    }
+
     sReal SimJoint::getMotorTorque(void) const {
       return motor_torque;
     }
@@ -106,6 +106,13 @@ namespace mars {
       // function members
       void rotateAxis(const utils::Quaternion &rotatem, unsigned char axis_index=1);
       void update(interfaces::sReal calc_ms);
+      /**
+       * \brief Equals update() with a state that is read by
+       *        PhysicsInterface::getJointStates(). Forces and torques are
+       *        only taken if \a withFeedback is set.
+       */
+      void updateState(const interfaces::JointState &state,
+                       interfaces::sReal calc_ms, bool withFeedback);
       void reattachJoint(void);
       void attachMotor(unsigned char axis_index);
       void detachMotor(unsigned char axis_index);
@@ -125,6 +132,12 @@ namespace mars {
       interfaces::sReal getUpperLimit(unsigned char axis_index=1) const;
       interfaces::sReal getMotorTorque(void) const;  // FIXME: this should not be in the joint
       interfaces::NodeId getNodeId(unsigned char node_index=1) const;
+      interfaces::JointInterface* getPhysicalJoint(void) const;
+      /**
+       * \returns The id of the DataPackage of the joint or 0.
+       */
+      unsigned long getDataBrokerId(void) const;
+      bool isFeedbackRequired(void) const;
       const interfaces::JointData getSJoint(void) const;
       interfaces::sReal getVelocity(unsigned char axis_index=1) const;
       interfaces::sReal getTorque(interfaces::sReal torque, unsigned char axis_index=1) const;
@@ -147,6 +160,24 @@ namespace mars {
       void setLowerLimit(interfaces::sReal limit, unsigned char axis_index=1);
       void setUpperLimit(interfaces::sReal limit, unsigned char axis_index=1);
       void setInvertAxis(bool v);
+      /**
+       * \brief Forces and torques of a joint are only updated by the
+       *        JointManager if they are pushed to a DataBroker receiver or
+       *        required with this flag. Otherwise the getters read them from
+       *        the physics on the first call after a step. Set the flag if
+       *        they are read in every step.
+       */
+      void setFeedbackRequired(bool required);
+      /**
+       * \brief Fills the command that equals setEffortLimit() and
+       *        setVelocity() of an axis when it is applied by
+       *        PhysicsInterface::setJointMotorCommands().
+       * \return \c false if there is no physical joint.
+       */
+      bool getMotorCommand(interfaces::JointMotorCommand *command,
+                           interfaces::sReal velocity,
+                           interfaces::sReal effortLimit,
+                           unsigned char axis_index=1) const;
       // inherited from DataBroker ProducerInterface
       void getDataBrokerNames(std::string *groupName, std::string *dataName) const;
       virtual void produceData(const data_broker::DataInfo &info,
@@ -203,13 +234,19 @@ namespace mars {
       interfaces::sReal lowerLimit1, lowerLimit2, upperLimit1, upperLimit2;
       utils::Vector anchor;
       utils::Vector axis1, axis2; // axes
-      utils::Vector f1, f2; // forces
-      utils::Vector t1, t2; // torques
-      utils::Vector axis1_torque, axis2_torque, joint_load;
+      // the feedback is read on demand if it was skipped in the last step
+      mutable utils::Vector f1, f2; // forces
+      mutable utils::Vector t1, t2; // torques
+      mutable utils::Vector axis1_torque, axis2_torque, joint_load;
+      mutable bool feedbackValid;
       interfaces::sReal motor_torque, invert;
       utils::Vector axis1InNode1;
       utils::Vector node1ToAnchor;
       int pushToDataBroker;
+      unsigned long dbId;
+      bool feedbackRequired;
+
+      void updateFeedback(void) const;
 
       // for dataBroker communication
       void setupDataPackageMapping();
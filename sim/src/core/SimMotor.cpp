@@ -688,6 +688,22 @@ namespace mars {
         sMotor.type == MOTOR_TYPE_UNDEFINED);
     }
 
+    bool SimMotor::isMimic() const {
+      return mimic;
+    }
+
+    bool SimMotor::hasMimics() const {
+      return !mimics.empty();
+    }
+
+    bool SimMotor::isBatchable() const {
+      // the batch only implements the position controller and does not
+      // keep the update order that mimics depend on
+      return (active && myJoint && !myPlayJoint && !mimic && mimics.empty() &&
+              runController == &SimMotor::runPositionController &&
+              !sMotor.config.hasKey("spring"));
+    }
+
     void SimMotor::setType(interfaces::MotorType mtype){
       sMotor.type = mtype;
       updateController();
@@ -103,6 +103,13 @@ namespace mars {
       interfaces::sReal getEffort(void) const;
       unsigned long getIndex(void) const;
       bool isServo() const;
+      bool isMimic() const;
+      bool hasMimics() const;
+      /**
+       * \brief Returns \c true if the motor can be updated by a MotorBatch
+       *        instead of update().
+       */
+      bool isBatchable() const;
       SimJoint* getJoint() const;
       unsigned long getJointIndex(void) const;
       const std::string getName() const;
@@ -164,6 +171,9 @@ namespace mars {
 
 
     private:
+      // the batch runs the position controller on copies of the state
+      friend class MotorBatch;
+
       // typedefs for function pointers
       typedef  void (SimJoint::*JointControlFunction)(interfaces::sReal, unsigned char);
       typedef void (SimMotor::*MotorControlFunction)(interfaces::sReal);
@@ -66,12 +66,14 @@ namespace mars {
       frictionDirNode = 0;
       fDirNode = Vector(1, 0, 0);
       my_interface = 0;
-      l_vel = Vector(0.0, 0.0, 0.0);
-      a_vel = Vector(0.0, 0.0, 0.0);
-      f = Vector(0.0, 0.0, 0.0);
-      t = Vector(0.0, 0.0, 0.0);
-      ground_contact = 0;
-      ground_contact_force = 0;
+      bodyState.pos = sNode.pos;
+      bodyState.rot = sNode.rot;
+      bodyState.linearVelocity = Vector(0.0, 0.0, 0.0);
+      bodyState.angularVelocity = Vector(0.0, 0.0, 0.0);
+      bodyState.force = Vector(0.0, 0.0, 0.0);
+      bodyState.torque = Vector(0.0, 0.0, 0.0);
+      bodyState.groundContact = false;
+      bodyState.groundContactForce = 0;
       i_velocity_sum = 0.0;
       for(int i=0; i<BACK_VEL; i++)
         i_velocity[i] = 0.0;
@@ -112,28 +114,28 @@ namespace mars {
         dbPackageMapping.add("rotation/y", &sNode.rot.y());
         dbPackageMapping.add("rotation/z", &sNode.rot.z());
         dbPackageMapping.add("rotation/w", &sNode.rot.w());
-        dbPackageMapping.add("contact", &ground_contact);
-        dbPackageMapping.add("contactForce", &ground_contact_force);
+        dbPackageMapping.add("contact", &bodyState.groundContact);
+        dbPackageMapping.add("contactForce", &bodyState.groundContactForce);
       }
       if(pushToDataBroker > 1) {
-        dbPackageMapping.add("linearVelocity/x", &l_vel.x());
-        dbPackageMapping.add("linearVelocity/y", &l_vel.y());
-        dbPackageMapping.add("linearVelocity/z", &l_vel.z());
-        dbPackageMapping.add("angularVelocity/x", &a_vel.x());
-        dbPackageMapping.add("angularVelocity/y", &a_vel.y());
-        dbPackageMapping.add("angularVelocity/z", &a_vel.z());
+        dbPackageMapping.add("linearVelocity/x", &bodyState.linearVelocity.x());
+        dbPackageMapping.add("linearVelocity/y", &bodyState.linearVelocity.y());
+        dbPackageMapping.add("linearVelocity/z", &bodyState.linearVelocity.z());
+        dbPackageMapping.add("angularVelocity/x", &bodyState.angularVelocity.x());
+        dbPackageMapping.add("angularVelocity/y", &bodyState.angularVelocity.y());
+        dbPackageMapping.add("angularVelocity/z", &bodyState.angularVelocity.z());
         dbPackageMapping.add("linearAcceleration/x", &l_acc.x());
         dbPackageMapping.add("linearAcceleration/y", &l_acc.y());
         dbPackageMapping.add("linearAcceleration/z", &l_acc.z());
         dbPackageMapping.add("angularAcceleration/x", &a_acc.x());
         dbPackageMapping.add("angularAcceleration/y", &a_acc.y());
         dbPackageMapping.add("angularAcceleration/z", &a_acc.z());
-        dbPackageMapping.add("force/x", &f.x());
-        dbPackageMapping.add("force/y", &f.y());
-        dbPackageMapping.add("force/z", &f.z());
-        dbPackageMapping.add("torque/x", &t.x());
-        dbPackageMapping.add("torque/y", &t.y());
-        dbPackageMapping.add("torque/z", &t.z());
+        dbPackageMapping.add("force/x", &bodyState.force.x());
+        dbPackageMapping.add("force/y", &bodyState.force.y());
+        dbPackageMapping.add("force/z", &bodyState.force.z());
+        dbPackageMapping.add("torque/x", &bodyState.torque.x());
+        dbPackageMapping.add("torque/y", &bodyState.torque.y());
+        dbPackageMapping.add("torque/z", &bodyState.torque.z());
       }
       if(pushToDataBroker > 0) {
         addToDataBroker();
@@ -156,6 +158,10 @@ namespace mars {
         delete my_interface;
         my_interface = 0;
       }
+      if(sNode.mesh.shared) {
+        sNode.mesh.vertices = 0;
+        sNode.mesh.indices = 0;
+      }
       if (sNode.mesh.vertices) {
         delete[] sNode.mesh.vertices;
         sNode.mesh.vertices = 0;
@@ -316,11 +322,11 @@ namespace mars {
 
     const Vector SimNode::getLinearVelocity() const {
       MutexLocker locker(&iMutex);
-      return l_vel;
+      return bodyState.linearVelocity;
     }
     const Vector SimNode::getAngularVelocity() const {
       MutexLocker locker(&iMutex);
-      return a_vel;
+      return bodyState.angularVelocity;
     }
     const Vector SimNode::getLinearAcceleration() const {
       MutexLocker locker(&iMutex);
@@ -332,11 +338,11 @@ namespace mars {
     }
     const Vector SimNode::getForce() const {
       MutexLocker locker(&iMutex);
-      return f;
+      return bodyState.force;
     }
     const Vector SimNode::getTorque() const {
       MutexLocker locker(&iMutex);
-      return t;
+      return bodyState.torque;
     }
 
     int SimNode::getGroupID(void) const {
@@ -543,24 +549,45 @@ namespace mars {
      *
      */
     void SimNode::update(sReal calc_ms, bool physics_thread) {
+      if (my_interface) {
+        NodeBodyState state;
+        NodeVelocityCommand damping;
+        my_interface->getPosition(&state.pos);
+        my_interface->getRotation(&state.rot);
+        my_interface->getLinearVelocity(&state.linearVelocity);
+        my_interface->getAngularVelocity(&state.angularVelocity);
+        my_interface->getForce(&state.force);
+        my_interface->getTorque(&state.torque);
+        state.groundContact = my_interface->getGroundContact();
+        state.groundContactForce = my_interface->getGroundContactForce();
+        if(updateState(state, calc_ms, physics_thread, &damping)) {
+          if(damping.setLinear) {
+            my_interface->setLinearVelocity(damping.linearVelocity);
+          }
+          if(damping.setAngular) {
+            my_interface->setAngularVelocity(damping.angularVelocity);
+          }
+        }
+      }
+    }
+
+    bool SimNode::updateState(const NodeBodyState &state, sReal calc_ms,
+                              bool physics_thread,
+                              NodeVelocityCommand *damping) {
       MutexLocker locker(&iMutex);
+      damping->node = my_interface;
+      damping->setLinear = damping->setAngular = false;
       if (my_interface) {
-        Vector damping;
         sReal d;
-        last_l_vel = l_vel;
-        last_a_vel = a_vel;
+        last_l_vel = bodyState.linearVelocity;
+        last_a_vel = bodyState.angularVelocity;
+        bodyState = state;
         // update the position and rotation of the node
-        my_interface->getPosition(&sNode.pos);
-        my_interface->getRotation(&sNode.rot);
-        my_interface->getLinearVelocity(&l_vel);
-        my_interface->getAngularVelocity(&a_vel);
-        my_interface->getForce(&f);
-        my_interface->getTorque(&t);
-        ground_contact = my_interface->getGroundContact();
-        ground_contact_force = my_interface->getGroundContactForce();
+        sNode.pos = state.pos;
+        sNode.rot = state.rot;
         if(calc_ms > 0) {
-          l_acc = (l_vel - last_l_vel) / (calc_ms / 1000.);
-          a_acc = (a_vel - last_a_vel) / (calc_ms / 1000.);
+          l_acc = (bodyState.linearVelocity - last_l_vel) / (calc_ms / 1000.);
+          a_acc = (bodyState.angularVelocity - last_a_vel) / (calc_ms / 1000.);
         } else {
           l_acc = Vector(0, 0, 0);
           a_acc = Vector(0, 0, 0);
@@ -571,36 +598,37 @@ namespace mars {
         //d = i_velocity_sum / BACK_VEL;
 
         //d = fabs(a_vel.length());
-        d = fabs(a_vel.norm());
+        d = fabs(bodyState.angularVelocity.norm());
 
         // here we can handle damping
+        // the velocities are set by the caller
         if (sNode.linear_damping != 0) {
-          damping = l_vel;
-          damping *= 1-sNode.linear_damping;
-          my_interface->setLinearVelocity(damping);
+          damping->linearVelocity = bodyState.linearVelocity;
+          damping->linearVelocity *= 1-sNode.linear_damping;
+          damping->setLinear = true;
         }
         if (sNode.angular_treshold && d < sNode.angular_treshold) {
-          damping = a_vel;
+          damping->angularVelocity = bodyState.angularVelocity;
           /*
                damping.normalize();
                damping *= ((i_velocity[1]-i_velocity[2])*(1-sNode.angular_low)+
                i_velocity[1]);
                //damping *= i_velocity[0];
                */
-          damping *= 1-sNode.angular_low;
+          damping->angularVelocity *= 1-sNode.angular_low;
           //i_velocity_sum -= i_velocity[vel_ptr];
           //i_velocity[vel_ptr] = damping.length();
           //i_velocity_sum += i_velocity[vel_ptr];
-          my_interface->setAngularVelocity(damping);
+          damping->setAngular = true;
         }
         else if (sNode.angular_damping != 0) {
-          damping = a_vel;
+          damping->angularVelocity = bodyState.angularVelocity;
           /*damping.normalize();
             damping *= ((i_velocity[1]-i_velocity[2])*(1-sNode.angular_damping)+
             i_velocity[1]);
             //damping *= i_velocity[0];
             */
-          damping *= 1-sNode.angular_damping;
+          damping->angularVelocity *= 1-sNode.angular_damping;
           //i_velocity_sum -= i_velocity[vel_ptr];
           //i_velocity[vel_ptr] = damping.length();
           /*
@@ -612,7 +640,7 @@ namespace mars {
             damping *= 0;
             }*/
           //i_velocity_sum += i_velocity[vel_ptr];
-          my_interface->setAngularVelocity(damping);
+          damping->setAngular = true;
         }
         // handle friction direction by mirror node orientation
         if(frictionDirNode && my_interface) {
@@ -630,6 +658,7 @@ namespace mars {
         }
         checkNodeState();
       }
+      return damping->setLinear || damping->setAngular;
     }
 
     void SimNode::getCoreExchange(core_objects_exchange *obj) const {
@@ -698,17 +727,17 @@ namespace mars {
       MutexLocker locker(&iMutex);
       if (my_interface) {
         my_interface->setLinearVelocity(state.l_vel);
-        l_vel = state.l_vel;
+        bodyState.linearVelocity = state.l_vel;
         my_interface->setAngularVelocity(state.a_vel);
-        a_vel = state.a_vel;
+        bodyState.angularVelocity = state.a_vel;
       }
     }
 
     void SimNode::getPhysicalState(nodeState *state) const {
       MutexLocker locker(&iMutex);
       if (my_interface) {
-        state->l_vel = l_vel;
-        state->a_vel = a_vel;
+        state->l_vel = bodyState.linearVelocity;
+        state->a_vel = bodyState.angularVelocity;
       }
     }
 
@@ -716,7 +745,7 @@ namespace mars {
       MutexLocker locker(&iMutex);
       if (my_interface) {
         my_interface->setLinearVelocity(vel);
-        l_vel = vel;
+        bodyState.linearVelocity = vel;
       }
     }
 
@@ -724,18 +753,18 @@ namespace mars {
       MutexLocker locker(&iMutex);
       if (my_interface) {
         my_interface->setAngularVelocity(vel);
-        a_vel = vel;
+        bodyState.angularVelocity = vel;
       }
     }
 
     bool SimNode::getGroundContact(void) const {
       MutexLocker locker(&iMutex);
-      return ground_contact;
+      return bodyState.groundContact;
     }
 
     sReal SimNode::getGroundContactForce(void) const {
       MutexLocker locker(&iMutex);
-      return ground_contact_force;
+      return bodyState.groundContactForce;
     }
 
     void SimNode::clearRelativePosition(void) {
@@ -167,6 +167,15 @@ namespace mars {
       
       // manipulation
       void update(interfaces::sReal calc_ms, bool physics_thread = true); ///< Updates the values of the node from the physical layer.
+      /**
+       * \brief Equals update() with a state that is read by
+       *        PhysicsInterface::getNodeStates().
+       * \param damping Is filled with the damped velocities.
+       * \return \c true if the damping has to be applied by the caller.
+       */
+      bool updateState(const interfaces::NodeBodyState &state,
+                       interfaces::sReal calc_ms, bool physics_thread,
+                       interfaces::NodeVelocityCommand *damping);
       void rotateAtPoint(const utils::Vector &rotation_point, const utils::Quaternion &rotation, bool move_group);
       void changeNode(interfaces::NodeData *node);
       void clearRelativePosition(void);
@@ -197,16 +206,12 @@ namespace mars {
     private:
       interfaces::ControlCenter *control;
       interfaces::NodeData sNode;
-      utils::Vector f;
-      utils::Vector t;
-      utils::Vector l_vel;
+      /// the state of the last gather of the NodeManager, read by the getters
+      interfaces::NodeBodyState bodyState;
       utils::Vector last_l_vel;
-      utils::Vector a_vel;
       utils::Vector last_a_vel;
       utils::Vector l_acc;
       utils::Vector a_acc;
-      bool ground_contact;
-      interfaces::sReal ground_contact_force;
       interfaces::NodeInterface *my_interface;
       bool has_sensor;
       interfaces::sReal i_velocity_sum;
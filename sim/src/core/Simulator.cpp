@@ -43,6 +43,8 @@
 #include <mars/interfaces/sim/LoadCenter.h>
 #include <mars/interfaces/sim/LoadSceneInterface.h>
 #include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/data_broker/DataRecorder.h>
+#include <mars/data_broker/DataReplayer.h>
 #include <lib_manager/LibInterface.hpp>
 #include <mars/interfaces/Logging.hpp>
 
@@ -77,15 +79,41 @@ namespace mars {
 
     Simulator::Simulator(lib_manager::LibManager *theManager) :
       lib_manager::LibInterface(theManager),
-      exit_sim(false), allow_draw(true),
+      batch_world(false), exit_sim(false), allow_draw(true),
       sync_graphics(false), physics_mutex_count(0), physics(0),
       haveNewPlugin(false) {
+      init(NULL);
+    }
 
+    Simulator::Simulator(lib_manager::LibManager *theManager,
+                         data_broker::DataBrokerInterface *dataBroker) :
+      lib_manager::LibInterface(theManager),
+      batch_world(true), exit_sim(false), allow_draw(true),
+      sync_graphics(false), physics_mutex_count(0), physics(0),
+      haveNewPlugin(false) {
+      init(dataBroker);
+    }
+
+    void Simulator::init(data_broker::DataBrokerInterface *dataBroker) {
       config_dir = DEFAULT_CONFIG_DIR;
       calc_time = 0;
       avg_step_time = avg_log_time = 0;
       count = 0;
       config_dir = ".";
+      parallel_islands = false;
+      island_threads = 4;
+      ray_threads = 1;
+      batched_motors = false;
+      db_threads = 1;
+      db_coalesce_time = 0;
+      db_timer_threads = 1;
+      island_count = 0;
+      islandNumSum = islandMinSum = islandMaxSum = islandMeanSum = 0.0;
+      dbIslandId = 0;
+      dataRecorder = NULL;
+      dataReplayer = NULL;
+      dbSimTimerId = dbPrePhysicsTriggerId = 0;
+      dbPostPhysicsTriggerId = dbFinishedDrawTriggerId = 0;
 
       std_port = 1600;
 
@@ -109,7 +137,9 @@ namespace mars {
       arg_grid   = 0;
       arg_ortho  = 0;
 
-      Simulator::activeSimulator = this; // set this Simulator object to the active one
+      if(!batch_world) {
+        Simulator::activeSimulator = this; // set this Simulator object to the active one
+      }
 
       gravity = Vector(0.0, 0.0, -9.81); // set gravity to earth conditions
 
@@ -122,12 +152,21 @@ namespace mars {
       dbSimDebugPackage.add("simUpdate", 0.);
       dbSimDebugPackage.add("worldStep", 0.);
       dbSimDebugPackage.add("logStep", 0.);
+      // the islands change with the contacts, thus only a fixed summary
+      // of their update times is published
+      dbIslandPackage.add("islands", 0.);
+      dbIslandPackage.add("minTime", 0.);
+      dbIslandPackage.add("maxTime", 0.);
+      dbIslandPackage.add("meanTime", 0.);
 
       // load optional libs
+      control->dataBroker = dataBroker;
       checkOptionalDependency("data_broker");
       checkOptionalDependency("cfg_manager");
-      checkOptionalDependency("mars_graphics");
-      checkOptionalDependency("log_console");
+      if(!batch_world) {
+        checkOptionalDependency("mars_graphics");
+        checkOptionalDependency("log_console");
+      }
 
       getTimeMutex.lock();
       realStartTime = utils::getTime();
@@ -141,6 +180,24 @@ namespace mars {
 
       if (control->controllers) delete control->controllers;
 
+      if(batch_world) {
+        if(control->cfg) {
+          control->cfg->unregisterFromCFG(this);
+        }
+        // a batch world owns its managers and physics; the objects are
+        // already cleared by the BatchSimulator
+        delete control->entities;
+        delete control->sensors;
+        delete control->motors;
+        delete control->joints;
+        delete control->nodes;
+        delete physics;
+        delete control->loadCenter;
+        delete control;
+        libManager->releaseLibrary("cfg_manager");
+        return;
+      }
+
       if(control->cfg) {
         string saveFile = configPath.sValue;
         saveFile.append("/mars_Config.yaml");
@@ -158,6 +215,9 @@ namespace mars {
         saveFile.append("/mars_Simulator.yaml");
         control->cfg->writeConfig(saveFile.c_str(), "Simulator");
       }
+      // the recorder and the replayer use the DataBroker
+      delete dataReplayer;
+      delete dataRecorder;
       // TODO: do we need to delete control?
       libManager->releaseLibrary("mars_graphics");
       libManager->releaseLibrary("cfg_manager");
@@ -171,9 +231,14 @@ namespace mars {
 
     void Simulator::checkOptionalDependency(const string &libName) {
       if(libName == "data_broker") {
-        control->dataBroker = libManager->getLibraryAs<data_broker::DataBrokerInterface>("data_broker");
+        // a batch world keeps the DataBroker it was created with
+        if(!batch_world) {
+          control->dataBroker = libManager->getLibraryAs<data_broker::DataBrokerInterface>("data_broker");
+          if(control->dataBroker) {
+            ControlCenter::theDataBroker = control->dataBroker;
+          }
+        }
         if(control->dataBroker) {
-          ControlCenter::theDataBroker = control->dataBroker;
           // create streams
           getTimeMutex.lock();
           dbSimTimeId = control->dataBroker->pushData("mars_sim", "simTime",
@@ -184,11 +249,19 @@ namespace mars {
                                                        dbSimDebugPackage,
                                                        NULL,
                                                        data_broker::DATA_PACKAGE_READ_FLAG);
+          dbIslandId = control->dataBroker->pushData("mars_sim", "islandTime",
+                                                     dbIslandPackage,
+                                                     NULL,
+                                                     data_broker::DATA_PACKAGE_READ_FLAG);
           getTimeMutex.unlock();
           control->dataBroker->createTimer("mars_sim/simTimer");
           control->dataBroker->createTrigger("mars_sim/prePhysicsUpdate");
           control->dataBroker->createTrigger("mars_sim/postPhysicsUpdate");
           control->dataBroker->createTrigger("mars_sim/finishedDrawTrigger");
+          dbSimTimerId = control->dataBroker->getTimerID("mars_sim/simTimer");
+          dbPrePhysicsTriggerId = control->dataBroker->getTriggerID("mars_sim/prePhysicsUpdate");
+          dbPostPhysicsTriggerId = control->dataBroker->getTriggerID("mars_sim/postPhysicsUpdate");
+          dbFinishedDrawTriggerId = control->dataBroker->getTriggerID("mars_sim/finishedDrawTrigger");
         } else {
           fprintf(stderr, "ERROR: could not get DataBroker!\n");
         }
@@ -225,7 +298,7 @@ namespace mars {
 
     void Simulator::runSimulation(bool startThread) {
 
-      if(control->cfg) {
+      if(control->cfg && !batch_world) {
         configPath = control->cfg->getOrCreateProperty("Config", "config_path",
                                                          config_dir);
 
@@ -244,13 +317,14 @@ namespace mars {
           loadFile = configPath.sValue+"/mars_saveOnClose.yaml";
           control->cfg->loadConfig(loadFile.c_str());
         }
-
-        initCfgParams();
       }
+      // batch worlds share the configuration of the main simulator
+      initCfgParams();
 
       control->nodes = new NodeManager(control, libManager);
       control->joints = new JointManager(control);
       control->motors = new MotorManager(control);
+      control->motors->setBatchedUpdate(batched_motors);
       control->sensors = new SensorManager(control);
       control->controllers = new ControllerManager(control);
       control->entities = new EntityManager(control);
@@ -264,6 +338,7 @@ namespace mars {
       // init the physics-engine
       //Convention startPhysics function
       physics = PhysicsMapper::newWorldPhysics(control);
+      if(control->cfg) setSpaceParams();
       physics->initTheWorld();
       // the physics step_size is in seconds
       physics->step_size = calc_ms/1000.;
@@ -277,6 +352,9 @@ namespace mars {
       gravity.z() = cfgGZ.dValue;
       physics->world_gravity = gravity;
       physics->draw_contact_points = cfgDrawContact.bValue;
+      physics->parallel_islands = parallel_islands;
+      physics->num_island_threads = island_threads;
+      physics->num_ray_threads = ray_threads;
 #ifndef __linux__
       this->setStackSize(16777216);
       fprintf(stderr, "INFO: set physics stack size to: %lu\n", getStackSize());
@@ -372,15 +450,27 @@ namespace mars {
       time = utils::getTime();
 
       if(control->dataBroker) {
-        control->dataBroker->trigger("mars_sim/prePhysicsUpdate");
+        // a DataBroker without ids returns 0
+        if(dbPrePhysicsTriggerId) {
+          control->dataBroker->trigger(dbPrePhysicsTriggerId);
+        }
+        else control->dataBroker->trigger("mars_sim/prePhysicsUpdate");
       }
       physics->stepTheWorld();
 
       avg_step_time += getTimeDiff(time);
 
-      control->nodes->updateDynamicNodes(calc_ms); //Moved update to here, otherwise RaySensor is one step behind the world every time
-      control->joints->updateJoints(calc_ms);
-      control->motors->updateMotors(calc_ms);
+      if(parallel_islands) {
+        updateIslands();
+      } else {
+        control->nodes->updateDynamicNodes(calc_ms); //Moved update to here, otherwise RaySensor is one step behind the world every time
+        control->joints->updateJoints(calc_ms);
+        control->motors->updateMotors(calc_ms);
+      }
+      // the nodes queued the rays of their sensors while they were updated
+      physics->castSensorRays();
+      // the controllers and other threads read this state without locking
+      control->nodes->publishNodeStates();
       control->controllers->updateControllers(calc_ms);
 
       time = utils::getTime();
@@ -391,7 +481,10 @@ namespace mars {
       if(control->dataBroker) {
         control->dataBroker->pushData(dbSimTimeId,
                                       dbSimTimePackage);
-        control->dataBroker->stepTimer("mars_sim/simTimer", calc_ms);
+        if(dbSimTimerId) {
+          control->dataBroker->stepTimer(dbSimTimerId, calc_ms);
+        }
+        else control->dataBroker->stepTimer("mars_sim/simTimer", calc_ms);
       }
 
       avg_log_time += getTimeDiff(time);
@@ -447,7 +540,10 @@ namespace mars {
         }
       }
       if(control->dataBroker) {
-        control->dataBroker->trigger("mars_sim/postPhysicsUpdate");
+        if(dbPostPhysicsTriggerId) {
+          control->dataBroker->trigger(dbPostPhysicsTriggerId);
+        }
+        else control->dataBroker->trigger("mars_sim/postPhysicsUpdate");
       }
 
       if(setState) {
@@ -457,6 +553,117 @@ namespace mars {
       physicsThreadUnlock();
     }
 
+    /**
+     * \brief Updates the nodes, joints and motors of independent physics
+     * islands concurrently.
+     *
+     * The calling thread takes part in the update, thus the pool gets one
+     * worker less than the configured number of island threads. The number
+     * of islands and the minimum, maximum and mean update time of an
+     * island are averaged over avg_count_steps and published in
+     * "mars_sim/islandTime".
+     */
+    void Simulator::updateIslands(void) {
+      size_t numWorkers = island_threads > 1 ? island_threads-1 : 0;
+      if(islandPool.getNumThreads() != numWorkers) {
+        islandPool.setNumThreads(numWorkers);
+      }
+
+      physics->getIslands(&islands);
+      // the vector keeps its capacity between the steps
+      islandTimes.assign(islands.size(), 0.0);
+
+      control->nodes->updateDynamicNodes(calc_ms, islands, &islandPool,
+                                         &islandTimes);
+      control->joints->updateJoints(calc_ms, islands, &islandPool,
+                                    &islandTimes);
+      control->motors->updateMotors(calc_ms, islands, &islandPool,
+                                    &islandTimes);
+
+      if(!islandTimes.empty()) {
+        double minTime = islandTimes[0], maxTime = islandTimes[0];
+        double sumTime = 0.0;
+        for(size_t i=0; i<islandTimes.size(); ++i) {
+          if(islandTimes[i] < minTime) minTime = islandTimes[i];
+          if(islandTimes[i] > maxTime) maxTime = islandTimes[i];
+          sumTime += islandTimes[i];
+        }
+        islandNumSum += islandTimes.size();
+        islandMinSum += minTime;
+        islandMaxSum += maxTime;
+        islandMeanSum += sumTime / islandTimes.size();
+      }
+
+      if(++island_count > avg_count_steps) {
+        dbIslandPackage[0].d = islandNumSum / island_count;
+        dbIslandPackage[1].d = islandMinSum / island_count;
+        dbIslandPackage[2].d = islandMaxSum / island_count;
+        dbIslandPackage[3].d = islandMeanSum / island_count;
+        islandNumSum = islandMinSum = islandMaxSum = islandMeanSum = 0.0;
+        island_count = 0;
+        if(control->dataBroker && dbIslandId) {
+          control->dataBroker->pushData(dbIslandId, dbIslandPackage);
+        }
+      }
+    }
+
+    /**
+     * \brief Stops a running recording and starts a new one if
+     * "Simulator/data record file" is set.
+     */
+    void Simulator::updateDataRecorder(void) {
+      std::vector<std::string> patterns;
+      std::vector<std::string>::iterator it;
+      size_t pos;
+
+      delete dataRecorder;
+      dataRecorder = NULL;
+      if(!control->dataBroker || batch_world || cfgRecordFile.sValue.empty()) {
+        return;
+      }
+      dataRecorder = new data_broker::DataRecorder(control->dataBroker);
+      patterns = explodeString(';', cfgRecordPatterns.sValue);
+      for(it=patterns.begin(); it!=patterns.end(); ++it) {
+        if(it->empty()) continue;
+        // the data names may contain further slashes
+        pos = it->find('/');
+        if(pos == std::string::npos) {
+          dataRecorder->addPattern(*it, "*");
+        }
+        else {
+          dataRecorder->addPattern(it->substr(0, pos), it->substr(pos+1));
+        }
+      }
+      if(!dataRecorder->open(cfgRecordFile.sValue)) {
+        LOG_ERROR("Simulator: could not record to %s",
+                  cfgRecordFile.sValue.c_str());
+        delete dataRecorder;
+        dataRecorder = NULL;
+      }
+    }
+
+    /**
+     * \brief Stops a running replay and plays "Simulator/data replay file"
+     * from the beginning if it is set.
+     */
+    void Simulator::updateDataReplayer(void) {
+      delete dataReplayer;
+      dataReplayer = NULL;
+      if(!control->dataBroker || batch_world || cfgReplayFile.sValue.empty()) {
+        return;
+      }
+      dataReplayer = new data_broker::DataReplayer(control->dataBroker);
+      if(!dataReplayer->open(cfgReplayFile.sValue)) {
+        LOG_ERROR("Simulator: could not replay %s",
+                  cfgReplayFile.sValue.c_str());
+        delete dataReplayer;
+        dataReplayer = NULL;
+        return;
+      }
+      dataReplayer->setSpeed(cfgReplaySpeed.dValue);
+      dataReplayer->play();
+    }
+
     /**
      * \return \c true if started, \c false if stopped
      */
@@ -678,15 +885,7 @@ namespace mars {
           msleep(10);
         }
         reloadSim = false;
-        control->controllers->setLoadingAllowed(false);
-
-        newWorld();
-        reloadWorld();
-        control->controllers->resetControllerData();
-        control->entities->resetPose();
-        for (unsigned int i=0; i<allPlugins.size(); i++)
-          allPlugins[i].p_interface->reset();
-        control->controllers->setLoadingAllowed(true);
+        resetWorld();
         if (was_running) {
           StartSimulation();
         }
@@ -736,7 +935,10 @@ namespace mars {
       }
       pluginLocker.unlock();
 
-      control->dataBroker->trigger("mars_sim/finishedDrawTrigger");
+      if(dbFinishedDrawTriggerId) {
+        control->dataBroker->trigger(dbFinishedDrawTriggerId);
+      }
+      else control->dataBroker->trigger("mars_sim/finishedDrawTrigger");
     }
 
     void Simulator::newWorld(bool clear_all) {
@@ -781,6 +983,18 @@ namespace mars {
     }
 
 
+    void Simulator::resetWorld(void) {
+      control->controllers->setLoadingAllowed(false);
+
+      newWorld();
+      reloadWorld();
+      control->controllers->resetControllerData();
+      control->entities->resetPose();
+      for (unsigned int i=0; i<allPlugins.size(); i++)
+        allPlugins[i].p_interface->reset();
+      control->controllers->setLoadingAllowed(true);
+    }
+
     void Simulator::reloadWorld(void) {
       control->nodes->reloadNodes(reloadGraphics);
       control->joints->reloadJoints();
@@ -1291,6 +1505,134 @@ namespace mars {
         return;
       }
 
+      if(_property.paramId == cfgParallelIslands.paramId) {
+        parallel_islands = _property.bValue;
+        if(physics) physics->parallel_islands = parallel_islands;
+        return;
+      }
+
+      if(_property.paramId == cfgIslandThreads.paramId) {
+        island_threads = _property.iValue;
+        if(physics) physics->num_island_threads = island_threads;
+        return;
+      }
+
+      if(_property.paramId == cfgRayThreads.paramId) {
+        ray_threads = _property.iValue;
+        if(physics) physics->num_ray_threads = ray_threads;
+        return;
+      }
+
+      if(_property.paramId == cfgBatchedMotors.paramId) {
+        batched_motors = _property.bValue;
+        if(control->motors) control->motors->setBatchedUpdate(batched_motors);
+        return;
+      }
+
+      if(_property.paramId == cfgDBThreads.paramId) {
+        db_threads = _property.iValue;
+        if(control->dataBroker) {
+          control->dataBroker->setAsyncDispatch(db_threads, db_coalesce_time);
+        }
+        return;
+      }
+
+      if(_property.paramId == cfgDBTimerThreads.paramId) {
+        db_timer_threads = _property.iValue;
+        if(control->dataBroker) {
+          control->dataBroker->setTimerThreads(db_timer_threads);
+        }
+        return;
+      }
+
+      if(_property.paramId == cfgDBCoalesceTime.paramId) {
+        db_coalesce_time = _property.iValue;
+        if(control->dataBroker) {
+          control->dataBroker->setAsyncDispatch(db_threads, db_coalesce_time);
+        }
+        return;
+      }
+
+      if(_property.paramId == cfgRecordFile.paramId) {
+        cfgRecordFile = _property;
+        updateDataRecorder();
+        return;
+      }
+
+      if(_property.paramId == cfgRecordPatterns.paramId) {
+        cfgRecordPatterns = _property;
+        // the patterns are used from the next recording on
+        return;
+      }
+
+      if(_property.paramId == cfgReplayFile.paramId) {
+        cfgReplayFile = _property;
+        updateDataReplayer();
+        return;
+      }
+
+      if(_property.paramId == cfgReplaySpeed.paramId) {
+        cfgReplaySpeed = _property;
+        if(dataReplayer) dataReplayer->setSpeed(cfgReplaySpeed.dValue);
+        return;
+      }
+
+      // the spaces are created with the next reset of the world
+      if(_property.paramId == cfgStaticSpace.paramId) {
+        cfgStaticSpace = _property;
+      } else if(_property.paramId == cfgDynamicSpace.paramId) {
+        cfgDynamicSpace = _property;
+      } else if(_property.paramId == cfgSpaceCenterX.paramId) {
+        cfgSpaceCenterX = _property;
+      } else if(_property.paramId == cfgSpaceCenterY.paramId) {
+        cfgSpaceCenterY = _property;
+      } else if(_property.paramId == cfgSpaceCenterZ.paramId) {
+        cfgSpaceCenterZ = _property;
+      } else if(_property.paramId == cfgSpaceExtentX.paramId) {
+        cfgSpaceExtentX = _property;
+      } else if(_property.paramId == cfgSpaceExtentY.paramId) {
+        cfgSpaceExtentY = _property;
+      } else if(_property.paramId == cfgSpaceExtentZ.paramId) {
+        cfgSpaceExtentZ = _property;
+      } else if(_property.paramId == cfgSpaceDepth.paramId) {
+        cfgSpaceDepth = _property;
+      } else if(_property.paramId == cfgHashMinLevel.paramId) {
+        cfgHashMinLevel = _property;
+      } else if(_property.paramId == cfgHashMaxLevel.paramId) {
+        cfgHashMaxLevel = _property;
+      } else {
+        return;
+      }
+      if(physics) setSpaceParams();
+
+    }
+
+    static SpaceType getSpaceType(const std::string &name) {
+      if(name == "simple") return SPACE_SIMPLE;
+      if(name == "hash") return SPACE_HASH;
+      if(name == "quadtree") return SPACE_QUADTREE;
+      if(name == "sap") return SPACE_SAP;
+      return SPACE_NONE;
+    }
+
+    /**
+     * \brief Passes the configuration of the collision spaces to the physics.
+     */
+    void Simulator::setSpaceParams(void) {
+      physics->static_space_type = getSpaceType(cfgStaticSpace.sValue);
+      physics->dynamic_space_type = getSpaceType(cfgDynamicSpace.sValue);
+      if(physics->dynamic_space_type == SPACE_NONE) {
+        physics->dynamic_space_type = SPACE_HASH;
+      }
+      physics->space_center = Vector(cfgSpaceCenterX.dValue,
+                                     cfgSpaceCenterY.dValue,
+                                     cfgSpaceCenterZ.dValue);
+      physics->space_extents = Vector(cfgSpaceExtentX.dValue,
+                                      cfgSpaceExtentY.dValue,
+                                      cfgSpaceExtentZ.dValue);
+      physics->space_depth = cfgSpaceDepth.iValue;
+      physics->hash_min_level = cfgHashMinLevel.iValue;
+      physics->hash_max_level = cfgHashMaxLevel.iValue;
     }
 
     void Simulator::initCfgParams(void) {
@@ -1341,9 +1683,83 @@ namespace mars {
       cfgAvgCountSteps = control->cfg->getOrCreateProperty("Simulator", "avg count steps",
                                                            avg_count_steps, this);
       avg_count_steps = cfgAvgCountSteps.iValue;
+
+      cfgParallelIslands = control->cfg->getOrCreateProperty("Simulator", "parallel islands",
+                                                             false, this);
+      parallel_islands = cfgParallelIslands.bValue;
+
+      cfgIslandThreads = control->cfg->getOrCreateProperty("Simulator", "island threads",
+                                                           island_threads, this);
+      island_threads = cfgIslandThreads.iValue;
+
+      cfgRayThreads = control->cfg->getOrCreateProperty("Simulator", "sensor ray threads",
+                                                        ray_threads, this);
+      ray_threads = cfgRayThreads.iValue;
+
+      // update the position controlled motors with the MotorBatch
+      cfgBatchedMotors = control->cfg->getOrCreateProperty("Simulator", "batched motors",
+                                                           false, this);
+      batched_motors = cfgBatchedMotors.bValue;
+
+      // threads and coalesce time in ms of the async DataBroker receivers
+      cfgDBThreads = control->cfg->getOrCreateProperty("Simulator", "data broker threads",
+                                                       db_threads, this);
+      db_threads = cfgDBThreads.iValue;
+      cfgDBCoalesceTime = control->cfg->getOrCreateProperty("Simulator", "data broker coalesce time",
+                                                            db_coalesce_time, this);
+      db_coalesce_time = cfgDBCoalesceTime.iValue;
+      // threads that call the timed producers of the sim timer
+      cfgDBTimerThreads = control->cfg->getOrCreateProperty("Simulator", "data broker timer threads",
+                                                            db_timer_threads, this);
+      db_timer_threads = cfgDBTimerThreads.iValue;
+      if(control->dataBroker) {
+        control->dataBroker->setAsyncDispatch(db_threads, db_coalesce_time);
+        control->dataBroker->setTimerThreads(db_timer_threads);
+      }
+
+      // the DataBroker streams are recorded to the file if it is set, the
+      // patterns are "group/data" names with wildcards separated by ';'
+      cfgRecordFile = control->cfg->getOrCreateProperty("Simulator", "data record file",
+                                                        std::string(""), this);
+      cfgRecordPatterns = control->cfg->getOrCreateProperty("Simulator", "data record patterns",
+                                                            std::string("*/*"), this);
+      // a recorded file is pushed into the DataBroker if it is set, with
+      // the given speed relative to the recording or as fast as possible
+      // with 0
+      cfgReplayFile = control->cfg->getOrCreateProperty("Simulator", "data replay file",
+                                                        std::string(""), this);
+      cfgReplaySpeed = control->cfg->getOrCreateProperty("Simulator", "data replay speed",
+                                                         1.0, this);
+      updateDataRecorder();
+      updateDataReplayer();
+
       control->cfg->getOrCreateProperty("Simulator", "onPhysicsError",
                                         "abort", this);
 
+      // "none", "simple", "hash", "quadtree" or "sap"
+      cfgStaticSpace = control->cfg->getOrCreateProperty("Simulator", "static space",
+                                                         std::string("none"), this);
+      cfgDynamicSpace = control->cfg->getOrCreateProperty("Simulator", "dynamic space",
+                                                          std::string("hash"), this);
+      cfgSpaceCenterX = control->cfg->getOrCreateProperty("Simulator", "quadtree center x",
+                                                          0.0, this);
+      cfgSpaceCenterY = control->cfg->getOrCreateProperty("Simulator", "quadtree center y",
+                                                          0.0, this);
+      cfgSpaceCenterZ = control->cfg->getOrCreateProperty("Simulator", "quadtree center z",
+                                                          0.0, this);
+      cfgSpaceExtentX = control->cfg->getOrCreateProperty("Simulator", "quadtree extent x",
+                                                          100.0, this);
+      cfgSpaceExtentY = control->cfg->getOrCreateProperty("Simulator", "quadtree extent y",
+                                                          100.0, this);
+      cfgSpaceExtentZ = control->cfg->getOrCreateProperty("Simulator", "quadtree extent z",
+                                                          100.0, this);
+      cfgSpaceDepth = control->cfg->getOrCreateProperty("Simulator", "quadtree depth",
+                                                        (int)6, this);
+      cfgHashMinLevel = control->cfg->getOrCreateProperty("Simulator", "hash min level",
+                                                          (int)-3, this);
+      cfgHashMaxLevel = control->cfg->getOrCreateProperty("Simulator", "hash max level",
+                                                          (int)10, this);
+
     }
 
     void Simulator::receiveData(const data_broker::DataInfo &info,
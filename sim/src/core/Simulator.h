@@ -39,6 +39,7 @@
 #include <mars/utils/Mutex.h>
 #include <mars/utils/WaitCondition.h>
 #include <mars/utils/ReadWriteLock.h>
+#include <mars/utils/ThreadPool.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/sim/PhysicsInterface.h>
 #include <mars/interfaces/sim/PluginInterface.h>
@@ -49,6 +50,12 @@
 
 
 namespace mars {
+
+  namespace data_broker {
+    class DataRecorder;
+    class DataReplayer;
+  }
+
   namespace sim {
 
     /**
@@ -79,6 +86,16 @@ namespace mars {
       };
 
       Simulator(lib_manager::LibManager *theManager); ///< Constructor of the \c class Simulator.
+      /**
+       * \brief Creates an additional simulation world, e.g. for a BatchSimulator.
+       *
+       * A batch world uses the given DataBroker instead of the one of the
+       * lib_manager, does not load graphics or the log console and neither
+       * reads nor writes the configuration files. It does not become the
+       * \c activeSimulator.
+       */
+      Simulator(lib_manager::LibManager *theManager,
+                data_broker::DataBrokerInterface *dataBroker);
       virtual ~Simulator();
       static Simulator *activeSimulator;
 
@@ -126,6 +143,12 @@ namespace mars {
       }
 
       virtual void resetSim(bool resetGraphics=true);
+      /**
+       * \brief Immediately rebuilds the world from the reload lists.
+       * In contrast to resetSim() the reset is not deferred to the next
+       * finishedDraw() and the simulation status is not changed.
+       */
+      void resetWorld(void);
       virtual bool isSimRunning() const;
       bool startStopTrigger(); ///< Starts and pauses the simulation.
       virtual void singleStep(void);
@@ -221,15 +244,21 @@ namespace mars {
         bool wasRunning;
       };
 
+      void init(data_broker::DataBrokerInterface *dataBroker);
+
       // simulation control
       void processRequests();
       void reloadWorld(void);      
+      void updateIslands(void);
+      void updateDataRecorder(void);
+      void updateDataReplayer(void);
 
       int arg_no_gui, arg_run, arg_grid, arg_ortho;
       bool reloadSim, reloadGraphics;
       short running;
       char was_running;
       bool kill_sim;
+      bool batch_world; ///< The simulator is an additional world of a BatchSimulator
       interfaces::ControlCenter *control; ///< Pointer to instance of ControlCenter (created in Simulator::Simulator(lib_manager::LibManager *theManager))
       std::vector<LoadOptions> filesToLoad;
       bool sim_fault;
@@ -258,6 +287,7 @@ namespace mars {
       int physics_mutex_count;
       double avg_log_time, avg_step_time;
       int count, avg_count_steps;
+      utils::ThreadPool islandPool;
       interfaces::sReal calc_time;
       
       // physics
@@ -267,8 +297,21 @@ namespace mars {
       int std_port; ///< Controller port (default value: 1600)
       utils::Vector gravity;
       unsigned long dbPhysicsUpdateId;
-      unsigned long dbSimTimeId, dbSimDebugId;
+      unsigned long dbSimTimeId, dbSimDebugId, dbIslandId;
+      // handles of the timer and triggers stepped every simulation step
+      unsigned long dbSimTimerId, dbPrePhysicsTriggerId;
+      unsigned long dbPostPhysicsTriggerId, dbFinishedDrawTriggerId;
       unsigned long realStartTime;
+      bool parallel_islands;
+      int island_threads;
+      int ray_threads;
+      bool batched_motors;
+      int db_threads, db_coalesce_time, db_timer_threads;
+      std::vector<std::vector<unsigned long> > islands;
+      std::vector<double> islandTimes;
+      int island_count;
+      /// sums of the per step island statistics until they are published
+      double islandNumSum, islandMinSum, islandMaxSum, islandMeanSum;
 
       // plugins
       std::vector<interfaces::pluginStruct> allPlugins;
@@ -285,6 +328,7 @@ namespace mars {
 
       // configuration
       void initCfgParams(void);
+      void setSpaceParams(void);
       std::string config_dir;
       cfg_manager::cfgPropertyStruct cfgCalcMs, cfgFaststep;
       cfg_manager::cfgPropertyStruct cfgRealtime, cfgDebugTime;
@@ -296,11 +340,24 @@ namespace mars {
       cfg_manager::cfgPropertyStruct configPath;
       cfg_manager::cfgPropertyStruct cfgUseNow;
       cfg_manager::cfgPropertyStruct cfgAvgCountSteps;
+      cfg_manager::cfgPropertyStruct cfgParallelIslands, cfgIslandThreads;
+      cfg_manager::cfgPropertyStruct cfgRayThreads, cfgBatchedMotors;
+      cfg_manager::cfgPropertyStruct cfgDBThreads, cfgDBCoalesceTime;
+      cfg_manager::cfgPropertyStruct cfgDBTimerThreads;
+      cfg_manager::cfgPropertyStruct cfgRecordFile, cfgRecordPatterns;
+      cfg_manager::cfgPropertyStruct cfgReplayFile, cfgReplaySpeed;
+      cfg_manager::cfgPropertyStruct cfgStaticSpace, cfgDynamicSpace;
+      cfg_manager::cfgPropertyStruct cfgSpaceCenterX, cfgSpaceCenterY, cfgSpaceCenterZ;
+      cfg_manager::cfgPropertyStruct cfgSpaceExtentX, cfgSpaceExtentY, cfgSpaceExtentZ;
+      cfg_manager::cfgPropertyStruct cfgSpaceDepth, cfgHashMinLevel, cfgHashMaxLevel;
       
       // data
       data_broker::DataPackage dbPhysicsUpdatePackage;
       data_broker::DataPackage dbSimTimePackage;
       data_broker::DataPackage dbSimDebugPackage;
+      data_broker::DataPackage dbIslandPackage;
+      data_broker::DataRecorder *dataRecorder;
+      data_broker::DataReplayer *dataReplayer;
 
       // IceServer comServer;
 
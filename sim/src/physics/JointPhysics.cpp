@@ -274,6 +274,42 @@ namespace mars {
       }
     }
 
+    void JointPhysics::setMotorCommand(unsigned char axis, sReal velocity,
+                                       sReal max_force) {
+      if(axis == 1) {
+        switch(joint_type) {
+        case  JOINT_TYPE_HINGE:
+          dJointSetHingeParam(jointId, dParamFMax, (dReal)max_force);
+          dJointSetHingeParam(jointId, dParamVel, (dReal)velocity);
+          break;
+        case JOINT_TYPE_HINGE2:
+          dJointSetHinge2Param(jointId, dParamFMax, (dReal)max_force);
+          dJointSetHinge2Param(jointId, dParamVel, (dReal)velocity);
+          break;
+        case JOINT_TYPE_SLIDER:
+          dJointSetSliderParam(jointId, dParamFMax, (dReal)max_force);
+          dJointSetSliderParam(jointId, dParamVel, (dReal)velocity);
+          break;
+        case JOINT_TYPE_UNIVERSAL:
+          dJointSetUniversalParam(jointId, dParamFMax, (dReal)max_force);
+          dJointSetUniversalParam(jointId, dParamVel, (dReal)velocity);
+          break;
+        }
+      }
+      else {
+        switch(joint_type) {
+        case JOINT_TYPE_HINGE2:
+          dJointSetHinge2Param(jointId, dParamFMax2, (dReal)max_force);
+          dJointSetHinge2Param(jointId, dParamVel2, (dReal)velocity);
+          break;
+        case JOINT_TYPE_UNIVERSAL:
+          dJointSetUniversalParam(jointId, dParamFMax2, (dReal)max_force);
+          dJointSetUniversalParam(jointId, dParamVel2, (dReal)velocity);
+          break;
+        }
+      }
+    }
+
     sReal JointPhysics::getPosition(void) const {
       MutexLocker locker(&(theWorld->iMutex));
 
@@ -911,12 +947,19 @@ namespace mars {
      *
      */
     void JointPhysics::update(void) {
+      MutexLocker locker(&(theWorld->iMutex));
+      updateFeedback();
+    }
+
+    /**
+     * Has to be called with a locked theWorld->iMutex.
+     */
+    void JointPhysics::updateFeedback(void) {
       const dReal *b1_pos, *b2_pos;
       dReal anchor[4], axis[4], axis2[4];
       int calc1 = 0, calc2 = 0;
       dReal radius, dot, torque;
       dReal v1[3], normal[3], load[3], tmp1[3], axis_force[3];
-      MutexLocker locker(&(theWorld->iMutex));
 
       switch(joint_type) {
       case  JOINT_TYPE_HINGE:
@@ -1064,6 +1107,69 @@ namespace mars {
       }
     }
 
+    void JointPhysics::getState(JointState *state, bool withFeedback) {
+      dReal pos[4] = {0,0,0,0};
+      dReal axis[4] = {0,0,0,0};
+      dReal axis2[4] = {0,0,0,0};
+
+      state->position1 = state->position2 = 0;
+      state->velocity1 = state->velocity2 = 0;
+      switch(joint_type) {
+      case  JOINT_TYPE_HINGE:
+        state->position1 = (sReal)dJointGetHingeAngle(jointId);
+        state->velocity1 = (sReal)dJointGetHingeAngleRate(jointId);
+        dJointGetHingeAnchor(jointId, pos);
+        dJointGetHingeAxis(jointId, axis);
+        break;
+      case JOINT_TYPE_HINGE2:
+        state->position1 = (sReal)dJointGetHinge2Angle1(jointId);
+        state->velocity1 = (sReal)dJointGetHinge2Angle1Rate(jointId);
+        state->velocity2 = (sReal)dJointGetHinge2Angle2Rate(jointId);
+        dJointGetHinge2Anchor(jointId, pos);
+        dJointGetHinge2Axis1(jointId, axis);
+        dJointGetHinge2Axis2(jointId, axis2);
+        break;
+      case JOINT_TYPE_SLIDER:
+        state->position1 = (sReal)dJointGetSliderPosition(jointId);
+        state->velocity1 = (sReal)dJointGetSliderPositionRate(jointId);
+        dJointGetSliderAxis(jointId, axis);
+        break;
+      case JOINT_TYPE_BALL:
+        dJointGetBallAnchor(jointId, pos);
+        break;
+      case JOINT_TYPE_UNIVERSAL:
+        state->position1 = (sReal)dJointGetUniversalAngle1(jointId);
+        state->position2 = (sReal)dJointGetUniversalAngle2(jointId);
+        state->velocity1 = (sReal)dJointGetUniversalAngle1Rate(jointId);
+        state->velocity2 = (sReal)dJointGetUniversalAngle2Rate(jointId);
+        dJointGetUniversalAnchor(jointId, pos);
+        dJointGetUniversalAxis1(jointId, axis);
+        dJointGetUniversalAxis2(jointId, axis2);
+        break;
+      default:
+        break;
+      }
+      state->anchor = Vector(pos[0], pos[1], pos[2]);
+      state->axis1 = Vector(axis[0], axis[1], axis[2]);
+      state->axis2 = Vector(axis2[0], axis2[1], axis2[2]);
+
+      if(withFeedback) {
+        updateFeedback();
+        getForce1(&state->f1);
+        getForce2(&state->f2);
+        getTorque1(&state->t1);
+        getTorque2(&state->t2);
+        state->axis1Torque = axis1_torque;
+        state->axis2Torque = axis2_torque;
+        state->jointLoad = joint_load;
+      }
+      else {
+        // the motors read the motor torque of every joint
+        motor_torque = feedback.lambda;
+      }
+      state->motorTorque = motor_torque;
+    }
+
     void JointPhysics::getJointLoad(Vector *t) const {
       t->x() = joint_load.x();
       t->y() = joint_load.y();
@@ -87,7 +87,23 @@ namespace mars {
       virtual void setLowStop2(interfaces::sReal lowStop2);
       virtual void setHighStop2(interfaces::sReal highStop2);
 
+      /**
+       * \brief Sets velocity and force limit of the motor of an axis.
+       * Has to be called with a locked theWorld->iMutex.
+       */
+      void setMotorCommand(unsigned char axis, interfaces::sReal velocity,
+                           interfaces::sReal max_force);
+
+      /**
+       * \brief Reads positions, velocities, anchor and axes and, if
+       *        \a withFeedback is set, the forces and torques.
+       * Has to be called with a locked theWorld->iMutex.
+       */
+      void getState(interfaces::JointState *state, bool withFeedback);
+
     private:
+      void updateFeedback(void);
+
       WorldPhysics* theWorld;
       dJointID jointId, ball_motor;
       dJointFeedback feedback;
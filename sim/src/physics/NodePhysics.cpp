@@ -36,6 +36,7 @@
  */
 
 #include "NodePhysics.h"
+#include "RayTransform.h"
 #include "../sensors/RotatingRaySensor.h"
 
 #include <mars/interfaces/Logging.hpp>
@@ -44,7 +45,8 @@
 #include <mars/interfaces/sensor_bases.h>
 #include <mars/interfaces/terrainStruct.h>
 #include <cmath>
-#include <set>
+#include <cstring>
+#include <map>
 
 
 namespace mars {
@@ -53,6 +55,63 @@ namespace mars {
     using namespace utils;
     using namespace interfaces;
 
+    /**
+     * The ODE data of a shared mesh. It is built by the first node using
+     * the mesh and destroyed with the last one.
+     */
+    struct SharedTriMesh {
+      dVector3 *vertices;
+      dTriIndex *indices;
+      dTriMeshDataID data;
+      int references;
+    };
+
+    static Mutex sharedTriMeshMutex;
+    static std::map<const mydVector3*, SharedTriMesh> sharedTriMeshes;
+
+    static dTriMeshDataID acquireSharedTriMesh(const snmesh &mesh) {
+      MutexLocker locker(&sharedTriMeshMutex);
+      std::map<const mydVector3*, SharedTriMesh>::iterator it;
+      int i;
+
+      it = sharedTriMeshes.find(mesh.vertices);
+      if(it == sharedTriMeshes.end()) {
+        SharedTriMesh shared;
+        shared.vertices = (dVector3*)calloc(mesh.vertexcount, sizeof(dVector3));
+        shared.indices = (dTriIndex*)calloc(mesh.indexcount, sizeof(dTriIndex));
+        for(i=0; i<mesh.vertexcount; i++) {
+          shared.vertices[i][0] = (dReal)mesh.vertices[i][0];
+          shared.vertices[i][1] = (dReal)mesh.vertices[i][1];
+          shared.vertices[i][2] = (dReal)mesh.vertices[i][2];
+        }
+        for(i=0; i<mesh.indexcount; i++) {
+          shared.indices[i] = (dTriIndex)mesh.indices[i];
+        }
+        shared.data = dGeomTriMeshDataCreate();
+        dGeomTriMeshDataBuildSimple(shared.data, (dReal*)shared.vertices,
+                                    mesh.vertexcount,
+                                    shared.indices, mesh.indexcount);
+        shared.references = 0;
+        it = sharedTriMeshes.insert(std::make_pair(mesh.vertices, shared)).first;
+      }
+      it->second.references++;
+      return it->second.data;
+    }
+
+    static void releaseSharedTriMesh(const mydVector3 *key) {
+      MutexLocker locker(&sharedTriMeshMutex);
+      std::map<const mydVector3*, SharedTriMesh>::iterator it;
+
+      it = sharedTriMeshes.find(key);
+      if(it == sharedTriMeshes.end()) return;
+      if(--it->second.references == 0) {
+        dGeomTriMeshDataDestroy(it->second.data);
+        free(it->second.vertices);
+        free(it->second.indices);
+        sharedTriMeshes.erase(it);
+      }
+    }
+
     /**
      * \brief Creates a empty node objekt.
      *
@@ -75,6 +134,7 @@ namespace mars {
       myVertices = 0;
       myIndices = 0;
       myTriMeshData = 0;
+      sharedMeshKey = 0;
       composite = false;
       //node_data.num_ground_collisions = 0;
       node_data.setZero();
@@ -97,6 +157,7 @@ namespace mars {
       std::vector<sensor_list_element>::iterator iter;
       MutexLocker locker(&(theWorld->iMutex));
 
+      theWorld->dequeueSensorRays(this);
       if(nBody) theWorld->destroyBody(nBody, this);
 
       if(nGeom) dGeomDestroy(nGeom);
@@ -105,16 +166,12 @@ namespace mars {
       if(myIndices) free(myIndices);
       if(height_data) free(height_data);
 
-      // TODO: how does this loop work? why doesn't it run forever?
-      for(iter = sensor_list.begin(); iter != sensor_list.end();) {
-        if((*iter).gd){
-          delete ((*iter).gd);
-          (*iter).gd = 0;
-        }
-        dGeomDestroy((*iter).geom);
-        sensor_list.erase(iter);
+      for(iter = sensor_list.begin(); iter != sensor_list.end(); ++iter) {
+        destroySensorRays(&(*iter));
       }
-      if(myTriMeshData) dGeomTriMeshDataDestroy(myTriMeshData);
+      sensor_list.clear();
+      if(sharedMeshKey) releaseSharedTriMesh(sharedMeshKey);
+      else if(myTriMeshData) dGeomTriMeshDataDestroy(myTriMeshData);
     }
 
     dReal heightfield_callback(void* pUserData, int x, int z ) {
@@ -198,6 +255,7 @@ namespace mars {
           else
             dGeomSetQuaternion(nGeom, tmp);
         }
+        if(!node->movable) theWorld->addStaticGeom(nGeom);
         node_data.id = node->index;
         dGeomSetData(nGeom, &node_data);
         locker.unlock();
@@ -616,25 +674,32 @@ namespace mars {
         return false;
       }
 
-      myVertices = (dVector3*)calloc(node->mesh.vertexcount, sizeof(dVector3));
-      myIndices = (dTriIndex*)calloc(node->mesh.indexcount, sizeof(dTriIndex));
-      //LOG_DEBUG("%d %d", node->mesh.vertexcount, node->mesh.indexcount);
-      // first we have to copy the mesh data to prevent errors in case
-      // of double to float conversion
-      for(i=0; i<node->mesh.vertexcount; i++) {
-        myVertices[i][0] = (dReal)node->mesh.vertices[i][0];
-        myVertices[i][1] = (dReal)node->mesh.vertices[i][1];
-        myVertices[i][2] = (dReal)node->mesh.vertices[i][2];
-      }
-      for(i=0; i<node->mesh.indexcount; i++) {
-        myIndices[i] = (dTriIndex)node->mesh.indices[i];
+      if(node->mesh.shared) {
+        // the worlds of a batch build the ODE data only once
+        myTriMeshData = acquireSharedTriMesh(node->mesh);
+        sharedMeshKey = node->mesh.vertices;
       }
+      else {
+        myVertices = (dVector3*)calloc(node->mesh.vertexcount, sizeof(dVector3));
+        myIndices = (dTriIndex*)calloc(node->mesh.indexcount, sizeof(dTriIndex));
+        //LOG_DEBUG("%d %d", node->mesh.vertexcount, node->mesh.indexcount);
+        // first we have to copy the mesh data to prevent errors in case
+        // of double to float conversion
+        for(i=0; i<node->mesh.vertexcount; i++) {
+          myVertices[i][0] = (dReal)node->mesh.vertices[i][0];
+          myVertices[i][1] = (dReal)node->mesh.vertices[i][1];
+          myVertices[i][2] = (dReal)node->mesh.vertices[i][2];
+        }
+        for(i=0; i<node->mesh.indexcount; i++) {
+          myIndices[i] = (dTriIndex)node->mesh.indices[i];
+        }
 
-      // then we can build the ode representation
-      myTriMeshData = dGeomTriMeshDataCreate();
-      dGeomTriMeshDataBuildSimple(myTriMeshData, (dReal*)myVertices,
-                                  node->mesh.vertexcount,
-                                  myIndices, node->mesh.indexcount);
+        // then we can build the ode representation
+        myTriMeshData = dGeomTriMeshDataCreate();
+        dGeomTriMeshDataBuildSimple(myTriMeshData, (dReal*)myVertices,
+                                    node->mesh.vertexcount,
+                                    myIndices, node->mesh.indexcount);
+      }
       nGeom = dCreateTriMesh(theWorld->getSpace(), myTriMeshData, 0, 0, 0);
 
       // at this moment we set the mass properties as the mass of the
@@ -1059,6 +1124,7 @@ namespace mars {
           dGeomSetQuaternion(nGeom, rotation);
           dGeomSetPosition(nGeom, (dReal)node->pos.x(),
                            (dReal)node->pos.y(), (dReal)node->pos.z());
+          theWorld->addStaticGeom(nGeom);
         }
         else {
           bool body_created = false;
@@ -1219,6 +1285,54 @@ namespace mars {
       if(nBody) dBodyAddTorque(nBody, (dReal)t.x(), (dReal)t.y(), (dReal)t.z());
     }
 
+    void NodePhysics::getState(NodeBodyState *state) const {
+      const dReal *tmp;
+      dQuaternion q;
+
+      if(nGeom) {
+        tmp = dGeomGetPosition(nGeom);
+        state->pos = Vector(tmp[0], tmp[1], tmp[2]);
+        dGeomGetQuaternion(nGeom, q);
+        state->rot = Quaternion(q[0], q[1], q[2], q[3]);
+      }
+      else {
+        state->pos = Vector(0, 0, 0);
+        state->rot = Quaternion(1, 0, 0, 0);
+      }
+      if(nBody) {
+        tmp = dBodyGetLinearVel(nBody);
+        state->linearVelocity = Vector(tmp[0], tmp[1], tmp[2]);
+        tmp = dBodyGetAngularVel(nBody);
+        state->angularVelocity = Vector(tmp[0], tmp[1], tmp[2]);
+        tmp = dBodyGetForce(nBody);
+        state->force = Vector(tmp[0], tmp[1], tmp[2]);
+        tmp = dBodyGetTorque(nBody);
+        state->torque = Vector(tmp[0], tmp[1], tmp[2]);
+      }
+      else {
+        state->linearVelocity = Vector(0, 0, 0);
+        state->angularVelocity = Vector(0, 0, 0);
+        state->force = Vector(0, 0, 0);
+        state->torque = Vector(0, 0, 0);
+      }
+      state->groundContact = getGroundContact();
+      state->groundContactForce = getGroundContactForce();
+    }
+
+    void NodePhysics::setVelocities(const NodeVelocityCommand &command) {
+      if(!nBody) return;
+      if(command.setLinear) {
+        dBodySetLinearVel(nBody, (dReal)command.linearVelocity.x(),
+                          (dReal)command.linearVelocity.y(),
+                          (dReal)command.linearVelocity.z());
+      }
+      if(command.setAngular) {
+        dBodySetAngularVel(nBody, (dReal)command.angularVelocity.x(),
+                           (dReal)command.angularVelocity.y(),
+                           (dReal)command.angularVelocity.z());
+      }
+    }
+
     bool NodePhysics::getGroundContact(void) const {
       if(nGeom) {
         return node_data.num_ground_collisions;
@@ -1365,64 +1479,40 @@ namespace mars {
      */
     void NodePhysics::addSensor(BaseSensor* sensor) {
       MutexLocker locker(&(theWorld->iMutex));
-      int i;
-      geom_data* gd;
       sensor_list_element sle;
-      const dReal *pos = dGeomGetPosition(nGeom);
-      const dReal *rot = dGeomGetRotation(nGeom);
-      Vector direction;
-      dVector3 dest, tmp;
+      Vector direction, offset(0.0, 0.0, 0.0);
       //sReal rad_angle, rad_steps, rad_start;
       double rad_steps, rad_start;
+      int i;
 
+      sle.sensor = sensor;
+      sle.rotating = 0;
+      sle.updateTime = 0.0;
+      sle.queryBegin = sle.queryCount = 0;
 
       BasePolarIntersectionSensor *polarSensor;
       polarSensor = dynamic_cast<BasePolarIntersectionSensor*>(sensor);
-  
+      BaseGridIntersectionSensor *polarGridSensor;
+      polarGridSensor = dynamic_cast<BaseGridIntersectionSensor*>(sensor);
+
       //case SENSOR_TYPE_RAY:
       if(polarSensor){
-        sle.sensor = sensor;
-        sle.updateTime = 0.0;
-        //sensor.count_data = sensor.resolution;
-        //sensor.data = (sReal*)malloc(sensor.resolution * sizeof(sReal));
-   
-        mars::sim::RotatingRaySensor* rotRaySensor = dynamic_cast<RotatingRaySensor*>(sensor);
-        if(rotRaySensor){
-            int N = rotRaySensor->getNumberRays();
-            std::vector<utils::Vector>& directions = rotRaySensor->getDirections();
+        sle.values = polarSensor;
+        sle.maxDistance = polarSensor->maxDistance;
+        sle.rotating = dynamic_cast<RotatingRaySensor*>(sensor);
+        if(sle.rotating){
+            sle.type = RAY_SENSOR_ROTATING;
+            int N = sle.rotating->getNumberRays();
+            std::vector<utils::Vector>& directions = sle.rotating->getDirections();
             assert(N == directions.size());
-            
+
             // Requests and adds the single rays using the local sensor frame.
+            // Use the precalculated ray directions of the sensor.
             for(i=0; i<N; i++){
-                gd = new geom_data;
-                (*gd).setZero();
-                gd->sense_contact_force = 0;
-                (*polarSensor)[i] = gd->value = polarSensor->maxDistance;//sensor.max_distance;
-                gd->ray_sensor = 1;
-                gd->parent_geom = nGeom;
-                gd->parent_body = nBody;
-                sle.geom = dCreateRay(NULL, polarSensor->maxDistance);
-                dGeomSetCollideBits(sle.geom, 32768);
-                dGeomSetCategoryBits(sle.geom, 32768);
-                
-                // Use the precalculated ray directions of the sensor. 
-                direction = /*polarSensor->getOrientation() **/ directions[i];
-                sle.ray_direction = direction;
-                tmp[0] = direction.x();
-                tmp[1] = direction.y();
-                tmp[2] = direction.z();
-                dMULTIPLY0_331(dest, rot, tmp);
-                dGeomRaySet(sle.geom, pos[0], pos[1], pos[2], dest[0], dest[1], dest[2]);
-                sle.gd = gd;
-                sle.index = i;
-                sensor_list.push_back(sle);
-                dGeomSetData(sle.geom, gd);
-                //dGeomRaySetParams(sle.geom, 1, 1);
-                dGeomSetCollideBits(sle.geom, COLLIDE_MASK_SENSOR);
-                dGeomSetCategoryBits(sle.geom, COLLIDE_MASK_SENSOR);
-                dGeomDisable(sle.geom);
+                addSensorRay(&sle, directions[i], offset);
             }
         } else {
+            sle.type = RAY_SENSOR_POLAR;
             //rad_angle = polarSensor->widthX*; //M_PI*sensor.flare_angle/180;
             rad_steps = polarSensor->getCols(); //rad_angle/(sReal)(sensor.resolution-1);
             rad_start = -((rad_steps-1)/2.0)*polarSensor->stepX; //Starting to Left, because 0 is in front and rock convention posive CCW //(M_PI-rad_angle)/2;
@@ -1430,124 +1520,90 @@ namespace mars {
               rad_start = 0;
             }
             for(i=0; i<rad_steps; i++) {
-              gd = new geom_data;
-              (*gd).setZero();
-              gd->sense_contact_force = 0;
-              (*polarSensor)[i] = gd->value = polarSensor->maxDistance;//sensor.max_distance;
-
-              gd->ray_sensor = 1;
-              gd->parent_geom = nGeom;
-              gd->parent_body = nBody;
-              sle.geom = dCreateRay(NULL, polarSensor->maxDistance);
-              dGeomSetCollideBits(sle.geom, 32768);
-              dGeomSetCategoryBits(sle.geom, 32768);
               direction = Vector(cos(rad_start+i*polarSensor->stepX),
                                  sin(rad_start+i*polarSensor->stepX), 0);
-              //direction = QVRotate(sensor.rotation, direction);
-              direction = (polarSensor->getOrientation() * direction);
-              sle.ray_direction = direction;
-              tmp[0] = direction.x();
-              tmp[1] = direction.y();
-              tmp[2] = direction.z();
-              dMULTIPLY0_331(dest, rot, tmp);
-              dGeomRaySet(sle.geom, pos[0], pos[1], pos[2], dest[0], dest[1], dest[2]);
-              sle.gd = gd;
-              sle.index = i;
-              sensor_list.push_back(sle);
-              dGeomSetData(sle.geom, gd);
-              //dGeomRaySetParams(sle.geom, 1, 1);
-              dGeomSetCollideBits(sle.geom, COLLIDE_MASK_SENSOR);
-              dGeomSetCategoryBits(sle.geom, COLLIDE_MASK_SENSOR);
-              dGeomDisable(sle.geom);
+              addSensorRay(&sle, polarSensor->getOrientation() * direction,
+                           offset);
             }
         }
       }
-  
-      BaseGridIntersectionSensor *polarGridSensor;
-      polarGridSensor = dynamic_cast<BaseGridIntersectionSensor*>(sensor);
-
-      if(polarGridSensor){
-        sle.sensor = sensor;
-        sle.updateTime = 0.0;
-        int cols, rows;
-        dVector3 dir={0,0,0,0}, xStep={0,0,0,0}, 
-            yStep={0,0,0,0}, xOffset={0,0,0,0}, yOffset={0,0,0,0};
+      else if(polarGridSensor){
+        sle.type = RAY_SENSOR_GRID;
+        sle.values = polarGridSensor;
+        sle.maxDistance = polarGridSensor->maxDistance;
+        int cols, rows, x, y;
+        // the rays of the grid are not spread yet, they all start at the node
+        Vector xStep(0.0, 0.0, 0.0), yStep(0.0, 0.0, 0.0);
 
         cols = polarGridSensor->getCols();
         rows = polarGridSensor->getRows();
-    
-        tmp[0] = 0;
-        tmp[1] = 0;
-        tmp[2] = -1;
-        dMULTIPLY0_331(dir, rot, tmp);
-        tmp[0] = polarGridSensor->stepX;
-        tmp[1] = 0;
-        tmp[2] = 0;
-        //dMULTIPLY0_331(xStep, rot, tmp);
-        tmp[0] = 0;
-        tmp[1] = polarGridSensor->stepY;
-        tmp[2] = 0;
-        //dMULTIPLY0_331(yStep, rot, tmp);
-
-
-        for(int x=0; x<cols; x++) {
-          for(int y=0; y<rows; y++) {
-            gd = new geom_data;
-            (*gd).setZero();
-            gd->sense_contact_force = 0;
-            (*polarGridSensor)[y*cols+x] = gd->value = polarGridSensor->maxDistance;
-      
-            gd->ray_sensor = 1;
-            gd->parent_geom = nGeom;
-            sle.geom = dCreateRay(theWorld->getSpace(),
-                                  polarGridSensor->maxDistance);
-            dGeomSetCollideBits(sle.geom, 32768);
-            dGeomSetCategoryBits(sle.geom, 32768);
-        
-            direction = (polarGridSensor->getOrientation() *
-                         Vector(0.0, 0.0, -1.0));
-            sle.ray_direction = direction;
-            tmp[0] = direction.x();
-            tmp[1] = direction.y();
-            tmp[2] = direction.z();
-            dMULTIPLY0_331(dest, rot, tmp);
-            xOffset[0] =  -cols*0.5*xStep[0] + x*xStep[0];
-            xOffset[1] =  -cols*0.5*xStep[1] + x*xStep[1];
-            xOffset[2] =  -cols*0.5*xStep[2] + x*xStep[2];
-
-            yOffset[0] =  -rows*0.5*yStep[0] + y*yStep[0];
-            yOffset[1] =  -rows*0.5*yStep[1] + y*yStep[1];
-            yOffset[2] =  -rows*0.5*yStep[2] + y*yStep[2];
-        
-            sle.ray_pos_offset.x() = xOffset[0] + yOffset[0];
-            sle.ray_pos_offset.y() = xOffset[1] + yOffset[1];
-            sle.ray_pos_offset.z() = xOffset[2] + yOffset[2];
-
-            dGeomRaySet(sle.geom, pos[0] + xOffset[0] + yOffset[0],
-                        pos[1] + xOffset[1] + yOffset[1],
-                        pos[2]  + xOffset[2] + yOffset[2],
-                        dest[0], dest[1], dest[2]);
-            sle.gd = gd;
-            sle.index = y*cols+x;
-            sensor_list.push_back(sle);      
-            dGeomSetData(sle.geom, gd);
-            //dGeomRaySetParams(sle.geom, 1, 1);      
-            dGeomSetCollideBits(sle.geom, COLLIDE_MASK_SENSOR);
-            dGeomSetCategoryBits(sle.geom, COLLIDE_MASK_SENSOR);
-            dGeomDisable(sle.geom);
-        
-          }
+        direction = (polarGridSensor->getOrientation() *
+                     Vector(0.0, 0.0, -1.0));
+
+        for(i=0; i<cols*rows; i++) {
+          x = i % cols;
+          y = i / cols;
+          offset = (x - cols*0.5)*xStep + (y - rows*0.5)*yStep;
+          addSensorRay(&sle, direction, offset);
         }
       }
+      else {
+        return;
+      }
+      sensor_list.push_back(sle);
+    }
+
+    /**
+     * \brief Creates the ray geom for the next value of a sensor.
+     *
+     * \param direction The direction of the ray in the node frame.
+     * \param offset The start of the ray in the node frame.
+     */
+    void NodePhysics::addSensorRay(sensor_list_element *sle,
+                                   const Vector &direction,
+                                   const Vector &offset) {
+      geom_data *gd = new geom_data;
+      gd->sense_contact_force = 0;
+      gd->value = sle->maxDistance;
+      gd->ray_sensor = 1;
+      gd->parent_geom = nGeom;
+      gd->parent_body = nBody;
+
+      dGeomID geom = dCreateRay(NULL, sle->maxDistance);
+      dGeomSetData(geom, gd);
+      dGeomSetCollideBits(geom, COLLIDE_MASK_SENSOR);
+      dGeomSetCategoryBits(geom, COLLIDE_MASK_SENSOR);
+      dGeomDisable(geom);
+
+      (*sle->values)[sle->geoms.size()] = sle->maxDistance;
+      sle->geoms.push_back(geom);
+      sle->gds.push_back(gd);
+      sle->dirX.push_back(direction.x());
+      sle->dirY.push_back(direction.y());
+      sle->dirZ.push_back(direction.z());
+      if(sle->type == RAY_SENSOR_GRID) {
+        sle->offsetX.push_back(offset.x());
+        sle->offsetY.push_back(offset.y());
+        sle->offsetZ.push_back(offset.z());
+      }
+    }
+
+    void NodePhysics::destroySensorRays(sensor_list_element *sle) {
+      for(size_t i=0; i<sle->geoms.size(); ++i) {
+        delete sle->gds[i];
+        dGeomDestroy(sle->geoms[i]);
+      }
+      sle->geoms.clear();
+      sle->gds.clear();
     }
 
     void NodePhysics::removeSensor(BaseSensor *sensor) {
       MutexLocker locker(&(theWorld->iMutex));
       std::vector<sensor_list_element>::iterator iter;
+      theWorld->dequeueSensorRays(this);
       for (iter = sensor_list.begin(); iter != sensor_list.end(); ) {
         if (iter->sensor == sensor) {
-          free(iter->gd);
-          dGeomDestroy(iter->geom);
+          destroySensorRays(&(*iter));
           iter = sensor_list.erase(iter);
         } else
           ++iter;
@@ -1568,118 +1624,80 @@ namespace mars {
       std::vector<sensor_list_element>::iterator iter;
       const dReal* pos = dGeomGetPosition(nGeom);
       const dReal* rot = dGeomGetRotation(nGeom);
-      dVector3 dest, tmp, posOffset;
-      dReal steps_size = 1.0, length = 0.0;
-      bool done = false;
-      int steps = 0;
       dReal worldStep = theWorld->getWorldStep();
-      // RotatingRaySensor
-      utils::Vector tmpV;
+      dMatrix3 R, turnR;
+      dQuaternion turnQ;
       utils::Quaternion turnrotation;
-      turnrotation.setIdentity();
-      std::set<unsigned long> ids_rotating_ray_sensors;
+      RayQuery *queries;
+      size_t i, n;
 
-      //New Code
-      int i=0;
+      // collect the rays of all sensors that have to be updated in this step
+      theWorld->dequeueSensorRays(this);
+      ray_queries.clear();
       for(iter = sensor_list.begin(); iter != sensor_list.end(); iter++) {
-        i+=1;
+        iter->queryCount = 0;
         if((double)iter->sensor->updateRate * 0.001 > worldStep) {
           iter->updateTime += worldStep;
           if(iter->updateTime < 0.001*iter->sensor->updateRate) continue;
           iter->updateTime -= 0.001*iter->sensor->updateRate;
         }
-        BasePolarIntersectionSensor *polarSensor = dynamic_cast<BasePolarIntersectionSensor*>((*iter).sensor);
-        if(polarSensor){
-          sensor_list_element elem = *iter;
-
-          tmpV[0] = elem.ray_direction.x();
-          tmpV[1] = elem.ray_direction.y();
-          tmpV[2] = elem.ray_direction.z();
-          
+        n = iter->geoms.size();
+        if(n == 0) continue;
+
+        if(iter->type == RAY_SENSOR_ROTATING) {
           // Applies orientation_offset (z-Rotation) to the laser rays.
-          mars::sim::RotatingRaySensor *rotRaySensor = dynamic_cast<RotatingRaySensor*>((*iter).sensor);
-          if(rotRaySensor){
-              std::set<unsigned long>::iterator it = ids_rotating_ray_sensors.find(rotRaySensor->id);
-              // Takes care that each rotating ray sensor is only turned once (sensor_list contains each ray independently).
-              if(it == ids_rotating_ray_sensors.end()) {
-                  //turnrotation.setIdentity(); // If we set it to identity first, receiveSensorData will not be called anymore.. wtf!?
-                  turnrotation = rotRaySensor->turn();
-                  ids_rotating_ray_sensors.insert(rotRaySensor->id);
-              }
-              //fprintf(stderr, "tmp[%i]: %f, %f, %f\n", i, tmpV.x(), tmpV.y(), tmpV.z());
-              tmpV = turnrotation * tmpV;
-              //fprintf(stderr, "tmp[%i]: %f, %f, %f\n", i, tmpV.x(), tmpV.y(), tmpV.z());
-          }
-          tmp[0] = tmpV.x();//elem.ray_direction.x();
-          tmp[1] = tmpV.y();//elem.ray_direction.y();
-          tmp[2] = tmpV.z();//elem.ray_direction.z();
-          dMULTIPLY0_331(dest, rot, tmp);
-
-          if(physics_thread) {
-            steps = 0;
-            length = 0.0;
-            done = false;
-            dGeomEnable(elem.geom);
-            // make here the collision check
-            while (!done) {
-              dGeomRaySet(elem.geom,
-                          pos[0] + dest[0]*steps_size*steps,
-                          pos[1] + dest[1]*steps_size*steps,
-                          pos[2] + dest[2]*steps_size*steps,
-                          dest[0], dest[1], dest[2]);
-              if(length + steps_size < polarSensor->maxDistance) {
-                steps++;
-                dGeomRaySetLength(elem.geom, steps_size);
-              }
-              else {
-                dGeomRaySetLength(elem.geom, polarSensor->maxDistance- length);
-                done = true;
-              }
-              if(theWorld->handleCollision(elem.geom)) {
-                elem.gd->value += length;
-                done = true;
-              }
-              if(!done) length = steps_size*steps;
-            }
-            dGeomDisable(elem.geom);
-          }
-          (*polarSensor)[elem.index] = elem.gd->value;
-          elem.gd->value = polarSensor->maxDistance;
+          turnrotation = iter->rotating->turn();
+          turnQ[0] = turnrotation.w();
+          turnQ[1] = turnrotation.x();
+          turnQ[2] = turnrotation.y();
+          turnQ[3] = turnrotation.z();
+          dQtoR(turnQ, turnR);
+          dMULTIPLY0_333(R, rot, turnR);
+        }
+        else {
+          memcpy(R, rot, sizeof(dMatrix3));
+        }
+
+        iter->queryBegin = ray_queries.size();
+        iter->queryCount = n;
+        ray_queries.resize(iter->queryBegin + n);
+        queries = &ray_queries[iter->queryBegin];
+        if(ray_x.size() < n) {
+          ray_x.resize(n);
+          ray_y.resize(n);
+          ray_z.resize(n);
         }
-    
-        BaseGridIntersectionSensor *polarGridSensor;
-        polarGridSensor = dynamic_cast<BaseGridIntersectionSensor*>(iter->sensor);
-
-        if(polarGridSensor) {
-          sensor_list_element elem = *iter;
-
-          if(physics_thread) {
-        
-            tmp[0] = elem.ray_direction.x();
-            tmp[1] = elem.ray_direction.y();
-            tmp[2] = elem.ray_direction.z();
-            dMULTIPLY0_331(dest, rot, tmp);
-
-            tmp[0] = elem.ray_pos_offset.x();
-            tmp[1] = elem.ray_pos_offset.y();
-            tmp[2] = elem.ray_pos_offset.z();
-            dMULTIPLY0_331(posOffset, rot, tmp);
-
-            dGeomEnable(elem.geom);
-
-            dGeomRaySet(elem.geom, pos[0] + posOffset[0],
-                        pos[1] + posOffset[1],
-                        pos[2] + posOffset[2],
-                        dest[0], dest[1], dest[2]);
-
-            dGeomRaySetLength(elem.geom, polarGridSensor->maxDistance);
-            theWorld->handleCollision(elem.geom);
-            dGeomDisable(elem.geom);        
+        rotateRays(R, &iter->dirX[0], &iter->dirY[0], &iter->dirZ[0],
+                   &ray_x[0], &ray_y[0], &ray_z[0], n);
+        for(i=0; i<n; ++i) {
+          queries[i].geom = iter->geoms[i];
+          queries[i].direction[0] = ray_x[i];
+          queries[i].direction[1] = ray_y[i];
+          queries[i].direction[2] = ray_z[i];
+          queries[i].start[0] = pos[0];
+          queries[i].start[1] = pos[1];
+          queries[i].start[2] = pos[2];
+          queries[i].maxDistance = iter->maxDistance;
+          queries[i].result = &(*iter->values)[i];
+        }
+        if(iter->type == RAY_SENSOR_GRID) {
+          rotateRays(R, &iter->offsetX[0], &iter->offsetY[0],
+                     &iter->offsetZ[0], &ray_x[0], &ray_y[0], &ray_z[0], n);
+          for(i=0; i<n; ++i) {
+            queries[i].start[0] += ray_x[i];
+            queries[i].start[1] += ray_y[i];
+            queries[i].start[2] += ray_z[i];
           }
-          (*polarGridSensor)[elem.index] = elem.gd->value;
-          elem.gd->value = polarGridSensor->maxDistance;      
         }
-      } // end for loop.
+      }
+
+      // the rays are cast by the world after all nodes are updated
+      for(iter = sensor_list.begin(); iter != sensor_list.end(); iter++) {
+        if(iter->queryCount == 0) continue;
+        theWorld->queueSensorRays(this, iter->sensor,
+                                  &ray_queries[iter->queryBegin],
+                                  iter->queryCount);
+      }
     }
 
     /**
@@ -1691,19 +1709,22 @@ namespace mars {
      */
     void NodePhysics::destroyNode(void) {
       MutexLocker locker(&(theWorld->iMutex));
+      theWorld->dequeueSensorRays(this);
       if(nBody) theWorld->destroyBody(nBody, this);
 
       if(nGeom) dGeomDestroy(nGeom);
 
       if(myVertices) free(myVertices);
       if(myIndices) free(myIndices);
-      if(myTriMeshData) dGeomTriMeshDataDestroy(myTriMeshData);
+      if(sharedMeshKey) releaseSharedTriMesh(sharedMeshKey);
+      else if(myTriMeshData) dGeomTriMeshDataDestroy(myTriMeshData);
 
       nBody = 0;
       nGeom = 0;
       myVertices = 0;
       myIndices = 0;
       myTriMeshData = 0;
+      sharedMeshKey = 0;
       composite = false;
       //node_data.num_ground_collisions = 0;
       node_data.setZero();
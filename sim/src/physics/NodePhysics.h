@@ -74,14 +74,32 @@ namespace mars {
       dBodyID parent_body;
     };
 
+    class RotatingRaySensor;
+
+    enum RaySensorType {
+      RAY_SENSOR_POLAR,
+      RAY_SENSOR_ROTATING,
+      RAY_SENSOR_GRID,
+    };
+
+    /**
+     * The rays of one sensor. The type of the sensor is resolved once when
+     * the sensor is added. The ray directions and start offsets in the node
+     * frame are stored per component, ray i writes to value i of the
+     * sensor.
+     */
     struct sensor_list_element {
       interfaces::BaseSensor *sensor;
-      geom_data *gd;
-      dGeomID geom;
-      utils::Vector ray_direction;
-      utils::Vector ray_pos_offset;
-      unsigned int index;
+      RaySensorType type;
+      interfaces::BaseArraySensor<double> *values;
+      RotatingRaySensor *rotating;
+      dReal maxDistance;
       dReal updateTime;
+      std::vector<dGeomID> geoms;
+      std::vector<geom_data*> gds;
+      std::vector<dReal> dirX, dirY, dirZ;
+      std::vector<dReal> offsetX, offsetY, offsetZ; ///< only used by grid sensors
+      size_t queryBegin, queryCount;
     };
 
     /**
@@ -134,6 +152,16 @@ namespace mars {
       void getAbsMass(dMass *pMass) const;
       dReal heightCallback(int x, int y);
 
+      /**
+       * \brief Reads position, rotation, velocities, force and torque.
+       * Has to be called with a locked theWorld->iMutex.
+       */
+      void getState(interfaces::NodeBodyState *state) const;
+      /**
+       * \brief Has to be called with a locked theWorld->iMutex.
+       */
+      void setVelocities(const interfaces::NodeVelocityCommand &command);
+
     protected:
       WorldPhysics *theWorld;
       dBodyID nBody;
@@ -142,11 +170,14 @@ namespace mars {
       dVector3 *myVertices;
       dTriIndex *myIndices;
       dTriMeshDataID myTriMeshData;
+      const interfaces::mydVector3 *sharedMeshKey; ///< set if myTriMeshData is shared
       bool composite;
       geom_data node_data;
       interfaces::terrainStruct *terrain;
       dReal *height_data;
       std::vector<sensor_list_element> sensor_list;
+      std::vector<RayQuery> ray_queries;
+      std::vector<dReal> ray_x, ray_y, ray_z; ///< rotated ray vectors of one sensor
       bool createMesh(interfaces::NodeData *node);
       bool createBox(interfaces::NodeData *node);
       bool createSphere(interfaces::NodeData *node);
@@ -156,6 +187,9 @@ namespace mars {
       bool createHeightfield(interfaces::NodeData *node);
       void setProperties(interfaces::NodeData *node);
       void setInertiaMass(interfaces::NodeData *node);
+      void addSensorRay(sensor_list_element *sle, const utils::Vector &direction,
+                        const utils::Vector &offset);
+      void destroySensorRays(sensor_list_element *sle);
     };
 
   } // end of namespace sim
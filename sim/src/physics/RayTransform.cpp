@@ -0,0 +1,94 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RayTransform.h"
+
+// the vector kernels are written for double precision
+#if defined(dDOUBLE) && defined(__AVX__)
+  #include <immintrin.h>
+  #define RAY_TRANSFORM_AVX
+#elif defined(dDOUBLE) && defined(__SSE2__)
+  #include <emmintrin.h>
+  #define RAY_TRANSFORM_SSE2
+#endif
+
+namespace mars {
+  namespace sim {
+
+    void rotateRays(const dMatrix3 R, const dReal *x, const dReal *y,
+                    const dReal *z, dReal *outX, dReal *outY, dReal *outZ,
+                    size_t n) {
+      size_t i = 0;
+
+#if defined(RAY_TRANSFORM_AVX)
+      const __m256d r0 = _mm256_set1_pd(R[0]), r1 = _mm256_set1_pd(R[1]);
+      const __m256d r2 = _mm256_set1_pd(R[2]), r4 = _mm256_set1_pd(R[4]);
+      const __m256d r5 = _mm256_set1_pd(R[5]), r6 = _mm256_set1_pd(R[6]);
+      const __m256d r8 = _mm256_set1_pd(R[8]), r9 = _mm256_set1_pd(R[9]);
+      const __m256d r10 = _mm256_set1_pd(R[10]);
+      __m256d vx, vy, vz;
+
+      for(; i+4<=n; i+=4) {
+        vx = _mm256_loadu_pd(x+i);
+        vy = _mm256_loadu_pd(y+i);
+        vz = _mm256_loadu_pd(z+i);
+        _mm256_storeu_pd(outX+i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r0, vx),
+                                                             _mm256_mul_pd(r1, vy)),
+                                               _mm256_mul_pd(r2, vz)));
+        _mm256_storeu_pd(outY+i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r4, vx),
+                                                             _mm256_mul_pd(r5, vy)),
+                                               _mm256_mul_pd(r6, vz)));
+        _mm256_storeu_pd(outZ+i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r8, vx),
+                                                             _mm256_mul_pd(r9, vy)),
+                                               _mm256_mul_pd(r10, vz)));
+      }
+#elif defined(RAY_TRANSFORM_SSE2)
+      const __m128d r0 = _mm_set1_pd(R[0]), r1 = _mm_set1_pd(R[1]);
+      const __m128d r2 = _mm_set1_pd(R[2]), r4 = _mm_set1_pd(R[4]);
+      const __m128d r5 = _mm_set1_pd(R[5]), r6 = _mm_set1_pd(R[6]);
+      const __m128d r8 = _mm_set1_pd(R[8]), r9 = _mm_set1_pd(R[9]);
+      const __m128d r10 = _mm_set1_pd(R[10]);
+      __m128d vx, vy, vz;
+
+      for(; i+2<=n; i+=2) {
+        vx = _mm_loadu_pd(x+i);
+        vy = _mm_loadu_pd(y+i);
+        vz = _mm_loadu_pd(z+i);
+        _mm_storeu_pd(outX+i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(r0, vx),
+                                                    _mm_mul_pd(r1, vy)),
+                                         _mm_mul_pd(r2, vz)));
+        _mm_storeu_pd(outY+i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(r4, vx),
+                                                    _mm_mul_pd(r5, vy)),
+                                         _mm_mul_pd(r6, vz)));
+        _mm_storeu_pd(outZ+i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(r8, vx),
+                                                    _mm_mul_pd(r9, vy)),
+                                         _mm_mul_pd(r10, vz)));
+      }
+#endif
+      // the remaining vectors or all without vector instructions
+      for(; i<n; ++i) {
+        outX[i] = R[0]*x[i] + R[1]*y[i] + R[2]*z[i];
+        outY[i] = R[4]*x[i] + R[5]*y[i] + R[6]*z[i];
+        outZ[i] = R[8]*x[i] + R[9]*y[i] + R[10]*z[i];
+      }
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
@@ -0,0 +1,55 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file RayTransform.h
+ * \brief Rotates packed arrays of sensor ray vectors.
+ *
+ */
+
+#ifndef RAY_TRANSFORM_H
+#define RAY_TRANSFORM_H
+
+#ifdef _PRINT_HEADER_
+  #warning "RayTransform.h"
+#endif
+
+#include <ode/ode.h>
+#include <cstddef>
+
+namespace mars {
+  namespace sim {
+
+    /**
+     * \brief Multiplies the rotation \a R with \a n vectors.
+     *
+     * The components of the vectors are given in separate arrays. The
+     * kernel uses AVX or SSE2 if the compiler enables them and falls back
+     * to scalar code otherwise. The output arrays must not overlap the
+     * input arrays.
+     */
+    void rotateRays(const dMatrix3 R, const dReal *x, const dReal *y,
+                    const dReal *z, dReal *outX, dReal *outY, dReal *outZ,
+                    size_t n);
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif  // RAY_TRANSFORM_H
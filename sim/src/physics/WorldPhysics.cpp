@@ -38,6 +38,7 @@
 
 #include "WorldPhysics.h"
 #include "NodePhysics.h"
+#include "JointPhysics.h"
 
 
 #include <mars/utils/MutexLocker.h>
@@ -45,6 +46,18 @@
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/Logging.hpp>
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/interfaces/sensor_bases.h>
+#include <mars/utils/misc.h>
+
+#include <map>
+#include <algorithm>
+
+// number of contact feedbacks allocated at once
+#define FEEDBACK_BLOCK_SIZE 256
+#define RAY_BATCH_SIZE 256
+#define RAY_TREE_LEAF_SIZE 4
+#define RAY_TREE_STACK_SIZE 64
 
 namespace mars {
   namespace sim {
@@ -95,11 +108,32 @@ namespace mars {
       ground_erp = 0.1;
       world = 0;
       space = 0;
+      static_space = 0;
       contactgroup = 0;
       world_init = 0;
       num_contacts = 0;
       create_contacts = 1;
       log_contacts = 0;
+      parallel_islands = false;
+      num_island_threads = 4;
+      num_ray_threads = 1;
+      num_ray_target_locks = 0;
+      dbRayId = 0;
+#ifdef ODE_HAS_THREADING
+      threading = 0;
+      thread_pool = 0;
+#endif
+      num_step_threads = 0;
+      static_space_type = SPACE_NONE;
+      dynamic_space_type = SPACE_HASH;
+      space_center = Vector(0.0, 0.0, 0.0);
+      space_extents = Vector(100.0, 100.0, 100.0);
+      space_depth = 6;
+      // the defaults of ode
+      hash_min_level = -3;
+      hash_max_level = 10;
+      num_feedbacks = peak_feedbacks = 0;
+      num_contact_joints = peak_contact_joints = 0;
 
       // the step size in seconds
       step_size = 0.01;
@@ -116,6 +150,19 @@ namespace mars {
       dSetErrorHandler (myErrorFunction);
       dSetDebugHandler (myDebugFunction);
       dSetMessageHandler (myMessageFunction);
+
+      dbContactPackage.add("contacts", 0l);
+      dbContactPackage.add("peakContacts", 0l);
+      dbContactPackage.add("feedbacks", 0l);
+      dbContactPackage.add("peakFeedbacks", 0l);
+      dbContactPackage.add("allocatedFeedbacks", 0l);
+      dbContactPackage.add("contactBuffer", 0l);
+      dbContactId = 0;
+      if(control->dataBroker) {
+        dbContactId = control->dataBroker->pushData("mars_sim", "contactMemory",
+                                                    dbContactPackage, NULL,
+                                                    data_broker::DATA_PACKAGE_READ_FLAG);
+      }
     }
 
     /**
@@ -133,6 +180,14 @@ namespace mars {
       freeTheWorld();
       // and close the ODE ...
       MutexLocker locker(&iMutex);
+      for(size_t i=0; i<feedback_blocks.size(); ++i) {
+        delete[] feedback_blocks[i];
+      }
+      feedback_blocks.clear();
+      for(size_t i=0; i<ray_target_locks.size(); ++i) {
+        delete ray_target_locks[i];
+      }
+      ray_target_locks.clear();
       dCloseODE();
     }
 
@@ -154,7 +209,10 @@ namespace mars {
       if (!world_init) {
         //LOG_DEBUG("init physics world");
         world = dWorldCreate();
-        space = dHashSpaceCreate(0);
+        space = createSpace(dynamic_space_type);
+        if(static_space_type != SPACE_NONE) {
+          static_space = createSpace(static_space_type);
+        }
         contactgroup = dJointGroupCreate(0);
 
         old_gravity = world_gravity;
@@ -190,7 +248,18 @@ namespace mars {
       MutexLocker locker(&iMutex);
       if(world_init) {
         //LOG_DEBUG("free physics world");
+        freeStepThreading();
+        islands.clear();
+        ray_batches.clear();
+        ray_targets.clear();
+        ray_unbounded_targets.clear();
+        ray_tree.clear();
+        num_feedbacks = num_contact_joints = 0;
         dJointGroupDestroy(contactgroup);
+        if(static_space) {
+          dSpaceDestroy(static_space);
+          static_space = 0;
+        }
         dSpaceDestroy(space);
         dWorldDestroy(world);
         world_init = 0;
@@ -198,6 +267,48 @@ namespace mars {
       // else debug something
     }
 
+    /**
+     * \brief Creates a top level space with the given broadphase layout.
+     */
+    dSpaceID WorldPhysics::createSpace(SpaceType type) {
+      dVector3 center, extents;
+      dSpaceID newSpace;
+
+      switch(type) {
+      case SPACE_SIMPLE:
+        return dSimpleSpaceCreate(0);
+      case SPACE_QUADTREE:
+        center[0] = space_center.x();
+        center[1] = space_center.y();
+        center[2] = space_center.z();
+        extents[0] = space_extents.x();
+        extents[1] = space_extents.y();
+        extents[2] = space_extents.z();
+        return dQuadTreeSpaceCreate(0, center, extents, space_depth);
+      case SPACE_SAP:
+        return dSweepAndPruneSpaceCreate(0, dSAP_AXES_XYZ);
+      default:
+        newSpace = dHashSpaceCreate(0);
+        dHashSpaceSetLevels(newSpace, hash_min_level, hash_max_level);
+        return newSpace;
+      }
+    }
+
+    /**
+     * \brief Moves a geom without body into the static space.
+     *
+     * The static space is built once and only collided against the
+     * dynamic space, thus the static geoms are not hashed every step.
+     * Has to be called with a locked iMutex.
+     */
+    void WorldPhysics::addStaticGeom(dGeomID theGeom) {
+      if(static_space && !dGeomGetBody(theGeom) &&
+         dGeomGetSpace(theGeom) == space) {
+        dSpaceRemove(space, theGeom);
+        dSpaceAdd(static_space, theGeom);
+      }
+    }
+
     /**
      * \brief Returns if a world exists.
      *
@@ -225,12 +336,15 @@ namespace mars {
      */
     void WorldPhysics::stepTheWorld(void) {
       MutexLocker locker(&iMutex);
-      std::vector<dJointFeedback*>::iterator iter;
       geom_data* data;
       int i;
 
       // if world_init = false or step_size <= 0 debug something
       if(world_init && step_size > 0) {
+#ifdef ODE11
+        // worlds of a BatchSimulator are stepped by different threads
+        dAllocateODEDataForThread(dAllocateMaskAll);
+#endif
         if(old_gravity != world_gravity) {
           old_gravity = world_gravity;
           dWorldSetGravity(world, world_gravity.x(),
@@ -255,11 +369,18 @@ namespace mars {
           data->contact_points.clear();
           data->ground_feedbacks.clear();
         }
-        for(iter = contact_feedback_list.begin();
-            iter != contact_feedback_list.end(); iter++) {
-          free((*iter));
+        if(static_space) {
+          for(i=0; i<dSpaceGetNumGeoms(static_space); i++) {
+            data = (geom_data*)dGeomGetData(dSpaceGetGeom(static_space, i));
+            data->num_ground_collisions = 0;
+            data->contact_ids.clear();
+            data->contact_points.clear();
+            data->ground_feedbacks.clear();
+          }
         }
-        contact_feedback_list.clear();
+        /// the feedbacks of the last step are not referenced anymore
+        num_feedbacks = 0;
+        num_contact_joints = 0;
         draw_intern.clear();
         /// then we have to clear the contacts
         dJointGroupEmpty(contactgroup);
@@ -267,11 +388,27 @@ namespace mars {
         num_contacts = log_contacts = 0;
         create_contacts = 1;
         dSpaceCollide(space,this, &WorldPhysics::callbackForward);
+        // the static geoms are never collided among each other
+        if(static_space) {
+          dSpaceCollide2((dGeomID)space, (dGeomID)static_space, this,
+                         &WorldPhysics::callbackForward);
+        }
         
         drawLock.lock();
         draw_extern.swap(draw_intern);
         drawLock.unlock();
 
+        /// the contact joints are created, now the islands are known
+        if(parallel_islands) updateIslands();
+        else islands.clear();
+        updateStepThreading();
+        if(num_contact_joints > peak_contact_joints) {
+          peak_contact_joints = num_contact_joints;
+        }
+        if(num_feedbacks > peak_feedbacks) {
+          peak_feedbacks = num_feedbacks;
+        }
+
         /// then calculate the next state for a time of step_size seconds
         try {
           if(fast_step) dWorldQuickStep(world, step_size);
@@ -283,7 +420,199 @@ namespace mars {
           control->sim->handleError(WorldPhysics::error);
           WorldPhysics::error = PHYSICS_NO_ERROR;
 	}
+        if(dbContactId) {
+          dbContactPackage[0].set((long)num_contact_joints);
+          dbContactPackage[1].set((long)peak_contact_joints);
+          dbContactPackage[2].set((long)num_feedbacks);
+          dbContactPackage[3].set((long)peak_feedbacks);
+          dbContactPackage[4].set((long)(feedback_blocks.size()*FEEDBACK_BLOCK_SIZE));
+          dbContactPackage[5].set((long)contact_buffer.size());
+          locker.unlock();
+          control->dataBroker->pushData(dbContactId, dbContactPackage);
+        }
+      }
+    }
+
+    /**
+     * \brief Returns a contact feedback that is valid until the next step.
+     *
+     * The feedbacks are taken from blocks that are kept over all steps,
+     * thus resetting them at the beginning of a step does not free memory.
+     */
+    dJointFeedback* WorldPhysics::getContactFeedback(void) {
+      size_t block = num_feedbacks / FEEDBACK_BLOCK_SIZE;
+      if(block == feedback_blocks.size()) {
+        feedback_blocks.push_back(new dJointFeedback[FEEDBACK_BLOCK_SIZE]);
+      }
+      return feedback_blocks[block] + (num_feedbacks++ % FEEDBACK_BLOCK_SIZE);
+    }
+
+    /**
+     * \brief Groups the nodes into islands that are connected by joints
+     * or contacts.
+     *
+     * Every body in the space is a set of its own in a union-find
+     * structure. The sets of two bodies are merged if a joint (including
+     * the contact joints of the current step) connects them. Geoms without
+     * a body are static and belong to no island.
+     *
+     * pre:
+     *     - the contact joints of the current step are created
+     *
+     * post:
+     *     - islands contains the node ids of every island
+     */
+    void WorldPhysics::updateIslands(void) {
+      std::map<dBodyID, size_t> bodyIndex;
+      std::map<dBodyID, size_t>::iterator it, other_it;
+      std::vector<dBodyID> bodies;
+      std::vector<size_t> parent;
+      std::vector<std::vector<unsigned long> > bodyNodes;
+      std::vector<int> islandIndex;
+      dGeomID geom;
+      dBodyID body, other;
+      dJointID joint;
+      geom_data* data;
+      size_t a, b;
+      int i, j, k;
+
+      for(i=0; i<dSpaceGetNumGeoms(space); i++) {
+        geom = dSpaceGetGeom(space, i);
+        body = dGeomGetBody(geom);
+        if(!body) continue;
+        data = (geom_data*)dGeomGetData(geom);
+        it = bodyIndex.find(body);
+        if(it == bodyIndex.end()) {
+          it = bodyIndex.insert(std::make_pair(body, bodies.size())).first;
+          bodies.push_back(body);
+          parent.push_back(parent.size());
+          bodyNodes.push_back(std::vector<unsigned long>());
+        }
+        bodyNodes[it->second].push_back(data->id);
+      }
+
+      for(i=0; i<(int)bodies.size(); i++) {
+        for(j=0; j<dBodyGetNumJoints(bodies[i]); j++) {
+          joint = dBodyGetJoint(bodies[i], j);
+          for(k=0; k<2; k++) {
+            other = dJointGetBody(joint, k);
+            if(!other || other == bodies[i]) continue;
+            other_it = bodyIndex.find(other);
+            if(other_it == bodyIndex.end()) continue;
+            // merge the two sets
+            for(a=i; parent[a] != a; a=parent[a]) ;
+            for(b=other_it->second; parent[b] != b; b=parent[b]) ;
+            if(a < b) parent[b] = a;
+            else if(b < a) parent[a] = b;
+          }
+        }
+      }
+
+      // the islands are ordered by their first geom in the space to keep
+      // the distribution deterministic
+      islands.clear();
+      islandIndex.resize(parent.size(), -1);
+      for(i=0; i<(int)bodies.size(); i++) {
+        for(a=i; parent[a] != a; a=parent[a]) ;
+        if(islandIndex[a] < 0) {
+          islandIndex[a] = islands.size();
+          islands.push_back(std::vector<unsigned long>());
+        }
+        std::vector<unsigned long> &island = islands[islandIndex[a]];
+        island.insert(island.end(), bodyNodes[i].begin(), bodyNodes[i].end());
+      }
+    }
+
+    /**
+     * \brief Hands the islands of a step to a pool of ODE threads.
+     *
+     * Only available if ODE is build with threading support (>= 0.13).
+     * Otherwise the islands are still detected but the world is stepped
+     * in the calling thread.
+     */
+    void WorldPhysics::updateStepThreading(void) {
+#ifdef ODE_HAS_THREADING
+      int numThreads = parallel_islands ? num_island_threads : 0;
+      if(numThreads < 0) numThreads = 0;
+      if(numThreads == num_step_threads) return;
+
+      freeStepThreading();
+      if(numThreads > 0) {
+        threading = dThreadingAllocateMultiThreadedImplementation();
+        thread_pool = dThreadingAllocateThreadPool(numThreads, 0,
+                                                   dAllocateFlagBasicData,
+                                                   NULL);
+        dThreadingThreadPoolServeMultiThreadedImplementation(thread_pool,
+                                                             threading);
+        dWorldSetStepIslandsProcessingMaxThreadCount(world, numThreads);
+        dWorldSetStepThreadingImplementation(world,
+                                             dThreadingImplementationGetFunctions(threading),
+                                             threading);
+        num_step_threads = numThreads;
       }
+#endif
+    }
+
+    void WorldPhysics::freeStepThreading(void) {
+#ifdef ODE_HAS_THREADING
+      if(threading) {
+        dThreadingImplementationShutdownProcessing(threading);
+        dThreadingFreeThreadPool(thread_pool);
+        dWorldSetStepThreadingImplementation(world, NULL, NULL);
+        dThreadingFreeImplementation(threading);
+        threading = 0;
+        thread_pool = 0;
+      }
+#endif
+      num_step_threads = 0;
+    }
+
+    void WorldPhysics::getIslands(std::vector<std::vector<unsigned long> > *islands) const {
+      MutexLocker locker(&iMutex);
+      *islands = this->islands;
+    }
+
+    bool WorldPhysics::setJointMotorCommands(const std::vector<JointMotorCommand> &commands) {
+      MutexLocker locker(&iMutex);
+      std::vector<JointMotorCommand>::const_iterator it;
+      for(it=commands.begin(); it!=commands.end(); ++it) {
+        // all joints of this world are JointPhysics
+        static_cast<JointPhysics*>(it->joint)->setMotorCommand(it->axis,
+                                                               it->velocity,
+                                                               it->effortLimit);
+      }
+      return true;
+    }
+
+    bool WorldPhysics::getJointStates(const std::vector<JointInterface*> &joints,
+                                      const std::vector<bool> &feedback,
+                                      std::vector<JointState> *states) const {
+      MutexLocker locker(&iMutex);
+      states->resize(joints.size());
+      for(size_t i=0; i<joints.size(); ++i) {
+        static_cast<JointPhysics*>(joints[i])->getState(&(*states)[i],
+                                                        feedback[i]);
+      }
+      return true;
+    }
+
+    bool WorldPhysics::getNodeStates(const std::vector<NodeInterface*> &nodes,
+                                     std::vector<NodeBodyState> *states) const {
+      MutexLocker locker(&iMutex);
+      states->resize(nodes.size());
+      for(size_t i=0; i<nodes.size(); ++i) {
+        static_cast<NodePhysics*>(nodes[i])->getState(&(*states)[i]);
+      }
+      return true;
+    }
+
+    bool WorldPhysics::setNodeVelocities(const std::vector<NodeVelocityCommand> &commands) {
+      MutexLocker locker(&iMutex);
+      std::vector<NodeVelocityCommand>::const_iterator it;
+      for(it=commands.begin(); it!=commands.end(); ++it) {
+        static_cast<NodePhysics*>(it->node)->setVelocities(*it);
+      }
+      return true;
     }
 
     /**
@@ -502,7 +831,12 @@ namespace mars {
       else {
         maxNumContacts = geom_data2->c_params.max_num_contacts;
       }
-      dContact *contact = new dContact[maxNumContacts];
+      if(maxNumContacts <= 0) return;
+      // the contact joints copy the data, so the buffer is reused for all pairs
+      if(contact_buffer.size() < (size_t)maxNumContacts) {
+        contact_buffer.resize(maxNumContacts);
+      }
+      dContact *contact = &contact_buffer[0];
 
 
       //for granular test
@@ -702,6 +1036,7 @@ namespace mars {
             if(contact[0].geom.depth < 0.0) contact[0].geom.depth = 0.0;
             dJointID c=dJointCreateContact(world,contactgroup,contact+i);
             dJointAttach(c,b1,b2);
+            num_contact_joints++;
 
             geom_data1->num_ground_collisions += numc;
             geom_data2->num_ground_collisions += numc;
@@ -717,18 +1052,16 @@ namespace mars {
             //if(dGeomGetClass(o1) == dPlaneClass) {
             fb = 0;
             if(geom_data2->sense_contact_force) {
-              fb = (dJointFeedback*)malloc(sizeof(dJointFeedback));
+              fb = getContactFeedback();
               dJointSetFeedback(c, fb);
-              contact_feedback_list.push_back(fb);
               geom_data2->ground_feedbacks.push_back(fb);
               geom_data2->node1 = false;
             } 
             //else if(dGeomGetClass(o2) == dPlaneClass) {
             if(geom_data1->sense_contact_force) {
               if(!fb) {
-                fb = (dJointFeedback*)malloc(sizeof(dJointFeedback));
+                fb = getContactFeedback();
                 dJointSetFeedback(c, fb);
-                contact_feedback_list.push_back(fb);
               }
               geom_data1->ground_feedbacks.push_back(fb);
               geom_data1->node1 = true;
@@ -736,7 +1069,6 @@ namespace mars {
           }
         }
       }
-      delete[] contact;
     }
 
     /**
@@ -838,40 +1170,471 @@ namespace mars {
       ray_collision = 0;
       dSpaceCollide2(theGeom, (dGeomID)space, this,
                      &WorldPhysics::callbackForward);
+      if(static_space) {
+        dSpaceCollide2(theGeom, (dGeomID)static_space, this,
+                       &WorldPhysics::callbackForward);
+      }
       return ray_collision;
     }
 
-    double WorldPhysics::getCollisionDepth(dGeomID theGeom) {
-      dGeomID otherGeom;
-      dContact contact[1];
-      double depth = 0.0;
-      int numc;
-      dBodyID b1;
-      dBodyID b2;
+    /**
+     * Casts the rays of a part of the queued sensor rays per job index.
+     */
+    class RayCastJob : public ParallelJob {
+    public:
+      RayCastJob(const WorldPhysics *world, std::vector<RayBatch> *batches)
+        : world(world), batches(batches) {}
+
+      void runJob(std::size_t index) {
+        RayBatch &batch = (*batches)[index];
+        long long time = getTime();
+#ifdef ODE11
+        // the trimesh colliders need their own data in every thread
+        dAllocateODEDataForThread(dAllocateMaskAll);
+#endif
+        world->castRays(batch.queries, batch.count);
+        // every job index writes only to its own batch
+        batch.time = getTimeDiff(time);
+      }
 
-      for(int i=0; i<dSpaceGetNumGeoms(space); i++) {
-        otherGeom = dSpaceGetGeom(space, i);
+    private:
+      const WorldPhysics *world;
+      std::vector<RayBatch> *batches;
+    };
 
-        if(!(dGeomGetCollideBits(theGeom) & dGeomGetCollideBits(otherGeom)))
+    /**
+     * \brief Casts every ray once with its full length and stores the
+     * distance to the nearest hit.
+     *
+     * The rays are cast against the geoms collected by updateRayTargets().
+     * Only the ray geoms of the queries are modified, so different queries
+     * can be cast concurrently.
+     */
+    void WorldPhysics::castRays(RayQuery *queries, size_t count) const {
+      for(size_t i=0; i<count; ++i) {
+        RayQuery &query = queries[i];
+        query.distance = query.maxDistance;
+        dGeomRaySet(query.geom, query.start[0], query.start[1], query.start[2],
+                    query.direction[0], query.direction[1], query.direction[2]);
+        dGeomRaySetLength(query.geom, query.maxDistance);
+        dGeomRaySetClosestHit(query.geom, 1);
+        castRay(&query);
+        if(query.result) *query.result = query.distance;
+      }
+    }
+
+    /**
+     * \brief Returns whether the ray hits the box in front of the nearest
+     * hit found so far and the distance where it enters the box.
+     */
+    static bool rayHitsBox(const RayQuery *query, const dReal *aabb,
+                           dReal *enter) {
+      dReal tmin = 0.0, tmax = query->distance, t1, t2, tmp;
+      for(int i=0; i<3; ++i) {
+        if(fabs(query->direction[i]) < 1e-12) {
+          if(query->start[i] < aabb[i*2] || query->start[i] > aabb[i*2+1]) {
+            return false;
+          }
           continue;
+        }
+        t1 = (aabb[i*2] - query->start[i]) / query->direction[i];
+        t2 = (aabb[i*2+1] - query->start[i]) / query->direction[i];
+        if(t1 > t2) {
+          tmp = t1;
+          t1 = t2;
+          t2 = tmp;
+        }
+        if(t1 > tmin) tmin = t1;
+        if(t2 < tmax) tmax = t2;
+        if(tmin > tmax) return false;
+      }
+      *enter = tmin;
+      return true;
+    }
 
-        b1 = dGeomGetBody(theGeom);
-        b2 = dGeomGetBody(otherGeom);
+    /**
+     * \brief Casts the ray through the bounding volume tree of the targets.
+     * The nearer child is visited first and subtrees behind the nearest
+     * hit found so far are skipped.
+     */
+    void WorldPhysics::castRay(RayQuery *query) const {
+      std::vector<RayTarget>::const_iterator it;
+      std::pair<size_t, dReal> stack[RAY_TREE_STACK_SIZE];
+      size_t top = 0, index, left, right, i;
+      dReal enter, leftEnter, rightEnter;
+      bool hitLeft, hitRight;
+
+      for(it=ray_unbounded_targets.begin(); it!=ray_unbounded_targets.end();
+          ++it) {
+        castRayAtTarget(query, *it);
+      }
+      if(ray_tree.empty() || !rayHitsBox(query, ray_tree[0].aabb, &enter)) {
+        return;
+      }
+      stack[top++] = std::make_pair((size_t)0, enter);
+      while(top) {
+        --top;
+        if(stack[top].second > query->distance) continue;
+        index = stack[top].first;
+        const RayTargetNode &node = ray_tree[index];
+        if(node.count) {
+          for(i=node.first; i<node.first+node.count; ++i) {
+            castRayAtTarget(query, ray_targets[i]);
+          }
+          continue;
+        }
+        left = index+1;
+        right = node.right;
+        hitLeft = rayHitsBox(query, ray_tree[left].aabb, &leftEnter);
+        hitRight = rayHitsBox(query, ray_tree[right].aabb, &rightEnter);
+        // the depth of the tree is logarithmic in the number of targets
+        if(hitLeft && hitRight) {
+          if(leftEnter < rightEnter) {
+            stack[top++] = std::make_pair(right, rightEnter);
+            stack[top++] = std::make_pair(left, leftEnter);
+          }
+          else {
+            stack[top++] = std::make_pair(left, leftEnter);
+            stack[top++] = std::make_pair(right, rightEnter);
+          }
+        }
+        else if(hitLeft) stack[top++] = std::make_pair(left, leftEnter);
+        else if(hitRight) stack[top++] = std::make_pair(right, rightEnter);
+      }
+    }
+
+    /**
+     * \brief Runs the narrowphase of the ray against one target if the
+     * target is not filtered and its box is in front of the nearest hit.
+     */
+    void WorldPhysics::castRayAtTarget(RayQuery *query,
+                                       const RayTarget &target) const {
+      geom_data *ray_data = (geom_data*)dGeomGetData(query->geom);
+      unsigned long category = dGeomGetCategoryBits(query->geom);
+      unsigned long collide = dGeomGetCollideBits(query->geom);
+      dContactGeom contact;
+      dReal enter;
+
+      if(!((category & target.collide) || (target.category & collide))) return;
+      if(target.geom == ray_data->parent_geom) return;
+      if(ray_data->parent_body && ray_data->parent_body == target.body) return;
+      if(!rayHitsBox(query, target.aabb, &enter)) return;
+
+      int numContacts;
+      if(target.lock) {
+        // the heightfield and trimesh colliders are not reentrant per geom
+        MutexLocker targetLocker(target.lock);
+        numContacts = dCollide(query->geom, target.geom, 1, &contact,
+                               sizeof(dContactGeom));
+      }
+      else {
+        numContacts = dCollide(query->geom, target.geom, 1, &contact,
+                               sizeof(dContactGeom));
+      }
+      if(numContacts) {
+        if(contact.depth < query->distance) {
+          query->distance = contact.depth;
+          dGeomRaySetLength(query->geom, contact.depth);
+        }
+      }
+    }
+
+    /**
+     * Orders the targets by the center of their boxes along one axis.
+     */
+    struct RayTargetLess {
+      explicit RayTargetLess(int axis) : axis(axis) {}
+      bool operator()(const RayTarget &a, const RayTarget &b) const {
+        return (a.aabb[axis*2] + a.aabb[axis*2+1] <
+                b.aabb[axis*2] + b.aabb[axis*2+1]);
+      }
+      int axis;
+    };
+
+    /**
+     * \brief Collects the enabled geoms and their bounding boxes after a
+     * step and builds the bounding volume tree over them. The sensor rays
+     * are cast against this state.
+     */
+    void WorldPhysics::updateRayTargets(void) {
+      num_ray_target_locks = 0;
+      ray_targets.clear();
+      ray_unbounded_targets.clear();
+      ray_tree.clear();
+      addRayTargets(space);
+      if(static_space) addRayTargets(static_space);
+      if(!ray_targets.empty()) buildRayTree(0, ray_targets.size());
+    }
 
-        if(b1 && b2 && dAreConnectedExcluding(b1,b2,dJointTypeContact))
+    /**
+     * \brief Adds a node for the targets in [first, first+count) and
+     * splits them at the median of the longest axis of their box.
+     * \return The index of the node.
+     */
+    size_t WorldPhysics::buildRayTree(size_t first, size_t count) {
+      RayTargetNode node;
+      size_t index = ray_tree.size();
+      size_t i, half, right;
+      int k, axis = 0;
+
+      for(k=0; k<3; ++k) {
+        node.aabb[k*2] = dInfinity;
+        node.aabb[k*2+1] = -dInfinity;
+      }
+      for(i=first; i<first+count; ++i) {
+        for(k=0; k<3; ++k) {
+          if(ray_targets[i].aabb[k*2] < node.aabb[k*2]) {
+            node.aabb[k*2] = ray_targets[i].aabb[k*2];
+          }
+          if(ray_targets[i].aabb[k*2+1] > node.aabb[k*2+1]) {
+            node.aabb[k*2+1] = ray_targets[i].aabb[k*2+1];
+          }
+        }
+      }
+      node.first = first;
+      node.right = 0;
+      if(count <= RAY_TREE_LEAF_SIZE) {
+        node.count = count;
+        ray_tree.push_back(node);
+        return index;
+      }
+      node.count = 0;
+      ray_tree.push_back(node);
+
+      for(k=1; k<3; ++k) {
+        if(node.aabb[k*2+1] - node.aabb[k*2] >
+           node.aabb[axis*2+1] - node.aabb[axis*2]) {
+          axis = k;
+        }
+      }
+      half = count/2;
+      std::nth_element(ray_targets.begin()+first,
+                       ray_targets.begin()+first+half,
+                       ray_targets.begin()+first+count,
+                       RayTargetLess(axis));
+      buildRayTree(first, half);
+      // the recursion grows ray_tree, so take the index before the store
+      right = buildRayTree(first+half, count-half);
+      ray_tree[index].right = right;
+      return index;
+    }
+
+    void WorldPhysics::addRayTargets(dSpaceID theSpace) {
+      RayTarget target;
+      geom_data *data;
+      dGeomID theGeom;
+
+      for(int i=0; i<dSpaceGetNumGeoms(theSpace); ++i) {
+        theGeom = dSpaceGetGeom(theSpace, i);
+        if(dGeomIsSpace(theGeom)) {
+          addRayTargets((dSpaceID)theGeom);
           continue;
+        }
+        if(!dGeomIsEnabled(theGeom)) continue;
+        data = (geom_data*)dGeomGetData(theGeom);
+        if(data && data->ray_sensor) continue;
+        target.geom = theGeom;
+        target.body = dGeomGetBody(theGeom);
+        target.category = dGeomGetCategoryBits(theGeom);
+        target.collide = dGeomGetCollideBits(theGeom);
+        target.lock = 0;
+        // ODE keeps temporary collision data in heightfield and trimesh
+        // geoms, so concurrent rays have to be cast one after another
+        // against the same geom
+        int geomClass = dGeomGetClass(theGeom);
+        if(num_ray_threads > 1 &&
+           (geomClass == dHeightfieldClass || geomClass == dTriMeshClass)) {
+          if(num_ray_target_locks == ray_target_locks.size()) {
+            ray_target_locks.push_back(new Mutex());
+          }
+          target.lock = ray_target_locks[num_ray_target_locks++];
+        }
+        dGeomGetAABB(theGeom, target.aabb);
+        // infinite boxes would break the median split of the tree
+        bool bounded = true;
+        for(int k=0; k<6; ++k) {
+          if(target.aabb[k] >= dInfinity || target.aabb[k] <= -dInfinity) {
+            bounded = false;
+          }
+        }
+        if(bounded) ray_targets.push_back(target);
+        else ray_unbounded_targets.push_back(target);
+      }
+    }
 
-        numc = dCollide(theGeom, otherGeom, 1,
-                        &(contact[0].geom), sizeof(dContact));
-        // numc = dCollide(theGeom, otherGeom, 1 | CONTACTS_UNIMPORTANT,
-        //                 &(contact[0].geom), sizeof(dContact));
-        if(numc) {
-          if(contact[0].geom.depth > depth)
-            depth = contact[0].geom.depth;
+    /**
+     * \brief Queues the rays of a sensor for the next castSensorRays().
+     *
+     * The queries have to stay valid until they are cast or removed by
+     * dequeueSensorRays(). Has to be called with a locked iMutex.
+     */
+    void WorldPhysics::queueSensorRays(NodePhysics *node, BaseSensor *sensor,
+                                       RayQuery *queries, size_t count) {
+      RayBatch batch;
+      batch.node = node;
+      batch.sensor = sensor;
+      batch.time = 0.0;
+      // split large sensors to balance the load of the threads
+      for(size_t i=0; i<count; i+=RAY_BATCH_SIZE) {
+        batch.queries = queries + i;
+        batch.count = count-i < RAY_BATCH_SIZE ? count-i : RAY_BATCH_SIZE;
+        ray_batches.push_back(batch);
+      }
+    }
+
+    /**
+     * \brief Removes the queued rays of \a node. Has to be called with a
+     * locked iMutex.
+     */
+    void WorldPhysics::dequeueSensorRays(NodePhysics *node) {
+      std::vector<RayBatch>::iterator it;
+      for(it=ray_batches.begin(); it!=ray_batches.end(); ) {
+        if(it->node == node) it = ray_batches.erase(it);
+        else ++it;
+      }
+    }
+
+    /**
+     * \brief Casts all queued sensor rays and writes the distances into
+     * the sensors.
+     *
+     * The rays are distributed to \c num_ray_threads threads. The world is
+     * not changed while the rays are cast. The time used for the rays of
+     * every sensor is published as "mars_sim/sensorRayTime".
+     */
+    void WorldPhysics::castSensorRays(void) {
+      MutexLocker locker(&iMutex);
+      if(!world_init || ray_batches.empty()) return;
+
+      size_t numWorkers = num_ray_threads > 1 ? num_ray_threads-1 : 0;
+      if(ray_pool.getNumThreads() != numWorkers) {
+        ray_pool.setNumThreads(numWorkers);
+      }
+      updateRayTargets();
+      RayCastJob job(this, &ray_batches);
+      ray_pool.run(&job, ray_batches.size());
+      if(!control->dataBroker) {
+        ray_batches.clear();
+        return;
+      }
+      updateRayTimes();
+      ray_batches.clear();
+      // a receiver might call back into the physics
+      locker.unlock();
+      if(!dbRayId) {
+        dbRayId = control->dataBroker->pushData("mars_sim", "sensorRayTime",
+                                                dbRayPackage, NULL,
+                                                data_broker::DATA_PACKAGE_READ_FLAG);
+      }
+      else {
+        control->dataBroker->pushData(dbRayId, dbRayPackage);
+      }
+    }
+
+    /**
+     * \brief Sums up the times of the ray batches per sensor in
+     * dbRayPackage. Has to be called with a locked iMutex.
+     */
+    void WorldPhysics::updateRayTimes(void) {
+      std::vector<RayBatch>::iterator it;
+      std::vector<std::string> names;
+      std::vector<double> times;
+      size_t i;
+
+      for(it=ray_batches.begin(); it!=ray_batches.end(); ++it) {
+        if(names.empty() || it->sensor->name != names.back()) {
+          names.push_back(it->sensor->name);
+          times.push_back(0.0);
         }
+        times.back() += it->time;
       }
 
-      return depth;
+      // the package is rebuilt if the queued sensors changed
+      bool changed = (dbRayPackage.size() != names.size());
+      for(i=0; i<names.size() && !changed; ++i) {
+        changed = (dbRayPackage[i].getName() != names[i]);
+      }
+      if(changed) {
+        dbRayPackage.clear();
+        for(i=0; i<names.size(); ++i) {
+          dbRayPackage.add(names[i], 0.0);
+        }
+      }
+      for(i=0; i<names.size(); ++i) {
+        dbRayPackage[i].d = times[i];
+      }
+    }
+
+    /**
+     * The data of the collision queries that are answered by the
+     * broadphase of the spaces.
+     */
+    struct CollisionQuery {
+      dGeomID geom;
+      double depth;
+    };
+
+    static void depthCallback(void *data, dGeomID o1, dGeomID o2) {
+      CollisionQuery *query = (CollisionQuery*)data;
+      dGeomID otherGeom = (o1 == query->geom) ? o2 : o1;
+      dContactGeom contact;
+      dBodyID b1, b2;
+
+      if(dGeomIsSpace(otherGeom)) {
+        dSpaceCollide2(query->geom, otherGeom, data, &depthCallback);
+        return;
+      }
+      if(otherGeom == query->geom) return;
+      if(!(dGeomGetCollideBits(query->geom) & dGeomGetCollideBits(otherGeom)))
+        return;
+
+      b1 = dGeomGetBody(query->geom);
+      b2 = dGeomGetBody(otherGeom);
+      if(b1 && b2 && dAreConnectedExcluding(b1,b2,dJointTypeContact))
+        return;
+
+      if(dCollide(query->geom, otherGeom, 1, &contact, sizeof(dContactGeom))) {
+        if(contact.depth > query->depth)
+          query->depth = contact.depth;
+      }
+    }
+
+    static void vectorRayCallback(void *data, dGeomID o1, dGeomID o2) {
+      CollisionQuery *query = (CollisionQuery*)data;
+      dGeomID otherGeom = (o1 == query->geom) ? o2 : o1;
+      dContactGeom contact;
+
+      if(dGeomIsSpace(otherGeom)) {
+        dSpaceCollide2(query->geom, otherGeom, data, &vectorRayCallback);
+        return;
+      }
+      if(!(dGeomGetCollideBits(query->geom) & dGeomGetCollideBits(otherGeom)))
+        return;
+
+      if(dCollide(query->geom, otherGeom, 1 | CONTACTS_UNIMPORTANT,
+                  &contact, sizeof(dContactGeom))) {
+        if(contact.depth < query->depth) {
+          query->depth = contact.depth;
+          // geoms behind the hit are culled by the broadphase
+          dGeomRaySetLength(query->geom, contact.depth);
+        }
+      }
+    }
+
+    /**
+     * \brief Returns the deepest penetration of \a theGeom. Only the geoms
+     * whose bounding boxes overlap with \a theGeom are tested.
+     */
+    double WorldPhysics::getCollisionDepth(dGeomID theGeom) {
+      CollisionQuery query;
+      query.geom = theGeom;
+      query.depth = 0.0;
+
+      dSpaceCollide2(theGeom, (dGeomID)space, &query, &depthCallback);
+      if(static_space) {
+        dSpaceCollide2(theGeom, (dGeomID)static_space, &query, &depthCallback);
+      }
+      return query.depth;
     }
 
     int WorldPhysics::checkCollisions(void) {
@@ -879,36 +1642,58 @@ namespace mars {
       num_contacts = log_contacts = 0;
       create_contacts = 0;
       dSpaceCollide(space,this, &WorldPhysics::callbackForward);	
+      if(static_space) {
+        dSpaceCollide2((dGeomID)space, (dGeomID)static_space, this,
+                       &WorldPhysics::callbackForward);
+      }
       return num_contacts;
     }
 
     double WorldPhysics::getVectorCollision(const Vector &pos, 
                                             const Vector &ray) const {
       MutexLocker locker(&iMutex);
-      dGeomID otherGeom;
-      dContact contact[1];
       //double depth = ray.length();
-      double depth = ray.norm();
-      int numc;
-  
-      dGeomID theGeom = dCreateRay(space, depth);
-      dGeomRaySet(theGeom, pos.x(), pos.y(), pos.z(), ray.x(), ray.y(), ray.z()); 
-
-      for(int i=0; i<dSpaceGetNumGeoms(space); i++) {
-        otherGeom = dSpaceGetGeom(space, i);
+      dGeomID theGeom = dCreateRay(NULL, ray.norm());
+      double depth = castVectorRay(theGeom, pos, ray);
+      dGeomDestroy(theGeom);
+      return depth;
+    }
 
-        if(!(dGeomGetCollideBits(theGeom) & dGeomGetCollideBits(otherGeom)))
-          continue;
-        numc = dCollide(theGeom, otherGeom, 1 | CONTACTS_UNIMPORTANT,
-                        &(contact[0].geom), sizeof(dContact));
-        if(numc) {
-          if(contact[0].geom.depth < depth)
-            depth = contact[0].geom.depth;
-        }
+    void WorldPhysics::getVectorCollisions(const std::vector<Vector> &pos,
+                                           const std::vector<Vector> &rays,
+                                           std::vector<sReal> *depths) const {
+      MutexLocker locker(&iMutex);
+      size_t count = pos.size() < rays.size() ? pos.size() : rays.size();
+      depths->resize(count);
+      if(count == 0) return;
+
+      // one ray geom is reused for all queries
+      dGeomID theGeom = dCreateRay(NULL, 1.0);
+      for(size_t i=0; i<count; ++i) {
+        (*depths)[i] = castVectorRay(theGeom, pos[i], rays[i]);
       }
-
       dGeomDestroy(theGeom);
-      return depth;
+    }
+
+    /**
+     * \brief Returns the distance to the nearest collision of the ray
+     * from \a pos along \a ray, or the length of \a ray. The candidates
+     * are selected by the broadphase of the spaces.
+     */
+    sReal WorldPhysics::castVectorRay(dGeomID theRay, const Vector &pos,
+                                      const Vector &ray) const {
+      CollisionQuery query;
+      query.geom = theRay;
+      query.depth = ray.norm();
+
+      dGeomRaySet(theRay, pos.x(), pos.y(), pos.z(), ray.x(), ray.y(), ray.z());
+      dGeomRaySetLength(theRay, query.depth);
+      dSpaceCollide2(theRay, (dGeomID)space, &query, &vectorRayCallback);
+      if(static_space) {
+        dSpaceCollide2(theRay, (dGeomID)static_space, &query,
+                       &vectorRayCallback);
+      }
+      return query.depth;
     }
 
   } // end of namespace sim
@@ -41,12 +41,19 @@
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/PhysicsInterface.h>
 #include <mars/interfaces/graphics/draw_structs.h>
+#include <mars/data_broker/DataPackage.h>
+#include <mars/utils/ThreadPool.h>
 
 #include <vector>
 
 #include <ode/ode.h>
 
 namespace mars {
+
+  namespace interfaces {
+    class BaseSensor;
+  }
+
   namespace sim {
 
     class NodePhysics;
@@ -78,6 +85,51 @@ namespace mars {
       std::vector<NodePhysics*> comp_nodes;
     };
 
+    /**
+     * A single ray that is cast by WorldPhysics::castRays.
+     */
+    struct RayQuery {
+      dGeomID geom; ///< ray geom of the sensor, its geom_data defines the ignored parent
+      dVector3 start;
+      dVector3 direction;
+      dReal maxDistance;
+      dReal distance; ///< distance to the nearest hit or maxDistance
+      double *result; ///< receives the distance if not NULL
+    };
+
+    /**
+     * A part of the rays of one sensor that is cast by
+     * WorldPhysics::castSensorRays.
+     */
+    struct RayBatch {
+      NodePhysics *node;
+      interfaces::BaseSensor *sensor;
+      RayQuery *queries;
+      size_t count;
+      double time; ///< time in ms used to cast the rays
+    };
+
+    /**
+     * A geom of the frozen collision state the sensor rays are cast against.
+     */
+    struct RayTarget {
+      dGeomID geom;
+      dBodyID body;
+      unsigned long category, collide;
+      dReal aabb[6];
+      utils::Mutex *lock; ///< set if the collider keeps scratch data in the geom
+    };
+
+    /**
+     * A node of the bounding volume tree over the ray targets. The first
+     * child of an inner node directly follows the node.
+     */
+    struct RayTargetNode {
+      dReal aabb[6];
+      size_t first, count; ///< range of a leaf in ray_targets, count is 0 for inner nodes
+      size_t right; ///< index of the second child of an inner node
+    };
+
     /**
      * Declaration of the physical class, that implements the
      * physics interface.
@@ -94,16 +146,33 @@ namespace mars {
       virtual void update(std::vector<interfaces::draw_item> *drawItems);
       virtual int checkCollisions(void);
       virtual interfaces::sReal getVectorCollision(const utils::Vector &pos, const utils::Vector &ray) const;
+      virtual void getVectorCollisions(const std::vector<utils::Vector> &pos,
+                                       const std::vector<utils::Vector> &rays,
+                                       std::vector<interfaces::sReal> *depths) const;
+      virtual void getIslands(std::vector<std::vector<unsigned long> > *islands) const;
+      virtual bool setJointMotorCommands(const std::vector<interfaces::JointMotorCommand> &commands);
+      virtual bool getJointStates(const std::vector<interfaces::JointInterface*> &joints,
+                                  const std::vector<bool> &feedback,
+                                  std::vector<interfaces::JointState> *states) const;
+      virtual bool getNodeStates(const std::vector<interfaces::NodeInterface*> &nodes,
+                                 std::vector<interfaces::NodeBodyState> *states) const;
+      virtual bool setNodeVelocities(const std::vector<interfaces::NodeVelocityCommand> &commands);
 
       // this functions are used by the other physical classes
       dWorldID getWorld(void) const;
       dSpaceID getSpace(void) const;
+      void addStaticGeom(dGeomID theGeom);
       bool getCompositeBody(int comp_group, dBodyID *body, NodePhysics *node);
       void destroyBody(dBodyID theBody, NodePhysics *node);
       dReal getWorldStep(void);
       void resetCompositeMass(dBodyID theBody);
       void moveCompositeMassCenter(dBodyID theBody, dReal x, dReal y, dReal z);
       int handleCollision(dGeomID theGeom);
+      void castRays(RayQuery *queries, size_t count) const;
+      void queueSensorRays(NodePhysics *node, interfaces::BaseSensor *sensor,
+                           RayQuery *queries, size_t count);
+      void dequeueSensorRays(NodePhysics *node);
+      virtual void castSensorRays(void);
       interfaces::sReal getCollisionDepth(dGeomID theGeom);
       mutable utils::Mutex iMutex;
 
@@ -112,6 +181,7 @@ namespace mars {
     private:
       utils::Mutex drawLock;
       dSpaceID space;
+      dSpaceID static_space;
       dWorldID world;
       dGeomID plane;
       dJointGroupID contactgroup;
@@ -123,10 +193,44 @@ namespace mars {
       std::vector<body_nbr_tupel> comp_body_list;
       std::vector<interfaces::draw_item> draw_intern;
       std::vector<interfaces::draw_item> draw_extern;
-      std::vector<dJointFeedback*> contact_feedback_list;
+      std::vector<dJointFeedback*> feedback_blocks;
+      std::vector<dContact> contact_buffer;
+      size_t num_feedbacks, peak_feedbacks;
+      size_t num_contact_joints, peak_contact_joints;
+      data_broker::DataPackage dbContactPackage;
+      unsigned long dbContactId;
       bool create_contacts, log_contacts;
       int num_contacts;
       int ray_collision;
+      std::vector<std::vector<unsigned long> > islands;
+      std::vector<RayBatch> ray_batches;
+      std::vector<RayTarget> ray_targets;
+      std::vector<RayTarget> ray_unbounded_targets; ///< e.g. planes
+      std::vector<RayTargetNode> ray_tree;
+      std::vector<utils::Mutex*> ray_target_locks;
+      size_t num_ray_target_locks;
+      utils::ThreadPool ray_pool;
+      data_broker::DataPackage dbRayPackage;
+      unsigned long dbRayId;
+#ifdef ODE_HAS_THREADING
+      dThreadingImplementationID threading;
+      dThreadingThreadPoolID thread_pool;
+#endif
+      int num_step_threads;
+
+      dSpaceID createSpace(interfaces::SpaceType type);
+      dJointFeedback* getContactFeedback(void);
+      void updateIslands(void);
+      void updateRayTargets(void);
+      void addRayTargets(dSpaceID theSpace);
+      size_t buildRayTree(size_t first, size_t count);
+      void castRay(RayQuery *query) const;
+      void castRayAtTarget(RayQuery *query, const RayTarget &target) const;
+      interfaces::sReal castVectorRay(dGeomID theRay, const utils::Vector &pos,
+                                      const utils::Vector &ray) const;
+      void updateRayTimes(void);
+      void updateStepThreading(void);
+      void freeStepThreading(void);
       // this functions are for the collision implementation
       void nearCallback (dGeomID o1, dGeomID o2);
       static void callbackForward(void *data, dGeomID o1, dGeomID o2);
@@ -255,15 +255,21 @@ namespace mars {
       double weightSum = 0;
       double weight = 0;
       double distance = 0;
-      Vector pos, ray;
+      Vector ray = orientation*this->ray;
       int i = 0;
+      rayStarts.resize(sensorpoints.size());
+      rayDirections.assign(sensorpoints.size(), ray);
+      for (i = 0; i < (int)sensorpoints.size(); ++i) {
+        rayStarts[i] = position + orientation*(sensorpoints[i]);
+      }
+      // all cells of the field are cast with one call
+      control->sim->getPhysics()->getVectorCollisions(rayStarts, rayDirections,
+                                                      &distances);
       //fprintf(stderr, "weights:\n");
       for (int c = 0; c < config.cols; ++c) {
         for (int r = 0; r < config.rows; ++r) {
           i = c*config.rows+r;
-          pos = position + orientation*(sensorpoints.at(i));
-          ray = orientation*this->ray;
-          distance = control->sim->getPhysics()->getVectorCollision(pos, ray);
+          distance = distances.at(i);
           weight = 1 - distance/maxDistance; // = (maxDistance-distance)/maxDistance
           weights.at(c*config.rows+r) = weight;
 //          fprintf(stderr, "%6g ", weight);
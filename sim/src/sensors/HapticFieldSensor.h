@@ -118,6 +118,8 @@ namespace mars {
       utils::Vector ray;
       std::vector<double> forces;
       std::vector<double> weights;
+      std::vector<utils::Vector> rayStarts, rayDirections;
+      std::vector<interfaces::sReal> distances;
       double fieldwidth, fieldheight;
       HapticFieldConfig config;
       data_broker::DataPackage dbPackage;
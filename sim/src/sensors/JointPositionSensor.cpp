@@ -58,6 +58,11 @@ namespace mars {
       if(angleIndex == -1)
         angleIndex = package.getIndexByName("axis1/angle");
       package.get(angleIndex, &doubleArray[callbackParam]);
+      // the joints are received in order, publish once all are updated
+      if(callbackParam == countIDs-1) {
+        getSensorDataBuffer() = doubleArray;
+        publishSensorData();
+      }
     }
 
   } // end of namespace sim
@@ -73,6 +73,11 @@ namespace mars {
         motorTorqueIndex = package.getIndexByName("motorTorque");
       }
       package.get(motorTorqueIndex, &doubleArray[callbackParam]);
+      // the joints are received in order, publish once all are updated
+      if(callbackParam == countIDs-1) {
+        getSensorDataBuffer() = doubleArray;
+        publishSensorData();
+      }
     }
 
   } // end of namespace sim
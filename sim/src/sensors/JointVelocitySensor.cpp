@@ -74,6 +74,11 @@ namespace mars {
         speedIndex = package.getIndexByName("axis1/speed");
       }
       package.get(speedIndex, &doubleArray[callbackParam]);
+      // the joints are received in order, publish once all are updated
+      if(callbackParam == countIDs-1) {
+        getSensorDataBuffer() = doubleArray;
+        publishSensorData();
+      }
     }
 
   } // end of namespace sim
@@ -93,6 +93,17 @@ namespace mars {
       package.get(angularVelocityIndices[0], &values[callbackParam].x());
       package.get(angularVelocityIndices[1], &values[callbackParam].y());
       package.get(angularVelocityIndices[2], &values[callbackParam].z());
+      // the nodes are received in order, publish once all are updated
+      if(callbackParam == countIDs-1) {
+        std::vector<double> &buffer = getSensorDataBuffer();
+        buffer.resize(3*values.size());
+        for(size_t i=0; i<values.size(); ++i) {
+          buffer[i*3] = values[i].x();
+          buffer[i*3+1] = values[i].y();
+          buffer[i*3+2] = values[i].z();
+        }
+        publishSensorData();
+      }
     }
 
   } // end of namespace sim
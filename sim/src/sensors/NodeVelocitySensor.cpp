@@ -92,6 +92,17 @@ namespace mars {
       package.get(velocityIndices[0], &values[callbackParam].x());
       package.get(velocityIndices[1], &values[callbackParam].y());
       package.get(velocityIndices[2], &values[callbackParam].z());
+      // the nodes are received in order, publish once all are updated
+      if(callbackParam == countIDs-1) {
+        std::vector<double> &buffer = getSensorDataBuffer();
+        buffer.resize(3*values.size());
+        for(size_t i=0; i<values.size(); ++i) {
+          buffer[i*3] = values[i].x();
+          buffer[i*3+1] = values[i].y();
+          buffer[i*3+2] = values[i].z();
+        }
+        publishSensorData();
+      }
     }
 
   } // end of namespace sim
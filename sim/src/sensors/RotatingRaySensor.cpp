@@ -197,6 +197,10 @@ namespace mars {
       return pointcloud_full.size()*3;
     }
 
+    SensorDataView RotatingRaySensor::getSensorView() const {
+      return getPublishedView();
+    }
+
     void RotatingRaySensor::receiveData(const data_broker::DataInfo &info,
                                 const data_broker::DataPackage &package,
                                 int callbackParam) {
@@ -330,6 +334,8 @@ namespace mars {
           pointcloud_full.clear();
           pointcloud_full.reserve(fromCloud->size());
           base::Vector3d vec_local;
+          std::vector<double> &values = getSensorDataBuffer();
+          values.resize(fromCloud->size()*3);
 
           for(int i=0; it != fromCloud->end(); it++, i++) {
             // Transforms the pointcloud back from world to current node (see receiveDate()).
@@ -337,8 +343,12 @@ namespace mars {
             // the orientation of the sensor in the unturned sensor frame.
             vec_local = rot * current_pose2.inverse() * (*it);
             pointcloud_full.push_back(vec_local);
+            values[i*3] = vec_local[0];
+            values[i*3+1] = vec_local[1];
+            values[i*3+2] = vec_local[2];
           }
           mutex_pointcloud.unlock();
+          publishSensorData();
           fromCloud->clear();
           convertPointCloud = false;
           full_scan = true;
@@ -114,6 +114,12 @@ namespace mars {
        * Inherited from BaseSensor, implemented from BasePolarIntersectionSensor.
        */
       int getSensorData(double**) const; 
+
+      /**
+       * Returns a view on the last full scan with (x,y,z) per point. The
+       * values are published once per scan and not copied.
+       */
+      virtual interfaces::SensorDataView getSensorView() const;
       
       /**
        * Receives the measured distances, calculates the vectors in the local
@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ray_transform_bench.cpp
+ * \brief Compares rotateRays() with the rotation of every ray by the turn
+ *        and the node rotation for 10k and 100k rays.
+ *
+ * The test fails if both results differ. The number of repetitions can be
+ * given as first argument.
+ */
+
+#include "RayTransform.h"
+
+#include <mars/utils/misc.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace mars::sim;
+
+static void setRotation(dMatrix3 R, dReal angle, int axis) {
+  dReal c = cos(angle), s = sin(angle);
+  int a = (axis+1)%3, b = (axis+2)%3;
+  for(int i=0; i<12; ++i) R[i] = 0;
+  R[axis*4+axis] = 1;
+  R[a*4+a] = c;
+  R[a*4+b] = -s;
+  R[b*4+a] = s;
+  R[b*4+b] = c;
+}
+
+static bool runBench(size_t numRays, long repetitions) {
+  std::vector<dReal> x(numRays), y(numRays), z(numRays);
+  std::vector<dReal> outX(numRays), outY(numRays), outZ(numRays);
+  std::vector<dReal> refX(numRays), refY(numRays), refZ(numRays);
+  dMatrix3 nodeR, turnR, R;
+  dVector3 ray, turned, rotated;
+  long long startTime, scalarTime, vectorTime;
+  double maxError = 0.0;
+
+  setRotation(nodeR, 0.3, 0);
+  setRotation(turnR, 1.1, 2);
+  for(size_t i=0; i<numRays; ++i) {
+    x[i] = cos(i*0.001);
+    y[i] = sin(i*0.001);
+    z[i] = 0.01*(i%100);
+  }
+
+  // every ray is turned and rotated by the node
+  startTime = mars::utils::getTimeMicro();
+  for(long r=0; r<repetitions; ++r) {
+    for(size_t i=0; i<numRays; ++i) {
+      ray[0] = x[i];
+      ray[1] = y[i];
+      ray[2] = z[i];
+      dMULTIPLY0_331(turned, turnR, ray);
+      dMULTIPLY0_331(rotated, nodeR, turned);
+      refX[i] = rotated[0];
+      refY[i] = rotated[1];
+      refZ[i] = rotated[2];
+    }
+  }
+  scalarTime = mars::utils::getTimeMicro() - startTime;
+
+  // both rotations are combined once for the packed arrays
+  startTime = mars::utils::getTimeMicro();
+  for(long r=0; r<repetitions; ++r) {
+    dMULTIPLY0_333(R, nodeR, turnR);
+    rotateRays(R, &x[0], &y[0], &z[0], &outX[0], &outY[0], &outZ[0],
+               numRays);
+  }
+  vectorTime = mars::utils::getTimeMicro() - startTime;
+
+  for(size_t i=0; i<numRays; ++i) {
+    maxError = fmax(maxError, fabs(outX[i] - refX[i]));
+    maxError = fmax(maxError, fabs(outY[i] - refY[i]));
+    maxError = fmax(maxError, fabs(outZ[i] - refZ[i]));
+  }
+  printf("%6lu rays: per ray %8.2f us, rotateRays %8.2f us, error %g\n",
+         (unsigned long)numRays, (double)scalarTime/repetitions,
+         (double)vectorTime/repetitions, maxError);
+  return maxError < 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+  long repetitions = 100;
+  bool ok = true;
+
+  if(argc > 1) {
+    repetitions = atol(argv[1]);
+  }
+  // the odd count also checks the vectors after the last full register
+  ok &= runBench(1001, repetitions);
+  ok &= runBench(10000, repetitions);
+  ok &= runBench(100000, repetitions);
+  return ok ? 0 : 1;
+}